@@ -211,7 +211,7 @@ void CActiveDynode::ManageStateInitial(CConnman& connman)
     // Check socket connectivity
     LogPrintf("CActiveDynode::ManageStateInitial -- Checking inbound connection to '%s'\n", service.ToString());
     SOCKET hSocket;
-    bool fConnected = ConnectSocket(service, hSocket, nConnectTimeout) && IsSelectableSocket(hSocket);
+    bool fConnected = ConnectSocket(service, hSocket, nConnectTimeout) && connman.IsSocketUsable(hSocket);
     CloseSocket(hSocket);
 
     if (!fConnected) {
@@ -226,17 +226,9 @@ bool CDomainEntry::ValidateValues(std::string& errorMessage)
 /** Checks if BDAP transaction exists in the memory pool */
 bool CDomainEntry::CheckIfExistsInMemPool(const CTxMemPool& pool, std::string& errorMessage)
 {
-    for (const CTxMemPoolEntry& e : pool.mapTx) {
-        const CTransactionRef& tx = e.GetSharedTx();
-        for (const CTxOut& txOut : tx->vout) {
-            if (IsBDAPDataOutput(txOut)) {
-                CDomainEntry domainEntry(tx);
-                if (this->GetFullObjectPath() == domainEntry.GetFullObjectPath()) {
-                    errorMessage = "CheckIfExistsInMemPool: A BDAP domain entry transaction for " + GetFullObjectPath() + " is already in the memory pool!";
-                    return true;
-                }
-            }
-        }
+    if (pool.existsBDAPObjectPath(GetFullObjectPath())) {
+        errorMessage = "CheckIfExistsInMemPool: A BDAP domain entry transaction for " + GetFullObjectPath() + " is already in the memory pool!";
+        return true;
     }
     return false;
 }
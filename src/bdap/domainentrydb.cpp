@@ -59,12 +59,9 @@ bool CDomainEntryDB::AddDomainEntry(const CDomainEntry& entry, const int op)
 
 void CDomainEntryDB::AddDomainEntryIndex(const CDomainEntry& entry, const int op) 
 {
-    UniValue oName(UniValue::VOBJ);
-    if (BuildBDAPJson(entry, oName)) {
-        CharString vchOperationType = vchFromString(BDAPFromOp(op));
-        GetMainSignals().NotifyBDAPUpdate(oName.write().c_str(), reinterpret_cast<char*>(vchOperationType.data()));
-        WriteDomainEntryIndexHistory(entry, op);
-    }
+    // Listeners serialize the entry themselves, JSON is only built for the history topic
+    GetMainSignals().NotifyBDAPEntry(entry, BDAPFromOp(op));
+    WriteDomainEntryIndexHistory(entry, op);
 }
 
 bool CDomainEntryDB::ReadDomainEntry(const std::vector<unsigned char>& vchObjectPath, CDomainEntry& entry) 
@@ -267,6 +264,74 @@ bool CDomainEntryDB::ListDirectories(const std::vector<unsigned char>& vchObject
     return true;
 }
 
+// Lists one page of active entries by domain name. Only the "dc" key range is visited.
+bool CDomainEntryDB::ListDirectories(const std::vector<unsigned char>& vchObjectLocation, const unsigned int& nResultsPerPage, const unsigned int& nPage, std::vector<CDomainEntry>& vEntries, const BDAP::ObjectType& accountType)
+{
+    if (nResultsPerPage == 0 || nPage == 0)
+        return true;
+
+    const uint64_t nSkip = (uint64_t)(nPage - 1) * nResultsPerPage;
+    uint64_t nMatched = 0;
+    std::pair<std::string, CharString> key;
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(make_pair(std::string("dc"), CharString()));
+    while (pcursor->Valid() && vEntries.size() < nResultsPerPage) {
+        boost::this_thread::interruption_point();
+        try {
+            if (!pcursor->GetKey(key) || key.first != "dc")
+                break;
+
+            CDomainEntry entry;
+            pcursor->GetValue(entry);
+            //filter by accountType, unless DEFAULT
+            if ((entry.nObjectType == GetObjectTypeInt(accountType)) || (accountType == DEFAULT_ACCOUNT_TYPE)) {
+                if (vchObjectLocation.empty() || entry.vchObjectLocation() == vchObjectLocation) {
+                    if (nMatched >= nSkip)
+                        vEntries.push_back(entry);
+                    nMatched++;
+                }
+            }
+            pcursor->Next();
+        }
+        catch (std::exception& e) {
+            return error("%s() : deserialize error", __PRETTY_FUNCTION__);
+        }
+    }
+    return true;
+}
+
+// Lists up to nMaxEntries entries whose full object path sorts after vchAfterObjectPath (all of them
+// when it is empty). Seeking to the last path seen keeps walking a large directory page by page linear.
+bool CDomainEntryDB::ListDirectoriesAfter(const std::vector<unsigned char>& vchObjectLocation, const std::vector<unsigned char>& vchAfterObjectPath, const unsigned int& nMaxEntries, std::vector<CDomainEntry>& vEntries, const BDAP::ObjectType& accountType)
+{
+    LOCK(cs_bdap_entry);
+    std::pair<std::string, CharString> key;
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(make_pair(std::string("dc"), vchAfterObjectPath));
+    while (pcursor->Valid() && vEntries.size() < nMaxEntries) {
+        boost::this_thread::interruption_point();
+        try {
+            if (!pcursor->GetKey(key) || key.first != "dc")
+                break;
+
+            if (vchAfterObjectPath.empty() || key.second != vchAfterObjectPath) {
+                CDomainEntry entry;
+                pcursor->GetValue(entry);
+                //filter by accountType, unless DEFAULT
+                if ((entry.nObjectType == GetObjectTypeInt(accountType)) || (accountType == DEFAULT_ACCOUNT_TYPE)) {
+                    if (vchObjectLocation.empty() || entry.vchObjectLocation() == vchObjectLocation)
+                        vEntries.push_back(entry);
+                }
+            }
+            pcursor->Next();
+        }
+        catch (std::exception& e) {
+            return error("%s() : deserialize error", __PRETTY_FUNCTION__);
+        }
+    }
+    return true;
+}
+
 bool CDomainEntryDB::GetDomainEntryInfo(const std::vector<unsigned char>& vchFullObjectPath, UniValue& oDomainEntryInfo)
 {
     CDomainEntry entry;
@@ -443,6 +508,7 @@ bool CheckDeleteDomainEntryTxInputs(const CDomainEntry& entry, const CScript& sc
         errorMessage = "CheckDeleteDomainEntryTxInputs: - Error deleting entry entry in LevelDB; this delete operation failed!";
         return error(errorMessage.c_str());
     }
+    pDomainEntryDB->AddDomainEntryIndex(prevDomainEntry, OP_BDAP_DELETE);
 
     return FlushLevelDB();
 }
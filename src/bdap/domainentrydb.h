@@ -35,6 +35,8 @@ public:
     bool UpdateDomainEntry(const std::vector<unsigned char>& vchObjectPath, const CDomainEntry& entry);
     bool CleanupLevelDB(int& nRemoved);
     bool ListDirectories(const std::vector<unsigned char>& vchObjectLocation, const unsigned int& nResultsPerPage, const unsigned int& nPage, UniValue& oDomainEntryList, const BDAP::ObjectType& accountType = DEFAULT_ACCOUNT_TYPE);
+    bool ListDirectories(const std::vector<unsigned char>& vchObjectLocation, const unsigned int& nResultsPerPage, const unsigned int& nPage, std::vector<CDomainEntry>& vEntries, const BDAP::ObjectType& accountType = DEFAULT_ACCOUNT_TYPE);
+    bool ListDirectoriesAfter(const std::vector<unsigned char>& vchObjectLocation, const std::vector<unsigned char>& vchAfterObjectPath, const unsigned int& nMaxEntries, std::vector<CDomainEntry>& vEntries, const BDAP::ObjectType& accountType = DEFAULT_ACCOUNT_TYPE);
     bool GetDomainEntryInfo(const std::vector<unsigned char>& vchFullObjectPath, UniValue& oDomainEntryInfo);
     bool GetDomainEntryInfo(const std::vector<unsigned char>& vchFullObjectPath, CDomainEntry& entry);
 };
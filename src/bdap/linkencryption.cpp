@@ -0,0 +1,40 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bdap/linkencryption.h"
+
+#include "bdap/utils.h"
+#include "bdap/vgp/include/encryption.h" // for VGP E2E encryption
+#include "dht/ed25519.h"
+#include "hash.h"
+#include "uint256.h"
+
+bool EncryptLinkData(const CKeyEd25519& dhtKey, const CharString& vchSharedPubKey, const CharString& data, CharString& dataEncrypted, std::string& strErrorMessage)
+{
+    // Readable by the sender and by the shared link key
+    std::vector<CharString> vvchPubKeys;
+    vvchPubKeys.push_back(dhtKey.GetPubKeyBytes());
+    vvchPubKeys.push_back(EncodedPubKeyToBytes(vchSharedPubKey));
+    if (!EncryptBDAPData(vvchPubKeys, data, dataEncrypted, strErrorMessage))
+        return false;
+
+    dataEncrypted.insert(dataEncrypted.begin(), (unsigned char)BDAP_LINK_DATA_VERSION_ENCRYPTED);
+    return true;
+}
+
+bool DecryptLinkData(const CharString& vchPrivSeed, const CharString& vchData, CharString& dataDecrypted, CharString& vchHash, std::string& strErrorMessage)
+{
+    if (vchData.empty() || (int)vchData[0] != BDAP_LINK_DATA_VERSION_ENCRYPTED) {
+        strErrorMessage = "Link data is not encrypted.";
+        return false;
+    }
+
+    const CharString vchEncrypted(vchData.begin() + 1, vchData.end());
+    if (!DecryptBDAPData(vchPrivSeed, vchEncrypted, dataDecrypted, strErrorMessage))
+        return false;
+
+    uint256 hash = Hash(dataDecrypted.begin(), dataDecrypted.end());
+    vchHash = vchFromString(hash.GetHex());
+    return true;
+}
@@ -0,0 +1,30 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DYNAMIC_BDAP_LINKENCRYPTION_H
+#define DYNAMIC_BDAP_LINKENCRYPTION_H
+
+#include "bdap.h"
+
+#include <string>
+#include <vector>
+
+class CKeyEd25519;
+
+/** Link data version of data encrypted for the link participants */
+static constexpr int BDAP_LINK_DATA_VERSION_ENCRYPTED = 1;
+
+/**
+ * Encrypts link data for dhtKey and the shared link key and prefixes the
+ * encrypted link data version.
+ */
+bool EncryptLinkData(const CKeyEd25519& dhtKey, const CharString& vchSharedPubKey, const CharString& data, CharString& dataEncrypted, std::string& strErrorMessage);
+
+/**
+ * Decrypts versioned link data with the private seed of a DHT or shared
+ * link key. vchHash is set to the data hash the way GetBDAPData does.
+ */
+bool DecryptLinkData(const CharString& vchPrivSeed, const CharString& vchData, CharString& dataDecrypted, CharString& vchHash, std::string& strErrorMessage);
+
+#endif // DYNAMIC_BDAP_LINKENCRYPTION_H
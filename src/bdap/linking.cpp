@@ -303,20 +303,9 @@ std::string CLinkAccept::LinkPathString() const
 /** Checks if BDAP link request pubkey exists in the memory pool */
 bool LinkPubKeyExistsInMemPool(const CTxMemPool& pool, const std::vector<unsigned char>& vchPubKey, const std::string& strOpType, std::string& errorMessage)
 {
-    for (const CTxMemPoolEntry& e : pool.mapTx) {
-        const CTransactionRef& tx = e.GetSharedTx();
-        for (const CTxOut& txOut : tx->vout) {
-            if (IsBDAPDataOutput(txOut)) {
-                std::vector<unsigned char> vchMemPoolPubKey;
-                std::string strGetOpType;
-                if (!ExtractOpTypeValue(txOut.scriptPubKey, strGetOpType, vchMemPoolPubKey))
-                    continue;
-                if (vchPubKey == vchMemPoolPubKey && strOpType == strGetOpType) {
-                    errorMessage = "CheckIfExistsInMemPool: A BDAP link request public key " + stringFromVch(vchPubKey) + " transaction is already in the memory pool!";
-                    return true;
-                }
-            }
-        }
+    if (pool.existsBDAPLinkPubKey(vchPubKey, strOpType)) {
+        errorMessage = "CheckIfExistsInMemPool: A BDAP link request public key " + stringFromVch(vchPubKey) + " transaction is already in the memory pool!";
+        return true;
     }
     return false;
 }
@@ -473,6 +473,7 @@ static bool CheckNewLinkRequestTx(const CScript& scriptData, const vchCharString
         errorMessage = "CheckNewLinkRequestTx failed! Error flushing LevelDB.";
         return error(errorMessage.c_str());
     }
+    GetMainSignals().NotifyBDAPLink(txid, "bdap_new_link_request", vvchOpParameters, scriptData);
     return true;
 }
 
@@ -514,6 +515,7 @@ static bool CheckNewLinkAcceptTx(const CScript& scriptData, const vchCharString&
         errorMessage = "CheckNewLinkAcceptTx failed! Error flushing LevelDB.";
         return error(errorMessage.c_str());
     }
+    GetMainSignals().NotifyBDAPLink(txid, "bdap_new_link_accept", vvchOpParameters, scriptData);
     return true;
 }
 
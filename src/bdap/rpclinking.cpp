@@ -5,7 +5,7 @@
 #include "bdap/bdap.h"
 #include "bdap/domainentry.h"
 #include "bdap/domainentrydb.h"
-#include "bdap/vgp/include/encryption.h" // for VGP E2E encryption
+#include "bdap/linkencryption.h"
 #include "bdap/linking.h"
 #include "bdap/linkingdb.h"
 #include "bdap/utils.h"
@@ -210,15 +210,10 @@ static UniValue SendLinkRequest(const JSONRPCRequest& request)
 
     // Encrypt serialized data for the sender and recipient
     strMessage = "";
-    std::vector<std::vector<unsigned char>> vvchPubKeys;
-    vvchPubKeys.push_back(privReqDHTKey.GetPubKeyBytes()); // do we need to add the sender's pubkey?
-    vvchPubKeys.push_back(EncodedPubKeyToBytes(vchSharedPubKey));
     std::vector<unsigned char> dataEncrypted;
-    if (!EncryptBDAPData(vvchPubKeys, data, dataEncrypted, strMessage))
+    if (!EncryptLinkData(privReqDHTKey, vchSharedPubKey, data, dataEncrypted, strMessage))
         throw std::runtime_error("BDAP_SEND_LINK_RPC_ERROR: ERRCODE: 4011 - Error encrypting link data: " + strMessage);
 
-    dataEncrypted = AddVersionToLinkData(dataEncrypted, 1);
-
     // Create BDAP OP_RETURN script
     CScript scriptData;
     scriptData << OP_RETURN << dataEncrypted;
@@ -363,15 +358,10 @@ static UniValue SendLinkAccept(const JSONRPCRequest& request)
     txLinkAccept.Serialize(data);
     // Encrypt serialized data for the sender and recipient
     strMessage = "";
-    std::vector<std::vector<unsigned char>> vvchPubKeys;
-    vvchPubKeys.push_back(privAcceptDHTKey.GetPubKeyBytes()); // do we need to add the recipient's pubkey?
-    vvchPubKeys.push_back(EncodedPubKeyToBytes(vchSharedPubKey));
     std::vector<unsigned char> dataEncrypted;
-    if (!EncryptBDAPData(vvchPubKeys, data, dataEncrypted, strMessage))
+    if (!EncryptLinkData(privAcceptDHTKey, vchSharedPubKey, data, dataEncrypted, strMessage))
         throw std::runtime_error("BDAP_SEND_LINK_RPC_ERROR: ERRCODE: 4011 - Error encrypting link data: " + strMessage);
 
-    dataEncrypted = AddVersionToLinkData(dataEncrypted, 1);
-
     // Create BDAP OP_RETURN script
     CScript scriptData;
     scriptData << OP_RETURN << dataEncrypted;
@@ -0,0 +1,51 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#if defined(HAVE_CONFIG_H)
+#include "config/dynamic-config.h"
+#endif
+
+#include "bench.h"
+
+#ifdef ENABLE_GPU
+#include "crypto/argon2gpu/common.h"
+#include "hash.h"
+#include "primitives/block.h"
+#include "utilstrencodings.h"
+
+#include <vector>
+
+/* Host side of the GPU miner: the initial blocks are filled and the result
+ * finalized on the CPU for every nonce batch, around the device kernels.
+ * Uses the same parameters as GPUMiner.
+ */
+
+static void Argon2GPU_FillFirstBlocks(benchmark::State& state)
+{
+    argon2gpu::Argon2Params params((std::size_t)OUTPUT_BYTES, 2, 500, 8);
+    std::vector<unsigned char> memory(params.getMemorySize());
+    CBlockHeader header;
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        params.fillFirstBlocks(memory.data(), BEGIN(header.nVersion), END(header.nNonce) - BEGIN(header.nVersion),
+            argon2gpu::ARGON2_D, argon2gpu::ARGON2_VERSION_10);
+    }
+}
+
+static void Argon2GPU_Finalize(benchmark::State& state)
+{
+    argon2gpu::Argon2Params params((std::size_t)OUTPUT_BYTES, 2, 500, 8);
+    std::vector<unsigned char> memory(params.getMemorySize());
+    CBlockHeader header;
+    params.fillFirstBlocks(memory.data(), BEGIN(header.nVersion), END(header.nNonce) - BEGIN(header.nVersion),
+        argon2gpu::ARGON2_D, argon2gpu::ARGON2_VERSION_10);
+    unsigned char out[OUTPUT_BYTES];
+    while (state.KeepRunning()) {
+        params.finalize(out, memory.data());
+    }
+}
+
+BENCHMARK(Argon2GPU_FillFirstBlocks);
+BENCHMARK(Argon2GPU_Finalize);
+#endif // ENABLE_GPU
@@ -4,7 +4,9 @@
 
 #include "bench.h"
 
+#include <iomanip>
 #include <iostream>
+#include <regex>
 #include <sys/time.h>
 
 using namespace benchmark;
@@ -23,17 +25,79 @@ BenchRunner::BenchRunner(std::string name, BenchFunction func)
 }
 
 void
-BenchRunner::RunAll(double elapsedTimeForOne)
+BenchRunner::RunAll(Printer& printer, double elapsedTimeForOne, const std::string& strFilter)
 {
-    std::cout << "Benchmark" << "," << "count" << "," << "min" << "," << "max" << "," << "average" << "\n";
+    std::regex reFilter(strFilter);
 
+    printer.header();
     for (std::map<std::string,BenchFunction>::iterator it = benchmarks.begin();
          it != benchmarks.end(); ++it) {
 
-        State state(it->first, elapsedTimeForOne);
+        if (!std::regex_match(it->first, reFilter))
+            continue;
+
+        State state(it->first, printer, elapsedTimeForOne);
         BenchFunction& func = it->second;
         func(state);
     }
+    printer.footer();
+}
+
+void CsvPrinter::header()
+{
+    std::cout << "Benchmark" << "," << "count" << "," << "min" << "," << "max" << "," << "average" << "\n";
+}
+
+void CsvPrinter::result(const Result& result)
+{
+    std::cout << result.name << "," << result.count << "," << result.minTime << "," << result.maxTime << "," << result.average;
+    for (const auto& counter : result.counters)
+        std::cout << "," << counter.first << "=" << counter.second;
+    std::cout << "\n";
+}
+
+void CsvPrinter::footer()
+{
+}
+
+// Benchmark names and environment strings are plain identifiers, only quotes and backslashes need escaping
+static std::string JsonString(const std::string& str)
+{
+    std::string ret = "\"";
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            ret += '\\';
+        ret += c;
+    }
+    return ret + "\"";
+}
+
+void JsonPrinter::header()
+{
+    std::cout << "{\n";
+    for (const auto& info : vInfo)
+        std::cout << "  " << JsonString(info.first) << ": " << JsonString(info.second) << ",\n";
+    std::cout << "  \"benchmarks\": [";
+}
+
+void JsonPrinter::result(const Result& result)
+{
+    std::cout << (fFirst ? "\n" : ",\n") << std::setprecision(9)
+              << "    {\"name\": " << JsonString(result.name) << ", \"count\": " << result.count
+              << ", \"min\": " << result.minTime << ", \"max\": " << result.maxTime << ", \"average\": " << result.average;
+    if (!result.counters.empty()) {
+        std::cout << ", \"counters\": {";
+        for (auto it = result.counters.begin(); it != result.counters.end(); ++it)
+            std::cout << (it == result.counters.begin() ? "" : ", ") << JsonString(it->first) << ": " << it->second;
+        std::cout << "}";
+    }
+    std::cout << "}";
+    fFirst = false;
+}
+
+void JsonPrinter::footer()
+{
+    std::cout << "\n  ]\n}\n";
 }
 
 bool State::KeepRunning()
@@ -63,8 +127,14 @@ bool State::KeepRunning()
     --count;
 
     // Output results
-    double average = (now-beginTime)/count;
-    std::cout << name << "," << count << "," << minTime << "," << maxTime << "," << average << "\n";
+    Result result;
+    result.name = name;
+    result.count = count;
+    result.minTime = minTime;
+    result.maxTime = maxTime;
+    result.average = (now-beginTime)/count;
+    result.counters = counters;
+    printer.result(result);
 
     return false;
 }
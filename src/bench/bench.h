@@ -5,8 +5,10 @@
 #ifndef DYNAMIC_BENCH_BENCH_H
 #define DYNAMIC_BENCH_BENCH_H
 
+#include <limits>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <boost/function.hpp>
 #include <boost/preprocessor/cat.hpp>
@@ -36,15 +38,21 @@ BENCHMARK(CODE_TO_TIME);
  
 namespace benchmark {
 
+    class Printer;
+
     class State {
         std::string name;
+        Printer& printer;
         double maxElapsed;
         double beginTime;
         double lastTime, minTime, maxTime;
         int64_t count;
         int64_t timeCheckCount;
     public:
-        State(std::string _name, double _maxElapsed) : name(_name), maxElapsed(_maxElapsed), count(0) {
+        /** Extra figures reported with the timings, e.g. throughput or memory use, set by the benchmark before its last KeepRunning() */
+        std::map<std::string, double> counters;
+
+        State(std::string _name, Printer& _printer, double _maxElapsed) : name(_name), printer(_printer), maxElapsed(_maxElapsed), count(0) {
             minTime = std::numeric_limits<double>::max();
             maxTime = std::numeric_limits<double>::min();
             timeCheckCount = 1;
@@ -52,6 +60,47 @@ namespace benchmark {
         bool KeepRunning();
     };
 
+    /** Timings of one benchmark, all times in seconds per iteration */
+    struct Result {
+        std::string name;
+        int64_t count;
+        double minTime;
+        double maxTime;
+        double average;
+        std::map<std::string, double> counters;
+    };
+
+    /** Receives the results as the benchmarks finish */
+    class Printer
+    {
+    public:
+        virtual ~Printer() {}
+        virtual void header() = 0;
+        virtual void result(const Result& result) = 0;
+        virtual void footer() = 0;
+    };
+
+    /** The original comma separated output, one line per benchmark */
+    class CsvPrinter : public Printer
+    {
+    public:
+        void header();
+        void result(const Result& result);
+        void footer();
+    };
+
+    /** A single JSON document with the run's environment and an array of results, for build farm regression gates */
+    class JsonPrinter : public Printer
+    {
+        std::vector<std::pair<std::string, std::string> > vInfo;
+        bool fFirst;
+    public:
+        JsonPrinter(const std::vector<std::pair<std::string, std::string> >& vInfoIn) : vInfo(vInfoIn), fFirst(true) {}
+        void header();
+        void result(const Result& result);
+        void footer();
+    };
+
     typedef boost::function<void(State&)> BenchFunction;
 
     class BenchRunner
@@ -61,7 +110,8 @@ namespace benchmark {
     public:
         BenchRunner(std::string name, BenchFunction func);
 
-        static void RunAll(double elapsedTimeForOne=1.0);
+        /** Run every benchmark whose name matches the regular expression strFilter */
+        static void RunAll(Printer& printer, double elapsedTimeForOne=1.0, const std::string& strFilter=".*");
     };
 }
 
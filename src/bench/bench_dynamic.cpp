@@ -4,18 +4,56 @@
 
 #include "bench.h"
 
+#include "clientversion.h"
+#include "crypto/sha256.h"
 #include "key.h"
 #include "validation.h"
 #include "util.h"
 
+#include <iostream>
+#include <memory>
+
+static const char* DEFAULT_BENCH_OUTPUT = "csv";
+static const char* DEFAULT_BENCH_FILTER = ".*";
+static const int64_t DEFAULT_BENCH_TIME_MILLIS = 1000;
+
 int
 main(int argc, char** argv)
 {
+    ParseParameters(argc, argv);
+
+    if (IsArgSet("-?") || IsArgSet("-h") || IsArgSet("-help")) {
+        std::cout << "Usage:\n"
+                  << "  bench_dynamic [options]\n\n"
+                  << "Options:\n"
+                  << "  -output=<csv|json>  Result format (default: " << DEFAULT_BENCH_OUTPUT << ")\n"
+                  << "  -filter=<regex>     Only run benchmarks whose name matches (default: " << DEFAULT_BENCH_FILTER << ")\n"
+                  << "  -time=<n>           Run each benchmark for about <n> milliseconds (default: " << DEFAULT_BENCH_TIME_MILLIS << ")\n";
+        return 0;
+    }
+
     ECC_Start();
     SetupEnvironment();
     fPrintToDebugLog = false; // don't want to write to debug.log file
 
-    benchmark::BenchRunner::RunAll();
+    std::string strOutput = GetArg("-output", DEFAULT_BENCH_OUTPUT);
+    std::unique_ptr<benchmark::Printer> printer;
+    if (strOutput == "json") {
+        std::vector<std::pair<std::string, std::string> > vInfo;
+        vInfo.push_back(std::make_pair("version", FormatFullVersion()));
+        // the benchmarks select their SHA256 backend themselves, this is what the host supports
+        vInfo.push_back(std::make_pair("sha256_autodetect", SHA256AutoDetect()));
+        SHA256UseStandard();
+        printer.reset(new benchmark::JsonPrinter(vInfo));
+    } else if (strOutput == "csv") {
+        printer.reset(new benchmark::CsvPrinter());
+    } else {
+        std::cerr << "Error: unknown output format '" << strOutput << "'\n";
+        ECC_Stop();
+        return 1;
+    }
+
+    benchmark::BenchRunner::RunAll(*printer, GetArg("-time", DEFAULT_BENCH_TIME_MILLIS) / 1000.0, GetArg("-filter", DEFAULT_BENCH_FILTER));
 
     ECC_Stop();
 }
@@ -0,0 +1,472 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "base58.h"
+#include "bdap/domainentry.h"
+#include "bdap/domainentrydb.h"
+#include "bdap/linkingdb.h"
+#include "bdap/utils.h"
+#include "chainparams.h"
+#include "consensus/consensus.h"
+#include "fluid/fluid.h"
+#include "fluid/fluiddynode.h"
+#include "fluid/fluidmining.h"
+#include "fluid/fluidmint.h"
+#include "fluid/fluidsovereign.h"
+#include "fluid/operations.h"
+#include "key.h"
+#include "miner/miner.h"
+#include "net.h"
+#include "noui.h"
+#include "policy/policy.h"
+#include "pow.h"
+#include "random.h"
+#include "script/interpreter.h"
+#include "spork.h"
+#include "txdb.h"
+#include "util.h"
+#include "utilmoneystr.h"
+#include "utilstrencodings.h"
+#include "validation.h"
+
+#include <fstream>
+#include <iostream>
+
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+
+/* Block connection throughput for Dynamic specific workloads. A regtest
+ * chain is generated once with a configurable mix of P2PKH, BDAP account
+ * and link, and fluid transactions; every iteration then replays it through
+ * ProcessNewBlock into a freshly wiped chain state with the address, spent
+ * and timestamp indexes enabled.
+ *
+ *   -replayblocks=<n>                 blocks carrying transactions (default: 100)
+ *   -replaytxs=<n>                    transactions per block (default: 20)
+ *   -replaymix=<p2pkh>:<bdap>:<fluid> relative transaction weights (default: 80:18:2)
+ *   -par=<n>                          script verification threads, as for dynamicd
+ *
+ * Besides the time per replay it reports blocks/s and the per block time of
+ * the validation stages for the replayed blocks, and the peak resident set.
+ */
+
+static const int DEFAULT_REPLAY_BLOCKS = 100;
+static const int DEFAULT_REPLAY_TXS = 20;
+static const char* DEFAULT_REPLAY_MIX = "80:18:2";
+
+static const CAmount REPLAY_TX_FEE = 10000;
+static const CAmount REPLAY_PAYMENT = COIN;
+
+// Three of the regtest fluid sovereign keys (see CFluidParameters::InitialiseSovereignIdentities)
+static const char* FLUID_SOVEREIGN_KEYS[] = {
+    "c811738afcf19db27d368085db552717cdfec6d7f31c957b825fa136f12de3f3",
+    "a27da22f07e59a50e118a08d6c777bf19552bcddbe90b0890c77d7271502b0d8",
+    "f236d801b81d38fd721fe415aa190cf09bd33079886644f25dc79b41e0120fb0",
+};
+
+enum ReplayTxType {
+    REPLAY_P2PKH,
+    REPLAY_BDAP,
+    REPLAY_FLUID,
+};
+
+/** A throwaway regtest data directory holding the chain state and the BDAP and fluid databases */
+class CReplayChainState
+{
+    boost::filesystem::path pathTemp;
+    CCoinsViewDB* pcoinsdbview;
+
+public:
+    CReplayChainState()
+    {
+        ClearDatadirCache();
+        pathTemp = boost::filesystem::temp_directory_path() / strprintf("bench_dynamic_replay_%lu_%i", (unsigned long)GetTime(), (int)(GetRand(100000)));
+        boost::filesystem::create_directories(pathTemp);
+        ForceSetArg("-datadir", pathTemp.string());
+
+        pblocktree = new CBlockTreeDB(1 << 22, false, true);
+        pcoinsdbview = new CCoinsViewDB(1 << 23, false, true);
+        pcoinsTip = new CCoinsViewCache(pcoinsdbview);
+        pFluidDynodeDB = new CFluidDynodeDB(1 << 20, false, true, false);
+        pFluidMiningDB = new CFluidMiningDB(1 << 20, false, true, false);
+        pFluidMintDB = new CFluidMintDB(1 << 20, false, true, false);
+        pFluidSovereignDB = new CFluidSovereignDB(1 << 20, false, true, false);
+        pDomainEntryDB = new CDomainEntryDB(1 << 20, false, true, false);
+        pLinkRequestDB = new CLinkRequestDB(1 << 20, false, true, false);
+        pLinkAcceptDB = new CLinkAcceptDB(1 << 20, false, true, false);
+
+        InitBlockIndex(Params());
+        CValidationState state;
+        ActivateBestChain(state, Params());
+    }
+
+    ~CReplayChainState()
+    {
+        UnloadBlockIndex();
+        delete pcoinsTip;
+        pcoinsTip = NULL;
+        delete pcoinsdbview;
+        delete pblocktree;
+        pblocktree = NULL;
+        delete pFluidDynodeDB;
+        pFluidDynodeDB = NULL;
+        delete pFluidMiningDB;
+        pFluidMiningDB = NULL;
+        delete pFluidMintDB;
+        pFluidMintDB = NULL;
+        delete pFluidSovereignDB;
+        pFluidSovereignDB = NULL;
+        delete pDomainEntryDB;
+        pDomainEntryDB = NULL;
+        delete pLinkRequestDB;
+        pLinkRequestDB = NULL;
+        delete pLinkAcceptDB;
+        pLinkAcceptDB = NULL;
+        boost::filesystem::remove_all(pathTemp);
+    }
+};
+
+// Peak resident set size in MiB, or 0 where /proc is not available
+static double PeakResidentMiB()
+{
+    std::ifstream file("/proc/self/status");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0)
+            return atoi64(line.substr(6)) / 1024.0; // reported in kB
+    }
+    return 0;
+}
+
+static std::shared_ptr<const CBlock> MineBlock(const CChainParams& chainparams, const CScript& scriptPubKey, const std::vector<CMutableTransaction>& vtx)
+{
+    std::unique_ptr<CBlockTemplate> pblocktemplate = CreateNewBlock(chainparams, scriptPubKey);
+    CBlock& block = pblocktemplate->block;
+    block.vtx.resize(1);
+    for (const CMutableTransaction& tx : vtx)
+        block.vtx.push_back(MakeTransactionRef(tx));
+    unsigned int nExtraNonce = 0;
+    IncrementExtraNonce(block, chainActive.Tip(), nExtraNonce);
+    while (!CheckProofOfWork(block.GetHash(), block.nBits, chainparams.GetConsensus()))
+        ++block.nNonce;
+
+    std::shared_ptr<const CBlock> pblock = std::make_shared<const CBlock>(block);
+    if (!ProcessNewBlock(chainparams, pblock, true, NULL) || chainActive.Tip()->GetBlockHash() != pblock->GetHash())
+        return nullptr;
+    return pblock;
+}
+
+static void SignP2PKH(CMutableTransaction& tx, const CKey& key, const CScript& scriptPubKeyPrev)
+{
+    std::vector<unsigned char> vchSig;
+    uint256 hash = SignatureHash(scriptPubKeyPrev, tx, 0, SIGHASH_ALL);
+    key.Sign(hash, vchSig);
+    vchSig.push_back((unsigned char)SIGHASH_ALL);
+    tx.vin[0].scriptSig = CScript() << vchSig << ToByteVector(key.GetPubKey());
+}
+
+static CScript RandomDestination()
+{
+    uint256 hash = GetRandHash();
+    return GetScriptForDestination(CKeyID(uint160(std::vector<unsigned char>(hash.begin(), hash.begin() + 20))));
+}
+
+static std::vector<unsigned char> RandomPubKeyHex()
+{
+    return vchFromString(GetRandHash().GetHex());
+}
+
+// BDAP operation outputs: the OP_RETURN data (if any), then the operation script
+static void AddBDAPOutputs(CMutableTransaction& tx, int nBDAP)
+{
+    int64_t nExpireTime = chainActive.Tip()->GetMedianTimePast() + DEFAULT_REGISTRATION_DAYS * SECONDS_PER_DAY;
+    CScript scriptOp;
+    CScript scriptData;
+    if (nBDAP % 3 == 0) {
+        CDomainEntry entry;
+        entry.OID = vchDefaultOIDPrefix;
+        entry.DomainComponent = vchDefaultDomainName;
+        entry.OrganizationalUnit = vchDefaultPublicOU;
+        entry.CommonName = vchFromString(strprintf("Replay Account %d", nBDAP));
+        entry.OrganizationName = vchDefaultOrganizationName;
+        entry.ObjectID = vchFromString(strprintf("replay%d", nBDAP));
+        entry.fPublicObject = 1;
+        entry.nObjectType = GetObjectTypeInt(BDAP::ObjectType::BDAP_USER);
+        entry.WalletAddress = vchFromString(CDynamicAddress(CKeyID(uint160(RandomPubKeyHex()))).ToString());
+        entry.LinkAddress = vchFromString(CDynamicAddress(CKeyID(uint160(RandomPubKeyHex()))).ToString());
+        entry.DHTPublicKey = RandomPubKeyHex();
+        entry.nExpireTime = nExpireTime;
+
+        std::vector<unsigned char> data;
+        entry.Serialize(data);
+        scriptData << OP_RETURN << data;
+        scriptOp << CScript::EncodeOP_N(OP_BDAP_NEW) << CScript::EncodeOP_N(OP_BDAP_ACCOUNT_ENTRY)
+                 << entry.vchFullObjectPath() << entry.DHTPublicKey << entry.nExpireTime << OP_2DROP << OP_2DROP << OP_DROP;
+    } else {
+        // Link data is encrypted for the two parties, consensus only checks its size
+        std::vector<unsigned char> data(300);
+        GetRandBytes(data.data(), data.size());
+        scriptData << OP_RETURN << data;
+        scriptOp << CScript::EncodeOP_N(OP_BDAP_NEW) << CScript::EncodeOP_N(nBDAP % 3 == 1 ? OP_BDAP_LINK_REQUEST : OP_BDAP_LINK_ACCEPT)
+                 << RandomPubKeyHex() << RandomPubKeyHex() << nExpireTime << OP_2DROP << OP_2DROP << OP_DROP;
+    }
+    scriptOp += RandomDestination();
+    tx.vout.push_back(CTxOut(0, scriptData));
+    tx.vout.push_back(CTxOut(DEFAULT_MIN_RELAY_TX_FEE, scriptOp));
+}
+
+// A mining reward instruction signed by three sovereign keys
+static CScript FluidRewardScript(int nFluid, int64_t nTime)
+{
+    std::string strToken = StitchString(FormatMoney((1 + nFluid % 5) * COIN), std::to_string(nTime + nFluid), true);
+    std::string strSigned = strToken;
+    for (const char* pszKey : FLUID_SOVEREIGN_KEYS) {
+        std::vector<unsigned char> vchKey = ParseHex(pszKey);
+        CKey key;
+        key.Set(vchKey.begin(), vchKey.end(), true);
+        CHashWriter ss(SER_GETHASH, 0);
+        ss << strMessageMagic;
+        ss << strToken;
+        std::vector<unsigned char> vchSig;
+        key.SignCompact(ss.GetHash(), vchSig);
+        strSigned = StitchString(strSigned, EncodeBase64(vchSig.data(), vchSig.size()), false);
+    }
+    return CScript() << OP_REWARD_MINING << std::vector<unsigned char>(strSigned.begin(), strSigned.end());
+}
+
+static bool ParseReplayMix(const std::string& strMix, int (&nWeights)[3])
+{
+    std::vector<std::string> vParts;
+    boost::split(vParts, strMix, boost::is_any_of(":"));
+    if (vParts.size() != 3)
+        return false;
+    for (int i = 0; i < 3; i++) {
+        if (!ParseInt32(vParts[i], &nWeights[i]) || nWeights[i] < 0)
+            return false;
+    }
+    return nWeights[0] + nWeights[1] + nWeights[2] > 0;
+}
+
+// Transaction types of every slot, spread evenly according to the weights
+static std::vector<ReplayTxType> PlanReplayTxs(int nTotal, const int (&nWeights)[3])
+{
+    std::vector<ReplayTxType> vTypes;
+    int nSum = nWeights[0] + nWeights[1] + nWeights[2];
+    for (int i = 0; i < nTotal; i++) {
+        int n = (i * 37) % nSum; // stride to interleave the types rather than batch them
+        vTypes.push_back(n < nWeights[0] ? REPLAY_P2PKH : (n < nWeights[0] + nWeights[1] ? REPLAY_BDAP : REPLAY_FLUID));
+    }
+    return vTypes;
+}
+
+/**
+ * Mine the synthetic chain: the block 1 premine is matured, split into one
+ * coin per transaction slot plus the fluid instruction costs, and then every
+ * replay block spends each slot once.
+ */
+static bool GenerateReplayChain(const CChainParams& chainparams, int nBlocks, int nTxs, const int (&nWeights)[3],
+    std::vector<std::shared_ptr<const CBlock> >& vBlocks, size_t& nSetupBlocks)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    CScript scriptKey = GetScriptForDestination(key.GetPubKey().GetID());
+
+    for (int i = 0; i <= COINBASE_MATURITY; i++) {
+        std::shared_ptr<const CBlock> pblock = MineBlock(chainparams, scriptKey, std::vector<CMutableTransaction>());
+        if (!pblock)
+            return false;
+        vBlocks.push_back(pblock);
+    }
+
+    const CTransaction& txPremine = *vBlocks[1]->vtx[0];
+    int nPremineOut = -1;
+    for (unsigned int i = 0; i < txPremine.vout.size(); i++) {
+        if (txPremine.vout[i].scriptPubKey == scriptKey)
+            nPremineOut = i;
+    }
+    if (nPremineOut < 0)
+        return false;
+    CAmount nPremine = txPremine.vout[nPremineOut].nValue;
+
+    std::vector<ReplayTxType> vTypes = PlanReplayTxs(nBlocks * nTxs, nWeights);
+    CAmount nSlotValue = nBlocks * (REPLAY_PAYMENT + DEFAULT_MIN_RELAY_TX_FEE + REPLAY_TX_FEE);
+    CAmount nFluidValue = CFluid::FLUID_TRANSACTION_COST + REPLAY_TX_FEE;
+    int nMaxFluid = std::max<CAmount>(0, (nPremine - REPLAY_TX_FEE - nTxs * nSlotValue) / nFluidValue);
+    int nFluid = 0;
+    for (ReplayTxType& type : vTypes) {
+        if (type == REPLAY_FLUID && ++nFluid > nMaxFluid)
+            type = REPLAY_P2PKH; // the premine cannot pay for more instructions
+    }
+    nFluid = std::min(nFluid, nMaxFluid);
+    if (nPremine - REPLAY_TX_FEE - nFluid * nFluidValue < nTxs * nSlotValue)
+        return false;
+
+    // Split the premine, slot coins first, then one coin per fluid instruction
+    CMutableTransaction txSplit;
+    txSplit.vin.resize(1);
+    txSplit.vin[0].prevout = COutPoint(txPremine.GetHash(), nPremineOut);
+    for (int i = 0; i < nTxs; i++)
+        txSplit.vout.push_back(CTxOut(nSlotValue, scriptKey));
+    for (int i = 0; i < nFluid; i++)
+        txSplit.vout.push_back(CTxOut(nFluidValue, scriptKey));
+    txSplit.vout[0].nValue = nPremine - REPLAY_TX_FEE - nFluid * nFluidValue - (nTxs - 1) * nSlotValue;
+    SignP2PKH(txSplit, key, scriptKey);
+    std::shared_ptr<const CBlock> pblockSplit = MineBlock(chainparams, scriptKey, std::vector<CMutableTransaction>(1, txSplit));
+    if (!pblockSplit)
+        return false;
+    vBlocks.push_back(pblockSplit);
+    nSetupBlocks = vBlocks.size();
+
+    std::vector<std::pair<COutPoint, CAmount> > vSlots;
+    for (int i = 0; i < nTxs; i++)
+        vSlots.push_back(std::make_pair(COutPoint(txSplit.GetHash(), i), txSplit.vout[i].nValue));
+    int nNextFluid = 0;
+    int nBDAP = 0;
+    int64_t nTime = GetTime();
+
+    for (int b = 0; b < nBlocks; b++) {
+        std::vector<CMutableTransaction> vtx;
+        for (int j = 0; j < nTxs; j++) {
+            CMutableTransaction tx;
+            tx.vin.resize(1);
+            if (vTypes[b * nTxs + j] == REPLAY_FLUID) {
+                tx.vin[0].prevout = COutPoint(txSplit.GetHash(), nTxs + nNextFluid);
+                tx.vout.push_back(CTxOut(CFluid::FLUID_TRANSACTION_COST, FluidRewardScript(nNextFluid++, nTime)));
+                SignP2PKH(tx, key, scriptKey);
+                vtx.push_back(tx);
+                continue;
+            }
+
+            CAmount nValueIn = vSlots[j].second;
+            tx.vin[0].prevout = vSlots[j].first;
+            if (vTypes[b * nTxs + j] == REPLAY_BDAP) {
+                tx.nVersion = BDAP_TX_VERSION;
+                AddBDAPOutputs(tx, nBDAP++);
+            } else {
+                tx.vout.push_back(CTxOut(REPLAY_PAYMENT, RandomDestination()));
+            }
+            CAmount nValueOut = 0;
+            for (const CTxOut& txout : tx.vout)
+                nValueOut += txout.nValue;
+            tx.vout.push_back(CTxOut(nValueIn - nValueOut - REPLAY_TX_FEE, scriptKey));
+            SignP2PKH(tx, key, scriptKey);
+            vSlots[j] = std::make_pair(COutPoint(tx.GetHash(), tx.vout.size() - 1), tx.vout.back().nValue);
+            vtx.push_back(tx);
+        }
+        std::shared_ptr<const CBlock> pblock = MineBlock(chainparams, scriptKey, vtx);
+        if (!pblock)
+            return false;
+        vBlocks.push_back(pblock);
+    }
+    return true;
+}
+
+// BDAP transactions are only connected once the spork is on, sign it with a throwaway spork key
+static bool ActivateBDAPSpork()
+{
+    if (sporkManager.IsSporkActive(SPORK_30_ACTIVATE_BDAP))
+        return true;
+    CKey key;
+    key.MakeNewKey(true);
+    CConnman connman(0x1337, 0x1337);
+    return sporkManager.SetSporkAddress(CDynamicAddress(key.GetPubKey().GetID()).ToString()) &&
+           sporkManager.SetMinSporkKeys(1) &&
+           sporkManager.SetPrivKey(CDynamicSecret(key).ToString()) &&
+           sporkManager.UpdateSpork(SPORK_30_ACTIVATE_BDAP, 0, connman);
+}
+
+static void ChainReplay(benchmark::State& state)
+{
+    int nWeights[3];
+    if (!ParseReplayMix(GetArg("-replaymix", DEFAULT_REPLAY_MIX), nWeights)) {
+        std::cerr << "ChainReplay: invalid -replaymix, expected <p2pkh>:<bdap>:<fluid>\n";
+        return;
+    }
+    int nBlocks = std::max(1, (int)GetArg("-replayblocks", DEFAULT_REPLAY_BLOCKS));
+    int nTxs = std::max(1, (int)GetArg("-replaytxs", DEFAULT_REPLAY_TXS));
+
+    ECCVerifyHandle verifyHandle;
+    static bool fNoUIConnected = false;
+    if (!fNoUIConnected) {
+        noui_connect();
+        fNoUIConnected = true;
+    }
+    SelectParams(CBaseChainParams::REGTEST);
+    const CChainParams& chainparams = Params();
+    SoftSetArg("-addressindex", "1");
+    SoftSetArg("-spentindex", "1");
+    SoftSetArg("-timestampindex", "1");
+    bool fLoadedPrev = fLoaded;
+    fLoaded = true;
+
+    boost::thread_group threadGroup;
+    nScriptCheckThreads = GetArg("-par", DEFAULT_SCRIPTCHECK_THREADS);
+    if (nScriptCheckThreads <= 0)
+        nScriptCheckThreads += GetNumCores();
+    if (nScriptCheckThreads <= 1)
+        nScriptCheckThreads = 0;
+    else if (nScriptCheckThreads > MAX_SCRIPTCHECK_THREADS)
+        nScriptCheckThreads = MAX_SCRIPTCHECK_THREADS;
+    for (int i = 0; i < nScriptCheckThreads - 1; i++)
+        threadGroup.create_thread(&ThreadScriptCheck);
+
+    std::vector<std::shared_ptr<const CBlock> > vBlocks;
+    size_t nSetupBlocks = 0;
+    bool fGenerated;
+    {
+        CReplayChainState chainstate;
+        fGenerated = ActivateBDAPSpork() && GenerateReplayChain(chainparams, nBlocks, nTxs, nWeights, vBlocks, nSetupBlocks);
+    }
+
+    if (fGenerated) {
+        int64_t nReplayed = 0;
+        int64_t nReplayTime = 0;
+        CBlockValidationTimings total = {};
+        while (state.KeepRunning()) {
+            CReplayChainState chainstate;
+            for (size_t i = 0; i < nSetupBlocks; i++)
+                ProcessNewBlock(chainparams, vBlocks[i], true, NULL);
+
+            CBlockValidationTimings before = GetBlockValidationTimings();
+            int64_t nStart = GetTimeMicros();
+            for (size_t i = nSetupBlocks; i < vBlocks.size(); i++)
+                ProcessNewBlock(chainparams, vBlocks[i], true, NULL);
+            nReplayTime += GetTimeMicros() - nStart;
+            CBlockValidationTimings after = GetBlockValidationTimings();
+            if (chainActive.Tip()->GetBlockHash() != vBlocks.back()->GetHash()) {
+                std::cerr << "ChainReplay: replay stopped at height " << chainActive.Height() << "\n";
+                break;
+            }
+
+            nReplayed += vBlocks.size() - nSetupBlocks;
+            total.nCheckBlock += after.nCheckBlock - before.nCheckBlock;
+            total.nConnect += after.nConnect - before.nConnect;
+            total.nVerify += after.nVerify - before.nVerify;
+            total.nIndex += after.nIndex - before.nIndex;
+            total.nFlush += after.nFlush - before.nFlush;
+            total.nChainState += after.nChainState - before.nChainState;
+            total.nTotal += after.nTotal - before.nTotal;
+
+            state.counters["blocks_per_second"] = nReplayed * 1000000.0 / nReplayTime;
+            state.counters["checkblock_ms"] = total.nCheckBlock * 0.001 / nReplayed;
+            state.counters["connect_inputs_ms"] = total.nConnect * 0.001 / nReplayed;
+            state.counters["verify_ms"] = total.nVerify * 0.001 / nReplayed;
+            state.counters["index_ms"] = total.nIndex * 0.001 / nReplayed;
+            state.counters["flush_ms"] = (total.nFlush + total.nChainState) * 0.001 / nReplayed;
+            state.counters["connect_tip_ms"] = total.nTotal * 0.001 / nReplayed;
+            state.counters["peak_rss_mib"] = PeakResidentMiB();
+        }
+    } else {
+        std::cerr << "ChainReplay: failed to generate the replay chain\n";
+    }
+
+    threadGroup.interrupt_all();
+    threadGroup.join_all();
+    nScriptCheckThreads = 0;
+    fLoaded = fLoadedPrev;
+}
+
+BENCHMARK(ChainReplay);
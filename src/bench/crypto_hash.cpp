@@ -0,0 +1,62 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "crypto/sha256.h"
+#include "hash.h"
+#include "uint256.h"
+
+#include <vector>
+
+/* Each benchmark selects its SHA256 backend first, so the results don't
+ * depend on the order they run in. The autodetected variants measure
+ * whatever SSE4/AVX2/SHA-NI code this host supports.
+ */
+
+static const uint64_t BUFFER_SIZE = 1000 * 1000;
+
+static void SHA256(benchmark::State& state, bool fAutoDetect)
+{
+    fAutoDetect ? SHA256AutoDetect() : SHA256UseStandard();
+    uint8_t hash[CSHA256::OUTPUT_SIZE];
+    std::vector<uint8_t> in(BUFFER_SIZE, 0);
+    while (state.KeepRunning())
+        CSHA256().Write(in.data(), in.size()).Finalize(hash);
+    SHA256UseStandard();
+}
+
+static void SHA256_32b(benchmark::State& state, bool fAutoDetect)
+{
+    fAutoDetect ? SHA256AutoDetect() : SHA256UseStandard();
+    std::vector<uint8_t> in(32, 0);
+    while (state.KeepRunning()) {
+        for (int i = 0; i < 1000000; i++)
+            CSHA256().Write(in.data(), in.size()).Finalize(in.data());
+    }
+    SHA256UseStandard();
+}
+
+static void SHA256D64_1024(benchmark::State& state, bool fAutoDetect)
+{
+    fAutoDetect ? SHA256AutoDetect() : SHA256UseStandard();
+    std::vector<uint8_t> in(64 * 1024, 0);
+    while (state.KeepRunning())
+        SHA256D64(in.data(), in.data(), 1024);
+    SHA256UseStandard();
+}
+
+static void SHA256_Standard(benchmark::State& state) { SHA256(state, false); }
+static void SHA256_AutoDetect(benchmark::State& state) { SHA256(state, true); }
+static void SHA256_32b_Standard(benchmark::State& state) { SHA256_32b(state, false); }
+static void SHA256_32b_AutoDetect(benchmark::State& state) { SHA256_32b(state, true); }
+static void SHA256D64_1024_Standard(benchmark::State& state) { SHA256D64_1024(state, false); }
+static void SHA256D64_1024_AutoDetect(benchmark::State& state) { SHA256D64_1024(state, true); }
+
+BENCHMARK(SHA256_Standard);
+BENCHMARK(SHA256_AutoDetect);
+BENCHMARK(SHA256_32b_Standard);
+BENCHMARK(SHA256_32b_AutoDetect);
+BENCHMARK(SHA256D64_1024_Standard);
+BENCHMARK(SHA256D64_1024_AutoDetect);
@@ -0,0 +1,101 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "chain.h"
+#include "dynode-sync.h"
+#include "dynodeman.h"
+#include "instantsend.h"
+#include "net.h"
+#include "random.h"
+#include "validation.h"
+
+#include <vector>
+
+/* Dynode rank lookups as done by CTxLockVote::IsValid: every vote of a lock
+ * request asks for the rank of its Dynode at the height of the locked input.
+ * The cached variant draws those heights from a handful of recent blocks like
+ * real InstantSend traffic does, the uncached one drops the rank tables before
+ * every vote, which is what every lookup cost before the rank table cache.
+ */
+
+static const int RANK_BENCH_DYNODES = 5000;
+static const int RANK_BENCH_HEIGHTS = 200;
+
+class CRankBenchSetup
+{
+public:
+    std::vector<uint256> vHashes;
+    std::vector<CBlockIndex> vIndex;
+    std::vector<COutPoint> vOutpoints;
+
+    CRankBenchSetup() : vHashes(RANK_BENCH_HEIGHTS), vIndex(RANK_BENCH_HEIGHTS)
+    {
+        for (int i = 0; i < RANK_BENCH_HEIGHTS; i++) {
+            vHashes[i] = GetRandHash();
+            vIndex[i].phashBlock = &vHashes[i];
+            vIndex[i].nHeight = i;
+            vIndex[i].pprev = i > 0 ? &vIndex[i - 1] : NULL;
+        }
+        {
+            LOCK(cs_main);
+            chainActive.SetTip(&vIndex.back());
+        }
+
+        for (int i = 0; i < RANK_BENCH_DYNODES; i++) {
+            CDynode dn(CService(), COutPoint(GetRandHash(), 0), CPubKey(), CPubKey(), PROTOCOL_VERSION);
+            dnodeman.Add(dn);
+            vOutpoints.push_back(dn.outpoint);
+        }
+
+        // ranks are only known once the Dynode list is synced
+        CConnman connman(0x1337, 0x1337);
+        dynodeSync.Reset();
+        while (!dynodeSync.IsDynodeListSynced())
+            dynodeSync.SwitchToNextAsset(connman);
+    }
+
+    ~CRankBenchSetup()
+    {
+        dynodeSync.Reset();
+        dnodeman.Clear();
+        LOCK(cs_main);
+        chainActive.SetTip(NULL);
+    }
+};
+
+static void RankVotes(benchmark::State& state, int nHeights, bool fCached)
+{
+    CRankBenchSetup setup;
+    int nRequest = 0;
+    size_t nVoter = 0;
+    int64_t nVotes = 0;
+    int64_t nStart = GetTimeMicros();
+    while (state.KeepRunning()) {
+        // one lock request input, voted on by a full quorum
+        int nLockInputHeight = RANK_BENCH_HEIGHTS - nHeights + nRequest++ % nHeights;
+        for (int i = 0; i < COutPointLock::SIGNATURES_TOTAL; i++) {
+            int nRank;
+            if (!fCached)
+                dnodeman.InvalidateRankCache();
+            dnodeman.GetDynodeRank(setup.vOutpoints[nVoter++ % setup.vOutpoints.size()], nRank, nLockInputHeight, MIN_INSTANTSEND_PROTO_VERSION);
+        }
+        nVotes += COutPointLock::SIGNATURES_TOTAL;
+        state.counters["votes_per_second"] = nVotes * 1000000.0 / (GetTimeMicros() - nStart);
+    }
+}
+
+static void InstantSendVoteRanks(benchmark::State& state)
+{
+    RankVotes(state, 6, true);
+}
+
+static void InstantSendVoteRanks_Uncached(benchmark::State& state)
+{
+    RankVotes(state, 6, false);
+}
+
+BENCHMARK(InstantSendVoteRanks);
+BENCHMARK(InstantSendVoteRanks_Uncached);
@@ -0,0 +1,59 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "bdap/linkencryption.h"
+#include "dht/ed25519.h"
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+static const size_t LINK_DATA_SIZE = 300;
+
+static void LinkSharedPubKey(benchmark::State& state)
+{
+    CKeyEd25519 dhtKey;
+    CKeyEd25519 otherKey;
+    const std::vector<unsigned char> vchOtherPubKey = otherKey.GetPubKey();
+    while (state.KeepRunning())
+        GetLinkSharedPubKey(dhtKey, vchOtherPubKey);
+}
+
+static void LinkDataEncrypt(benchmark::State& state)
+{
+    CKeyEd25519 dhtKey;
+    CKeyEd25519 otherKey;
+    const std::vector<unsigned char> vchSharedPubKey = GetLinkSharedPubKey(dhtKey, otherKey.GetPubKey());
+    const std::vector<unsigned char> data(LINK_DATA_SIZE, 'x');
+    std::string strErrorMessage;
+    while (state.KeepRunning()) {
+        std::vector<unsigned char> dataEncrypted;
+        bool fResult = EncryptLinkData(dhtKey, vchSharedPubKey, data, dataEncrypted, strErrorMessage);
+        assert(fResult);
+    }
+}
+
+static void LinkDataDecrypt(benchmark::State& state)
+{
+    CKeyEd25519 dhtKey;
+    CKeyEd25519 otherKey;
+    const std::vector<unsigned char> vchSharedPubKey = GetLinkSharedPubKey(dhtKey, otherKey.GetPubKey());
+    const std::vector<unsigned char> data(LINK_DATA_SIZE, 'x');
+    std::vector<unsigned char> dataEncrypted;
+    std::string strErrorMessage;
+    bool fResult = EncryptLinkData(dhtKey, vchSharedPubKey, data, dataEncrypted, strErrorMessage);
+    assert(fResult);
+    const std::vector<unsigned char> vchPrivSeed = dhtKey.GetPrivSeedBytes();
+    while (state.KeepRunning()) {
+        std::vector<unsigned char> dataDecrypted, vchHash;
+        fResult = DecryptLinkData(vchPrivSeed, dataEncrypted, dataDecrypted, vchHash, strErrorMessage);
+        assert(fResult);
+    }
+}
+
+BENCHMARK(LinkSharedPubKey);
+BENCHMARK(LinkDataEncrypt);
+BENCHMARK(LinkDataDecrypt);
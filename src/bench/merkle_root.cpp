@@ -0,0 +1,36 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "consensus/merkle.h"
+#include "primitives/block.h"
+#include "primitives/transaction.h"
+
+static void MerkleRoot(benchmark::State& state, int nTransactions)
+{
+    CBlock block;
+    for (int i = 0; i < nTransactions; i++) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vout.resize(1);
+        tx.nLockTime = i; // distinct transaction hashes
+        block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+    }
+
+    while (state.KeepRunning()) {
+        bool fMutated;
+        BlockMerkleRoot(block, &fMutated);
+    }
+}
+
+static void BlockMerkleRoot_1(benchmark::State& state) { MerkleRoot(state, 1); }
+static void BlockMerkleRoot_100(benchmark::State& state) { MerkleRoot(state, 100); }
+static void BlockMerkleRoot_1000(benchmark::State& state) { MerkleRoot(state, 1000); }
+static void BlockMerkleRoot_10000(benchmark::State& state) { MerkleRoot(state, 10000); }
+
+BENCHMARK(BlockMerkleRoot_1);
+BENCHMARK(BlockMerkleRoot_100);
+BENCHMARK(BlockMerkleRoot_1000);
+BENCHMARK(BlockMerkleRoot_10000);
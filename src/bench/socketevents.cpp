@@ -0,0 +1,160 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "compat.h"
+#include "netbase.h"
+#include "util.h"
+
+#ifndef WIN32
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
+/**
+ * Measures the cost of one socket handler wake-up with many mostly idle peers:
+ * a single byte is written on one of N loopback TCP connections, the handler
+ * waits for readiness on all N and drains the ready socket. select() has to
+ * rebuild and scan its fd_set every pass, while epoll keeps the interest list
+ * in the kernel.
+ */
+
+static const int SELECT_CONNECTIONS = 400;  // must stay below FD_SETSIZE
+static const int EPOLL_CONNECTIONS = 4000;
+
+// Returns accepted (server side) / connecting (client side) socket pairs
+static std::vector<std::pair<SOCKET, SOCKET> > OpenLoopbackConnections(int nConnections)
+{
+    std::vector<std::pair<SOCKET, SOCKET> > vPairs;
+    int nFD = RaiseFileDescriptorLimit(2 * nConnections + 64);
+    nConnections = std::min(nConnections, (nFD - 64) / 2);
+
+    SOCKET hListen = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (hListen == INVALID_SOCKET ||
+        bind(hListen, (struct sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR ||
+        listen(hListen, SOMAXCONN) == SOCKET_ERROR ||
+        getsockname(hListen, (struct sockaddr*)&addr, &len) == SOCKET_ERROR) {
+        CloseSocket(hListen);
+        return vPairs;
+    }
+
+    for (int i = 0; i < nConnections; i++) {
+        SOCKET hClient = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (hClient == INVALID_SOCKET)
+            break;
+        if (connect(hClient, (struct sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR) {
+            CloseSocket(hClient);
+            break;
+        }
+        SOCKET hServer = accept(hListen, NULL, NULL);
+        if (hServer == INVALID_SOCKET) {
+            CloseSocket(hClient);
+            break;
+        }
+        vPairs.push_back(std::make_pair(hServer, hClient));
+    }
+    CloseSocket(hListen);
+    return vPairs;
+}
+
+static void CloseLoopbackConnections(std::vector<std::pair<SOCKET, SOCKET> >& vPairs)
+{
+    for (auto& pair : vPairs) {
+        CloseSocket(pair.first);
+        CloseSocket(pair.second);
+    }
+    vPairs.clear();
+}
+
+static void SocketEventsSelect(benchmark::State& state)
+{
+    std::vector<std::pair<SOCKET, SOCKET> > vPairs = OpenLoopbackConnections(SELECT_CONNECTIONS);
+    if (vPairs.empty())
+        return;
+
+    size_t nNext = 0;
+    char ch = 0;
+    while (state.KeepRunning()) {
+        const std::pair<SOCKET, SOCKET>& pair = vPairs[nNext++ % vPairs.size()];
+        send(pair.second, &ch, 1, MSG_NOSIGNAL);
+
+        fd_set fdsetRecv;
+        FD_ZERO(&fdsetRecv);
+        SOCKET hSocketMax = 0;
+        for (const auto& p : vPairs) {
+            FD_SET(p.first, &fdsetRecv);
+            hSocketMax = std::max(hSocketMax, p.first);
+        }
+        struct timeval timeout = {1, 0};
+        if (select(hSocketMax + 1, &fdsetRecv, NULL, NULL, &timeout) <= 0)
+            break;
+        for (const auto& p : vPairs) {
+            if (FD_ISSET(p.first, &fdsetRecv))
+                recv(p.first, &ch, 1, MSG_DONTWAIT);
+        }
+    }
+    CloseLoopbackConnections(vPairs);
+}
+
+#ifdef USE_EPOLL
+static void SocketEventsEpoll(benchmark::State& state, int nConnections)
+{
+    std::vector<std::pair<SOCKET, SOCKET> > vPairs = OpenLoopbackConnections(nConnections);
+    int epollfd = epoll_create1(EPOLL_CLOEXEC);
+    if (vPairs.empty() || epollfd == -1) {
+        CloseLoopbackConnections(vPairs);
+        return;
+    }
+    for (const auto& p : vPairs) {
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = p.first;
+        epoll_ctl(epollfd, EPOLL_CTL_ADD, p.first, &event);
+    }
+
+    size_t nNext = 0;
+    char ch = 0;
+    struct epoll_event events[64];
+    while (state.KeepRunning()) {
+        const std::pair<SOCKET, SOCKET>& pair = vPairs[nNext++ % vPairs.size()];
+        send(pair.second, &ch, 1, MSG_NOSIGNAL);
+
+        int nEvents = epoll_wait(epollfd, events, 64, 1000);
+        if (nEvents <= 0)
+            break;
+        for (int i = 0; i < nEvents; i++)
+            recv(events[i].data.fd, &ch, 1, MSG_DONTWAIT);
+    }
+    close(epollfd);
+    CloseLoopbackConnections(vPairs);
+}
+
+static void SocketEventsEpollSmall(benchmark::State& state)
+{
+    SocketEventsEpoll(state, SELECT_CONNECTIONS);
+}
+
+static void SocketEventsEpollLarge(benchmark::State& state)
+{
+    SocketEventsEpoll(state, EPOLL_CONNECTIONS);
+}
+
+BENCHMARK(SocketEventsEpollSmall);
+BENCHMARK(SocketEventsEpollLarge);
+#endif // USE_EPOLL
+
+BENCHMARK(SocketEventsSelect);
+
+#endif // WIN32
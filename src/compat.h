@@ -95,6 +95,14 @@ typedef u_int SOCKET;
 size_t strnlen(const char* start, size_t max_len);
 #endif // HAVE_DECL_STRNLEN
 
+// poll() and epoll are not bounded by FD_SETSIZE; prefer them where present
+#if defined(HAVE_POLL_H) && !defined(WIN32)
+#define USE_POLL
+#endif
+#if defined(HAVE_SYS_EPOLL_H) && !defined(WIN32)
+#define USE_EPOLL
+#endif
+
 bool static inline IsSelectableSocket(SOCKET s)
 {
 #ifdef WIN32
@@ -638,6 +638,16 @@ std::string SHA256AutoDetect()
     return ret;
 }
 
+std::string SHA256UseStandard()
+{
+    Transform = sha256::Transform;
+    TransformD64 = sha256::TransformD64;
+    TransformD64_2way = nullptr;
+    TransformD64_4way = nullptr;
+    TransformD64_8way = nullptr;
+    return "standard";
+}
+
 ////// SHA-256
 
 CSHA256::CSHA256() : bytes(0)
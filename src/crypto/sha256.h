@@ -31,6 +31,11 @@ public:
  */
 std::string SHA256AutoDetect();
 
+/** Revert to the generic C++ SHA256 implementation, e.g. to compare it
+ *  against the autodetected one. Returns the name of the implementation.
+ */
+std::string SHA256UseStandard();
+
 /** Compute multiple double-SHA256's of 64-byte blobs.
  *  output:  pointer to a blocks*32 byte output buffer
  *  input:   pointer to a blocks*64 byte input buffer
@@ -144,6 +144,7 @@ public:
     }
 
     void Next();
+    void Prev();
 
     template <typename K>
     bool GetKey(K& key)
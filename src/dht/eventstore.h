@@ -0,0 +1,113 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DYNAMIC_DHT_EVENTSTORE_H
+#define DYNAMIC_DHT_EVENTSTORE_H
+
+#include "hash.h"
+#include "random.h"
+#include "uint256.h"
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+/** SipHash of a DHT infohash, keys come from the network so they are salted */
+class SaltedInfoHashHasher
+{
+private:
+    const uint64_t k0, k1;
+
+public:
+    SaltedInfoHashHasher() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
+
+    size_t operator()(const uint160& hash) const
+    {
+        return CSipHasher(k0, k1).Write(hash.begin(), hash.size()).Finalize();
+    }
+};
+
+/**
+ * Latest event per key, bounded and ordered by arrival time.
+ *
+ * Events are indexed by key for lookups and queued in arrival order for
+ * expiry, so dropping old events only touches the events dropped. An event
+ * replacing the one of its key leaves the old queue entry behind, it is
+ * skipped once it reaches the front. The queue never grows beyond the
+ * capacity, which bounds the number of events kept as well.
+ */
+template <typename K, typename E, typename Hash = SaltedInfoHashHasher>
+class CDHTEventStore
+{
+private:
+    struct Entry {
+        E event;
+        int64_t nSequence;
+    };
+    struct Queued {
+        K key;
+        int64_t nTime;
+        int64_t nSequence;
+    };
+
+    const size_t nCapacity;
+    int64_t nSequence;
+    std::unordered_map<K, Entry, Hash> mapEvents;
+    std::deque<Queued> queue;
+
+    void PopFront()
+    {
+        const Queued& front = queue.front();
+        typename std::unordered_map<K, Entry, Hash>::iterator it = mapEvents.find(front.key);
+        if (it != mapEvents.end() && it->second.nSequence == front.nSequence)
+            mapEvents.erase(it);
+        queue.pop_front();
+    }
+
+public:
+    explicit CDHTEventStore(size_t nCapacityIn) : nCapacity(nCapacityIn), nSequence(0) {}
+
+    /** Stores event as the latest one for key, dropping the oldest event when full */
+    void Add(const K& key, const E& event, int64_t nTime)
+    {
+        nSequence++;
+        mapEvents.erase(key);
+        mapEvents.insert(std::make_pair(key, Entry{event, nSequence}));
+        queue.push_back(Queued{key, nTime, nSequence});
+        while (queue.size() > nCapacity)
+            PopFront();
+    }
+
+    /** Returns the latest event for key, or nullptr */
+    const E* Find(const K& key) const
+    {
+        typename std::unordered_map<K, Entry, Hash>::const_iterator it = mapEvents.find(key);
+        if (it == mapEvents.end())
+            return nullptr;
+        return &it->second.event;
+    }
+
+    /** Appends all events to vEvents, oldest first */
+    void GetAll(std::vector<E>& vEvents) const
+    {
+        for (const Queued& queued : queue) {
+            typename std::unordered_map<K, Entry, Hash>::const_iterator it = mapEvents.find(queued.key);
+            if (it != mapEvents.end() && it->second.nSequence == queued.nSequence)
+                vEvents.push_back(it->second.event);
+        }
+    }
+
+    /** Drops the events added before nTime */
+    void Expire(int64_t nTime)
+    {
+        while (!queue.empty() && queue.front().nTime < nTime)
+            PopFront();
+    }
+
+    size_t size() const { return mapEvents.size(); }
+};
+
+#endif // DYNAMIC_DHT_EVENTSTORE_H
@@ -7,12 +7,10 @@
 #include "dht/sessionevents.h"
 #include "chainparams.h"
 #include "dht/settings.h"
-#include "dynode-sync.h"
 #include "net.h"
-#include "spork.h"
+#include "ui_interface.h"
 #include "util.h"
 #include "utiltime.h" // for GetTimeMillis
-#include "validation.h"
 
 #include "libtorrent/hex.hpp" // for to_hex
 #include "libtorrent/alert_types.hpp"
@@ -25,7 +23,9 @@
 #include <cstdio> // for snprintf
 #include <cinttypes> // for PRId64 et.al.
 #include <cstdlib>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
 #include <thread>
 
 using namespace libtorrent;
@@ -35,6 +35,12 @@ static std::shared_ptr<std::thread> pDHTTorrentThread;
 static bool fShutdown;
 static bool fStarted;
 
+// Wakes the session thread to refresh its bootstrap nodes or to shut down
+static std::mutex cs_DHTSignal;
+static std::condition_variable condDHTSignal;
+static bool fRefreshPeers;
+static boost::signals2::connection connSyncProgress;
+
 session *pTorrentDHTSession = NULL;
 
 static void empty_public_key(std::array<char, 32>& public_key)
@@ -171,6 +177,18 @@ bool LoadSessionState(session* dhtSession)
     return true;
 }
 
+static void DHTSyncProgressChanged(double nSyncProgress)
+{
+    // The dynode list is complete once the additional data has synced
+    if (nSyncProgress < 1)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(cs_DHTSignal);
+        fRefreshPeers = true;
+    }
+    condDHTSignal.notify_all();
+}
+
 void static DHTTorrentNetwork(const CChainParams& chainparams, CConnman& connman)
 {
     LogPrint("dht", "DHTTorrentNetwork -- starting\n");
@@ -179,29 +197,36 @@ void static DHTTorrentNetwork(const CChainParams& chainparams, CConnman& connman
     
     try {
         CDHTSettings settings;
-        // Busy-wait for the network to come online so we get a full list of Dynodes
-        do {
-            bool fvNodesEmpty = connman.GetNodeCount(CConnman::CONNECTIONS_ALL) == 0;
-            if (!fvNodesEmpty && !IsInitialBlockDownload() && dynodeSync.IsSynced() && 
-                dynodeSync.IsBlockchainSynced() && sporkManager.IsSporkActive(SPORK_30_ACTIVATE_BDAP))
-                    break;
-
-            MilliSleep(1000);
-            if (fShutdown)
-                return;
-
-        } while (true);
-        
-        fStarted = true;
-        LogPrintf("DHTTorrentNetwork -- started\n");
-        // with current peers and Dynodes
+        // Start right away with the cached Dynodes and current peers, the routing
+        // table saved at shutdown gets us going while the chain is still syncing
         settings.LoadSettings();
         pTorrentDHTSession = settings.GetSession();
         
         if (!pTorrentDHTSession)
             throw std::runtime_error("DHT Torrent network bootstraping error.");
-        
+
+        if (!LoadSessionState(pTorrentDHTSession))
+            LogPrint("dht", "DHTTorrentNetwork -- No saved session state, bootstrapping from peer list.\n");
+
+        std::unique_lock<std::mutex> lock(cs_DHTSignal);
+        if (fShutdown)
+            return;
+
+        fStarted = true;
+        LogPrintf("DHTTorrentNetwork -- started\n");
         StartEventListener(pTorrentDHTSession);
+
+        // Refresh the bootstrap nodes each time the Dynode list finished syncing
+        while (true) {
+            condDHTSignal.wait(lock, []{ return fShutdown || fRefreshPeers; });
+            if (fShutdown)
+                break;
+            fRefreshPeers = false;
+            lock.unlock();
+            if (settings.RefreshPeerList())
+                LogPrintf("DHTTorrentNetwork -- bootstrap nodes refreshed from synced Dynode list\n");
+            lock.lock();
+        }
     }
     catch (const std::runtime_error& e)
     {
@@ -214,21 +239,27 @@ void static DHTTorrentNetwork(const CChainParams& chainparams, CConnman& connman
 void StopTorrentDHTNetwork()
 {
     LogPrintf("DHTTorrentNetwork -- StopTorrentDHTNetwork begin.\n");
-    fShutdown = true;
-    MilliSleep(300);
-    StopEventListener();
-    MilliSleep(30);
+    connSyncProgress.disconnect();
+    {
+        std::lock_guard<std::mutex> lock(cs_DHTSignal);
+        fShutdown = true;
+    }
+    condDHTSignal.notify_all();
     if (pDHTTorrentThread != NULL)
     {
         LogPrint("dht", "DHTTorrentNetwork -- StopTorrentDHTNetwork trying to stop.\n");
+        // The session thread starts the event listener, wait for it first
+        pDHTTorrentThread->join();
+        StopEventListener();
         if (fStarted) { 
+            // Keep the routing table for a warm start
+            SaveSessionState(pTorrentDHTSession);
             libtorrent::session_params params;
             params.settings.set_bool(settings_pack::enable_dht, false);
             params.settings.set_int(settings_pack::alert_mask, 0x0);
             pTorrentDHTSession->apply_settings(params.settings);
             pTorrentDHTSession->abort();
         }
-        pDHTTorrentThread->join();
         LogPrint("dht", "DHTTorrentNetwork -- StopTorrentDHTNetwork abort.\n");
     }
     else {
@@ -241,11 +272,13 @@ void StopTorrentDHTNetwork()
 void StartTorrentDHTNetwork(const CChainParams& chainparams, CConnman& connman)
 {
     LogPrint("dht", "DHTTorrentNetwork -- Log file = %s.\n", GetSessionStatePath());
-    fShutdown = false;
-    fStarted = false;
     if (pDHTTorrentThread != NULL)
          StopTorrentDHTNetwork();
 
+    fShutdown = false;
+    fStarted = false;
+    fRefreshPeers = false;
+    connSyncProgress = uiInterface.NotifyAdditionalDataSyncProgressChanged.connect(&DHTSyncProgressChanged);
     pDHTTorrentThread = std::make_shared<std::thread>(std::bind(&DHTTorrentNetwork, std::cref(chainparams), std::ref(connman)));
 }
 
@@ -4,6 +4,7 @@
 
 #include "dht/sessionevents.h"
 
+#include "dht/eventstore.h"
 #include "dht/operations.h"
 #include "dht/session.h"
 #include "sync.h" // for LOCK and CCriticalSection
@@ -19,14 +20,18 @@
 #include <libtorrent/session_status.hpp>
 #include <libtorrent/time.hpp>
 
+#include <algorithm>
+#include <deque>
 #include <map>
+#include <memory>
+#include <thread>
 
 using namespace libtorrent;
 
-typedef std::pair<int64_t, CEvent> EventPair;
-typedef std::multimap<int, EventPair> EventTypeMap;
-typedef std::multimap<std::string, CMutableGetEvent> DHTGetEventMap;
-typedef std::multimap<std::string, CMutablePutEvent> DHTPutEventMap;
+typedef std::deque<CEvent> EventList;
+typedef std::map<int, EventList> EventListMap;
+typedef CDHTEventStore<uint160, CMutableGetEvent> DHTGetEventMap;
+typedef CDHTEventStore<uint160, CMutablePutEvent> DHTPutEventMap;
 typedef std::map<int64_t, CPutRequest> DHTPutRequestMap;
 
 static CCriticalSection cs_EventMap;
@@ -35,9 +40,11 @@ static CCriticalSection cs_DHTPutEventMap;
 static CCriticalSection cs_DHTPutRequestMap;
 
 static bool fShutdown;
-static EventTypeMap m_EventTypeMap;
-static DHTGetEventMap m_DHTGetEventMap;
-static DHTPutEventMap m_DHTPutEventMap;
+static std::shared_ptr<std::thread> pDHTEventListenerThread;
+// Alerts in arrival order for each alert type, the oldest are dropped beyond DHT_MAX_EVENTS
+static EventListMap m_EventLists;
+static DHTGetEventMap m_DHTGetEventMap(DHT_MAX_EVENTS);
+static DHTPutEventMap m_DHTPutEventMap(DHT_MAX_EVENTS);
 static DHTPutRequestMap m_DHTPutRequestMap;
 
 CEvent::CEvent(std::string _message, int _type, uint32_t _category, std::string _what)
@@ -55,15 +62,17 @@ std::string CEvent::ToString() const
         Message(), Type(), Category(), What(), Timestamp());
 }
 
-static std::string GetInfoHash(const std::string pubkey, const std::string salt)
+static uint160 GetInfoHash(const std::string pubkey, const std::string salt)
 {
     std::array<char, 32> arrPubKey;
     aux::from_hex(pubkey, arrPubKey.data());
     dht::public_key pk;
     pk.bytes = arrPubKey;
     const sha1_hash infoHash = dht::item_target_id(salt, pk);
-    
-    return aux::to_hex(infoHash.to_string());
+
+    uint160 hash;
+    std::copy(infoHash.begin(), infoHash.end(), hash.begin());
+    return hash;
 }
 
 CMutableGetEvent::CMutableGetEvent() : CEvent()
@@ -108,51 +117,34 @@ void CPutRequest::DHTPut()
     SubmitPutDHTMutableData(key.GetDHTPubKey(), key.GetDHTPrivKey(), salt, sequence, value.c_str());
 }
 
-static void AddToDHTGetEventMap(const MutableKey& mKey, const CMutableGetEvent& event)
+static void AddToDHTGetEventMap(const CMutableGetEvent& event)
 {
     LOCK(cs_DHTGetEventMap);
-    std::string infoHash = GetInfoHash(mKey.first, mKey.second);
-    std::multimap<std::string, CMutableGetEvent>::iterator iMutableEvent = m_DHTGetEventMap.find(infoHash);
-    if (iMutableEvent == m_DHTGetEventMap.end()) {
-        // event not found. Add a new entry to DHT event map
-        LogPrint("dht", "AddToDHTGetEventMap Not found -- infohash = %s, pubkey = %s, salt = %s\n", infoHash, mKey.first, mKey.second);
-        m_DHTGetEventMap.insert(std::make_pair(infoHash, event));
-    }
-    else {
-        // event found. Update entry in DHT event map
-        LogPrint("dht", "AddToDHTGetEventMap Found -- infohash = %s, pubkey = %s, salt = %s\n", infoHash, mKey.first, mKey.second);
-        iMutableEvent->second = event;
-    }
+    LogPrint("dht", "AddToDHTGetEventMap -- infohash = %s, pubkey = %s, salt = %s\n", event.InfoHash(), event.PublicKey(), event.Salt());
+    m_DHTGetEventMap.Add(event.InfoHashKey(), event, event.Timestamp());
 }
 
-static void AddToDHTPutEventMap(const MutableKey& mKey, const CMutablePutEvent& event)
+static void AddToDHTPutEventMap(const CMutablePutEvent& event)
 {
     LOCK(cs_DHTPutEventMap);
-    std::string infoHash = GetInfoHash(mKey.first, mKey.second);
-    std::multimap<std::string, CMutablePutEvent>::iterator iMutableEvent = m_DHTPutEventMap.find(infoHash);
-    if (iMutableEvent == m_DHTPutEventMap.end()) {
-        // event not found. Add a new entry to DHT event map
-        LogPrint("dht", "AddToDHTPutEventMap Not found -- infohash = %s, pubkey = %s, salt = %s\n", infoHash, mKey.first, mKey.second);
-        m_DHTPutEventMap.insert(std::make_pair(infoHash, event));
-    }
-    else {
-        // event found. Update entry in DHT event map
-        LogPrint("dht", "AddToDHTPutEventMap Found -- infohash = %s, pubkey = %s, salt = %s\n", infoHash, mKey.first, mKey.second);
-        iMutableEvent->second = event;
-    }
+    LogPrint("dht", "AddToDHTPutEventMap -- infohash = %s, pubkey = %s, salt = %s\n", event.InfoHash(), event.PublicKey(), event.Salt());
+    m_DHTPutEventMap.Add(event.InfoHashKey(), event, event.Timestamp());
 }
 
-static void AddToEventMap(const int type, const CEvent& event)
+static void AddToEventMap(const CEvent& event)
 {
     LOCK(cs_EventMap);
-    m_EventTypeMap.insert(std::make_pair(type, std::make_pair(event.Timestamp(), event)));
+    // Frequent alert types can't push rare ones like the bootstrap alert out
+    EventList& events = m_EventLists[event.Type()];
+    events.push_back(event);
+    if (events.size() > DHT_MAX_EVENTS)
+        events.pop_front();
 }
 
 static void DHTEventListener(session* dhtSession)
 {
     SetThreadPriority(THREAD_PRIORITY_LOWEST);
     RenameThread("dht-events");
-    unsigned int counter = 0;
     while(!fShutdown)
     {
         if (!dhtSession->is_dht_running()) {
@@ -173,17 +165,20 @@ static void DHTEventListener(session* dhtSession)
         dhtSession->wait_for_alert(seconds(1));
         std::vector<alert*> alerts;
         dhtSession->pop_alerts(&alerts);
+        // Formatting the other alert messages is only worth it when they get logged,
+        // get and put events keep theirs for the dhtgetmessages and dhtputmessages RPCs
+        const bool fAlertMessages = LogAcceptCategory("dht");
         for (std::vector<alert*>::iterator iAlert = alerts.begin(), end(alerts.end()); iAlert != end; ++iAlert) {
             if ((*iAlert) == nullptr)
                 continue;
 
             const uint32_t iAlertCategory = (*iAlert)->category();
-            const std::string strAlertMessage = (*iAlert)->message();
             const int iAlertType = (*iAlert)->type();
+            const bool fMutableEvent = iAlertType == DHT_GET_ALERT_TYPE_CODE || iAlertType == DHT_PUT_ALERT_TYPE_CODE;
+            const std::string strAlertMessage = (fAlertMessages || fMutableEvent) ? (*iAlert)->message() : std::string();
             const std::string strAlertTypeName = alert_name(iAlertType);
-            if (iAlertType == DHT_GET_ALERT_TYPE_CODE || iAlertType == DHT_PUT_ALERT_TYPE_CODE) {
+            if (fMutableEvent) {
                 LogPrint("dht", "DHTEventListener -- DHT Alert Message = %s, Alert Type =%s, Alert Category = %u\n", strAlertMessage, strAlertTypeName, iAlertCategory);
-                MutableKey mKey;
                 if (iAlertType == DHT_GET_ALERT_TYPE_CODE) {
                     // DHT Get Mutable Event
                     dht_mutable_item_alert* pGet = alert_cast<dht_mutable_item_alert>((*iAlert));
@@ -193,8 +188,7 @@ static void DHTEventListener(session* dhtSession)
                     const CMutableGetEvent event(strAlertMessage, iAlertType, iAlertCategory, strAlertTypeName, 
                           aux::to_hex(pGet->key), pGet->salt, pGet->seq, pGet->item.to_string(), aux::to_hex(pGet->signature), pGet->authoritative);
 
-                    mKey = std::make_pair(event.PublicKey(), event.Salt());
-                    AddToDHTGetEventMap(mKey, event);
+                    AddToDHTGetEventMap(event);
                 }
                 else if (iAlertType == DHT_PUT_ALERT_TYPE_CODE) {
                     // DHT Put Mutable Event
@@ -206,8 +200,7 @@ static void DHTEventListener(session* dhtSession)
                     const CMutablePutEvent event(strAlertMessage, iAlertType, iAlertCategory, strAlertTypeName, 
                           aux::to_hex(pPut->public_key), pPut->salt, pPut->seq, aux::to_hex(pPut->signature), pPut->num_success);
 
-                    mKey = std::make_pair(event.PublicKey(), event.Salt());
-                    AddToDHTPutEventMap(mKey, event);
+                    AddToDHTPutEventMap(event);
                 }
             }
             else if (iAlertType == DHT_STATS_ALERT_TYPE_CODE) {
@@ -217,64 +210,71 @@ static void DHTEventListener(session* dhtSession)
             }
             else {
                 const CEvent event(strAlertMessage, iAlertType, iAlertCategory, strAlertTypeName);
-                AddToEventMap(iAlertType, event);
+                AddToEventMap(event);
             }
         }
         if (fShutdown)
             return;
         
-        counter++;
-        if (counter % 60 == 0) {
-            LogPrint("dht", "DHTEventListener -- Before CleanUpEventMap. counter = %u\n", counter);
-            CleanUpEventMap(300000);
-        }
+        CleanUpEventMap();
     }
 }
 
 void CleanUpEventMap(uint32_t timeout)
 {
-    unsigned int deleted = 0;
-    unsigned int counter = 0;
-    int64_t iTime = GetTimeMillis();
-    LOCK(cs_EventMap);
-    for (auto it = m_EventTypeMap.begin(); it != m_EventTypeMap.end(); ) {
-        CEvent event = it->second.second;
-        if ((iTime - event.Timestamp()) > timeout) {
-            it = m_EventTypeMap.erase(it);
-            deleted++;
-        }
-        else {
-            ++it;
+    // Events are kept in arrival order, only the expired ones are touched
+    const int64_t nExpireTime = GetTimeMillis() - timeout;
+    {
+        LOCK(cs_EventMap);
+        for (EventListMap::iterator it = m_EventLists.begin(); it != m_EventLists.end();) {
+            EventList& events = it->second;
+            while (!events.empty() && events.front().Timestamp() < nExpireTime)
+                events.pop_front();
+            if (events.empty())
+                it = m_EventLists.erase(it);
+            else
+                ++it;
         }
-        counter++;
     }
-    LogPrint("dht", "DHTEventListener -- CleanUpEventMap. deleted = %u, count = %u\n", deleted, counter);
+    {
+        LOCK(cs_DHTGetEventMap);
+        m_DHTGetEventMap.Expire(nExpireTime);
+    }
+    {
+        LOCK(cs_DHTPutEventMap);
+        m_DHTPutEventMap.Expire(nExpireTime);
+    }
 }
 
 void StopEventListener()
 {
 	fShutdown = true;
     LogPrint("dht", "DHTEventListener -- stopping.\n");
-    MilliSleep(2100);
+    if (pDHTEventListenerThread) {
+        pDHTEventListenerThread->join();
+        pDHTEventListenerThread = nullptr;
+    }
 }
 
 void StartEventListener(session* dhtSession)
 {
     LogPrint("dht", "StartEventListener -- start\n");
     fShutdown = false;
-    DHTEventListener(dhtSession);
+    pDHTEventListenerThread = std::make_shared<std::thread>(std::bind(&DHTEventListener, dhtSession));
 }
 
 bool GetLastTypeEvent(const int& type, const int64_t& startTime, std::vector<CEvent>& events)
 {
-    //LOCK(cs_EventMap);
-    LogPrint("dht", "GetLastTypeEvent -- m_EventTypeMap.size = %u, type = %u.\n", m_EventTypeMap.size(), type);
-    std::multimap<int, EventPair>::iterator iEvents = m_EventTypeMap.find(type);
-    while (iEvents != m_EventTypeMap.end()) {
-        if (iEvents->second.first >= startTime) {
-            events.push_back(iEvents->second.second);
-        }
-        iEvents++;
+    LOCK(cs_EventMap);
+    EventListMap::const_iterator itList = m_EventLists.find(type);
+    LogPrint("dht", "GetLastTypeEvent -- m_EventLists.size = %u, type = %u.\n", m_EventLists.size(), type);
+    if (itList != m_EventLists.end()) {
+        // Newest first, stop at the first event before startTime
+        const EventList& typeEvents = itList->second;
+        const size_t nFirst = events.size();
+        for (EventList::const_reverse_iterator it = typeEvents.rbegin(); it != typeEvents.rend() && it->Timestamp() >= startTime; ++it)
+            events.push_back(*it);
+        std::reverse(events.begin() + nFirst, events.end());
     }
     LogPrint("dht", "GetLastTypeEvent -- events.size() = %u\n", events.size());
     return events.size() > 0;
@@ -282,28 +282,26 @@ bool GetLastTypeEvent(const int& type, const int64_t& startTime, std::vector<CEv
 
 bool FindDHTGetEvent(const MutableKey& mKey, CMutableGetEvent& event)
 {
-    //LOCK(cs_DHTGetEventMap);
-    std::string infoHash = GetInfoHash(mKey.first, mKey.second);
-    std::multimap<std::string, CMutableGetEvent>::iterator iMutableEvent = m_DHTGetEventMap.find(infoHash);
-    if (iMutableEvent != m_DHTGetEventMap.end()) {
+    LOCK(cs_DHTGetEventMap);
+    const CMutableGetEvent* pEvent = m_DHTGetEventMap.Find(GetInfoHash(mKey.first, mKey.second));
+    if (pEvent) {
         // event found.
-        LogPrint("dht", "FindDHTGetEvent -- Found, infoHash = %s, pubkey = %s, salt = %s\n", infoHash, mKey.first, mKey.second);
-        event = iMutableEvent->second;
+        LogPrint("dht", "FindDHTGetEvent -- Found, infoHash = %s, pubkey = %s, salt = %s\n", pEvent->InfoHash(), mKey.first, mKey.second);
+        event = *pEvent;
         return true;
     }
-    LogPrint("dht", "FindDHTGetEvent -- Not found, infoHash = %s, pubkey = %s, salt = %s\n", infoHash, mKey.first, mKey.second);
+    LogPrint("dht", "FindDHTGetEvent -- Not found, pubkey = %s, salt = %s\n", mKey.first, mKey.second);
     return false;
 }
 
 bool FindDHTPutEvent(const MutableKey& mKey, CMutablePutEvent& event)
 {
-    //LOCK(cs_DHTPutEventMap);
-    std::string infoHash = GetInfoHash(mKey.first, mKey.second);
-    std::multimap<std::string, CMutablePutEvent>::iterator iMutableEvent = m_DHTPutEventMap.find(infoHash);
-    if (iMutableEvent != m_DHTPutEventMap.end()) {
+    LOCK(cs_DHTPutEventMap);
+    const CMutablePutEvent* pEvent = m_DHTPutEventMap.Find(GetInfoHash(mKey.first, mKey.second));
+    if (pEvent) {
         // event found.
-        LogPrint("dht", "FindDHTPutEvent -- Found, infoHash = %s, pubkey = %s, salt = %s\n", infoHash, mKey.first, mKey.second);
-        event = iMutableEvent->second;
+        LogPrint("dht", "FindDHTPutEvent -- Found, infoHash = %s, pubkey = %s, salt = %s\n", pEvent->InfoHash(), mKey.first, mKey.second);
+        event = *pEvent;
         return true;
     }
     return false;
@@ -311,19 +309,15 @@ bool FindDHTPutEvent(const MutableKey& mKey, CMutablePutEvent& event)
 
 bool GetAllDHTPutEvents(std::vector<CMutablePutEvent>& vchPutEvents)
 {
-    //LOCK(cs_DHTPutEventMap);
-    for (std::multimap<std::string, CMutablePutEvent>::iterator it=m_DHTPutEventMap.begin(); it!=m_DHTPutEventMap.end(); ++it) {
-        vchPutEvents.push_back(it->second);
-    }
+    LOCK(cs_DHTPutEventMap);
+    m_DHTPutEventMap.GetAll(vchPutEvents);
     return true;
 }
 
 bool GetAllDHTGetEvents(std::vector<CMutableGetEvent>& vchGetEvents)
 {
-    //LOCK(cs_DHTGetEventMap);
-    for (std::multimap<std::string, CMutableGetEvent>::iterator it=m_DHTGetEventMap.begin(); it!=m_DHTGetEventMap.end(); ++it) {
-        vchGetEvents.push_back(it->second);
-    }
+    LOCK(cs_DHTGetEventMap);
+    m_DHTGetEventMap.GetAll(vchGetEvents);
     return true;
 }
 
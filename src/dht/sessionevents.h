@@ -6,6 +6,8 @@
 #define DYNAMIC_DHT_SESSION_EVENTS_H
 
 #include "dht/ed25519.h"
+#include "uint256.h"
+#include "utilstrencodings.h"
 
 #include <string>
 #include <vector>
@@ -54,7 +56,7 @@ private:
     std::string value;
     std::string signature;
     bool authoritative;
-    std::string infohash;
+    uint160 infohash;
 
 public:
     CMutableGetEvent();
@@ -67,7 +69,8 @@ public:
     std::string Value() const { return value; }
     std::string Signature() const { return signature; }
     bool Authoritative() const { return authoritative; }
-    std::string InfoHash() const { return infohash; }
+    std::string InfoHash() const { return HexStr(infohash.begin(), infohash.end()); }
+    const uint160& InfoHashKey() const { return infohash; }
 
     inline friend bool operator==(const CMutableGetEvent& a, const CMutableGetEvent& b) {
         return (a.ToString() == b.ToString() && a.PublicKey() == b.PublicKey() && a.Salt() == b.Salt() && a.SequenceNumber() == b.SequenceNumber());
@@ -78,13 +81,14 @@ public:
     }
 
     inline CMutableGetEvent operator=(const CMutableGetEvent& b) {
+        CEvent::operator=(b);
         pubkey = b.PublicKey();
         salt = b.Salt();
         seq = b.SequenceNumber();
         value = b.Value();
         authoritative = b.Authoritative();
         signature = b.Signature();
-        infohash = b.InfoHash();
+        infohash = b.InfoHashKey();
         return *this;
     }
 };
@@ -96,7 +100,7 @@ private:
     std::int64_t seq;
     std::string signature;
     std::uint32_t success_count;
-    std::string infohash;
+    uint160 infohash;
 
 public:
     CMutablePutEvent();
@@ -108,7 +112,8 @@ public:
     std::int64_t SequenceNumber() const { return seq; }
     std::string Signature() const { return signature; }
     std::uint32_t SuccessCount() const { return success_count; }
-    std::string InfoHash() const  { return infohash; }
+    std::string InfoHash() const { return HexStr(infohash.begin(), infohash.end()); }
+    const uint160& InfoHashKey() const { return infohash; }
 
     inline friend bool operator==(const CMutablePutEvent& a, const CMutablePutEvent& b) {
         return (a.ToString() == b.ToString() && a.PublicKey() == b.PublicKey() && a.Salt() == b.Salt() && a.SequenceNumber() == b.SequenceNumber());
@@ -119,12 +124,13 @@ public:
     }
 
     inline CMutablePutEvent operator=(const CMutablePutEvent& b) {
+        CEvent::operator=(b);
         pubkey = b.PublicKey();
         salt = b.Salt();
         seq = b.SequenceNumber();
         signature = b.Signature();
         success_count = b.SuccessCount();
-        infohash = b.InfoHash();
+        infohash = b.InfoHashKey();
         return *this;
     }
 };
@@ -158,9 +164,14 @@ public:
     }
 };
 
+/** Events kept for each DHT alert type, and in each of the get and put event stores */
+static constexpr size_t DHT_MAX_EVENTS = 10000;
+
 void CleanUpEventMap(uint32_t timeout = 300000);  //default to 5 minutes.
 
+/** Stop the DHT event listener thread and wait for it to exit */
 void StopEventListener();
+/** Start the DHT event listener on its own thread */
 void StartEventListener(libtorrent::session* dhtSession);
 
 bool GetLastTypeEvent(const int& type, const int64_t& startTime, std::vector<CEvent>& events);
@@ -18,6 +18,7 @@ using namespace libtorrent;
 
 CDHTSettings::CDHTSettings()
 {
+    ses = nullptr;
     user_agent = "Dynamic v" + FormatFullVersion();
     // Uses UDP ports 33307, 33317, 33327, 33337, 33347 and 33357
     listen_interfaces = "0.0.0.0:33307,[::]:33307,0.0.0.0:33317,[::]:33317"
@@ -80,6 +81,20 @@ void CDHTSettings::LoadPeerList()
     LogPrintf("CDHTSettings::LoadPeerList -- dht_bootstrap_nodes = %s\n", dht_bootstrap_nodes);
 }
 
+bool CDHTSettings::RefreshPeerList()
+{
+    const std::string strPrevious = dht_bootstrap_nodes;
+    LoadPeerList();
+    if (!ses || dht_bootstrap_nodes == strPrevious)
+        return false;
+
+    params.settings.set_str(settings_pack::dht_bootstrap_nodes, dht_bootstrap_nodes);
+    settings_pack pack;
+    pack.set_str(settings_pack::dht_bootstrap_nodes, dht_bootstrap_nodes);
+    ses->apply_settings(pack);
+    return true;
+}
+
 void CDHTSettings::LoadSettings()
 {
     LoadPeerList();
@@ -20,6 +20,8 @@ public:
     CDHTSettings();
 
     void LoadSettings();
+    // Rebuilds the bootstrap nodes from the current dynode list and peers
+    bool RefreshPeerList();
 
     libtorrent::settings_pack GetSettingsPack() const { return params.settings; }
     libtorrent::dht_settings GetDHTSettings() const { return params.dht_settings; }
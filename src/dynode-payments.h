@@ -30,6 +30,7 @@ static const int MIN_DYNODE_PAYMENT_PROTO_VERSION_2 = 71000;
 extern CCriticalSection cs_vecPayees;
 extern CCriticalSection cs_mapDynodeBlocks;
 extern CCriticalSection cs_mapDynodePayeeVotes;
+extern CCriticalSection cs_mapDynodePaymentVotes;
 
 extern CDynodePayments dnpayments;
 
@@ -202,6 +203,7 @@ public:
     template <typename Stream, typename Operation>
     inline void SerializationOp(Stream& s, Operation ser_action)
     {
+        LOCK2(cs_mapDynodeBlocks, cs_mapDynodePaymentVotes);
         READWRITE(mapDynodePaymentVotes);
         READWRITE(mapDynodeBlocks);
     }
@@ -35,6 +35,8 @@ void CDynodeSync::Reset()
     nTimeAssetSyncStarted = GetTime();
     nTimeLastBumped = GetTime();
     nTimeLastFailure = 0;
+    LOCK(cs);
+    mapAssetPeers.clear();
 }
 
 void CDynodeSync::BumpAssetLastTime(const std::string strFuncName)
@@ -112,6 +114,10 @@ void CDynodeSync::SwitchToNextAsset(CConnman& connman)
     }
     nRequestedDynodeAttempt = 0;
     nTimeAssetSyncStarted = GetTime();
+    {
+        LOCK(cs);
+        mapAssetPeers.clear();
+    }
     BumpAssetLastTime("CDynodeSync::SwitchToNextAsset");
 }
 
@@ -150,6 +156,18 @@ void CDynodeSync::ProcessMessage(CNode* pfrom, const std::string& strCommand, CD
         vRecv >> nItemID >> nCount;
 
         LogPrint("dynode", "SYNCSTATUSCOUNT -- got inventory count: nItemID=%d  nCount=%d  peer=%d\n", nItemID, nCount, pfrom->id);
+
+        // the vote count is the last thing a peer sends in reply to a governance sync request
+        int nAsset = nItemID == DYNODE_SYNC_GOVOBJ_VOTE ? DYNODE_SYNC_GOVERNANCE : nItemID;
+        if (!fParallelSync || nAsset != nRequestedDynodeAssets)
+            return;
+
+        LOCK(cs);
+        auto it = mapAssetPeers.find(pfrom->id);
+        if (it != mapAssetPeers.end()) {
+            it->second.fReported = true;
+            it->second.nCount = nCount;
+        }
     }
 }
 
@@ -222,12 +240,7 @@ void CDynodeSync::ProcessTick(CConnman& connman)
             } else if (nRequestedDynodeAttempt < 4) {
                 dnodeman.PsegUpdate(pnode, connman);
             } else if (nRequestedDynodeAttempt < 6) {
-                //sync payment votes
-                if (pnode->nVersion == 70900) {
-                    connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DYNODEPAYMENTSYNC, dnpayments.GetStorageLimit())); //sync payment votes
-                } else {
-                    connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DYNODEPAYMENTSYNC)); //sync payment votes
-                }
+                SendPaymentSyncRequest(pnode, connman); //sync payment votes
                 SendGovernanceSyncRequest(pnode, connman);
             } else {
                 nRequestedDynodeAssets = DYNODE_SYNC_FINISHED;
@@ -273,6 +286,10 @@ void CDynodeSync::ProcessTick(CConnman& connman)
                 }
             }
 
+            // the remaining assets are requested and tracked by ProcessParallelTick
+            if (fParallelSync)
+                continue;
+
             // DNLIST : SYNC DYNODE LIST FROM OTHER CONNECTED CLIENTS
 
             if (nRequestedDynodeAssets == DYNODE_SYNC_LIST) {
@@ -358,12 +375,8 @@ void CDynodeSync::ProcessTick(CConnman& connman)
                     continue;
                 nRequestedDynodeAttempt++;
 
-                // ask node for all payment votes it has (new nodes will only return votes for future payments)
-                if (pnode->nVersion == 70900) {
-                    connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DYNODEPAYMENTSYNC, dnpayments.GetStorageLimit()));
-                } else {
-                    connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DYNODEPAYMENTSYNC));
-                } // ask node for missing pieces only (old nodes will not be asked)
+                SendPaymentSyncRequest(pnode, connman);
+                // ask node for missing pieces only (old nodes will not be asked)
                 dnpayments.RequestLowDataPaymentBlocks(pnode, connman);
 
                 connman.ReleaseNodeVector(vNodesCopy);
@@ -438,6 +451,182 @@ void CDynodeSync::ProcessTick(CConnman& connman)
     connman.ReleaseNodeVector(vNodesCopy);
 }
 
+void CDynodeSync::ProcessParallelTick(CConnman& connman)
+{
+    if (!fParallelSync || ShutdownRequested() || IsFailed() || IsSynced())
+        return;
+    // QUICK MODE (REGTEST ONLY!) is handled by ProcessTick
+    if (Params().NetworkIDString() == CBaseChainParams::REGTEST)
+        return;
+    if (nRequestedDynodeAssets < DYNODE_SYNC_WAITING)
+        return;
+
+    std::vector<CNode*> vNodesCopy = connman.CopyNodeVector(CConnman::FullyConnectedOnly);
+
+    if (nRequestedDynodeAssets == DYNODE_SYNC_WAITING) {
+        // No need to wait for more blocks when none of the peers we can sync from started above our tip
+        int nHeight;
+        {
+            LOCK(cs_main);
+            nHeight = chainActive.Height();
+        }
+        int nPeers = 0;
+        bool fPeerAhead = false;
+        for (auto& pnode : vNodesCopy) {
+            if (!IsSyncPeer(pnode))
+                continue;
+            nPeers++;
+            if (pnode->nStartingHeight > nHeight)
+                fPeerAhead = true;
+        }
+        if (nPeers > 0 && !fPeerAhead) {
+            LogPrint("dynode", "CDynodeSync::ProcessParallelTick -- %d peers are not ahead of height %d\n", nPeers, nHeight);
+            SwitchToNextAsset(connman);
+        }
+        connman.ReleaseNodeVector(vNodesCopy);
+        return;
+    }
+
+    if (IsAssetComplete(vNodesCopy, connman)) {
+        LogPrint("dynode", "CDynodeSync::ProcessParallelTick -- %s complete\n", GetAssetName());
+        SwitchToNextAsset(connman);
+    }
+
+    // keep DYNODE_SYNC_PARALLEL_PEERS requests in flight, replacing peers which went away
+    int nInFlight = 0;
+    {
+        LOCK(cs);
+        for (auto& pnode : vNodesCopy) {
+            if (mapAssetPeers.count(pnode->id))
+                nInFlight++;
+        }
+    }
+    for (auto& pnode : vNodesCopy) {
+        if (nInFlight >= DYNODE_SYNC_PARALLEL_PEERS)
+            break;
+        if (!IsSyncPeer(pnode) || !RequestAsset(pnode, connman))
+            continue;
+        nInFlight++;
+        nRequestedDynodeAttempt++;
+        LOCK(cs);
+        mapAssetPeers[pnode->id] = CSyncPeerState{GetTime(), false, 0};
+        LogPrint("dynode", "CDynodeSync::ProcessParallelTick -- requested %s from peer %d\n", GetAssetName(), pnode->id);
+    }
+
+    connman.ReleaseNodeVector(vNodesCopy);
+}
+
+bool CDynodeSync::IsSyncPeer(CNode* pnode)
+{
+    // same rules as ProcessTick: temporary dynode connections are unreliable,
+    // and peers we fully synced from recently are about to be disconnected
+    return !pnode->fDynode && !(fDynodeMode && pnode->fInbound) &&
+           !netfulfilledman.HasFulfilledRequest(pnode->addr, "full-sync");
+}
+
+bool CDynodeSync::RequestAsset(CNode* pnode, CConnman& connman)
+{
+    switch (nRequestedDynodeAssets) {
+    case DYNODE_SYNC_LIST:
+        if (netfulfilledman.HasFulfilledRequest(pnode->addr, "dynode-list-sync"))
+            return false;
+        netfulfilledman.AddFulfilledRequest(pnode->addr, "dynode-list-sync");
+        if (pnode->nVersion < dnpayments.GetMinDynodePaymentsProto())
+            return false;
+        dnodeman.PsegUpdate(pnode, connman);
+        return true;
+    case DYNODE_SYNC_DNW:
+        if (netfulfilledman.HasFulfilledRequest(pnode->addr, "dynode-payment-sync"))
+            return false;
+        netfulfilledman.AddFulfilledRequest(pnode->addr, "dynode-payment-sync");
+        if (pnode->nVersion < dnpayments.GetMinDynodePaymentsProto())
+            return false;
+        SendPaymentSyncRequest(pnode, connman);
+        dnpayments.RequestLowDataPaymentBlocks(pnode, connman);
+        return true;
+    case DYNODE_SYNC_GOVERNANCE:
+        if (netfulfilledman.HasFulfilledRequest(pnode->addr, "governance-sync"))
+            return false;
+        netfulfilledman.AddFulfilledRequest(pnode->addr, "governance-sync");
+        if (pnode->nVersion < MIN_GOVERNANCE_PEER_PROTO_VERSION)
+            return false;
+        SendGovernanceSyncRequest(pnode, connman);
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool CDynodeSync::IsAssetComplete(const std::vector<CNode*>& vNodesCopy, CConnman& connman)
+{
+    int nReported = 0;
+    int nWaiting = 0;
+    int nExpected = 0;
+    int64_t nNow = GetTime();
+    {
+        LOCK(cs);
+        for (auto& pnode : vNodesCopy) {
+            auto it = mapAssetPeers.find(pnode->id);
+            if (it == mapAssetPeers.end())
+                continue;
+            if (it->second.fReported) {
+                nReported++;
+                nExpected = std::max(nExpected, it->second.nCount);
+            } else if (nNow - it->second.nTimeRequested <= DYNODE_SYNC_TIMEOUT_SECONDS) {
+                nWaiting++;
+            }
+        }
+    }
+
+    if (nReported == 0) {
+        // nobody answered, fall back to the timeouts of the sequential sync
+        if (nNow - nTimeLastBumped > DYNODE_SYNC_TIMEOUT_SECONDS) {
+            if (nRequestedDynodeAttempt == 0 && nRequestedDynodeAssets != DYNODE_SYNC_GOVERNANCE) {
+                LogPrintf("CDynodeSync::IsAssetComplete -- ERROR: failed to sync %s\n", GetAssetName());
+                Fail();
+                return false;
+            }
+            return true;
+        }
+        return false;
+    }
+    if (nWaiting > 0)
+        return false;
+
+    // every peer reported what it sent us, finish once it has all arrived
+    bool fSettled = nNow - nTimeLastBumped >= DYNODE_SYNC_PARALLEL_SETTLE_SECONDS;
+    switch (nRequestedDynodeAssets) {
+    case DYNODE_SYNC_LIST:
+        return fSettled || (int)dnodeman.size() >= nExpected;
+    case DYNODE_SYNC_DNW:
+        return fSettled || dnpayments.IsEnoughData();
+    case DYNODE_SYNC_GOVERNANCE: {
+        // votes are requested per object, spread over all peers
+        std::vector<CNode*> vSyncNodes;
+        for (auto& pnode : vNodesCopy) {
+            if (IsSyncPeer(pnode))
+                vSyncNodes.push_back(pnode);
+        }
+        int nObjsLeftToAsk = governance.RequestGovernanceObjectVotes(vSyncNodes, connman);
+        return fSettled && nObjsLeftToAsk <= 0;
+    }
+    default:
+        return false;
+    }
+}
+
+void CDynodeSync::SendPaymentSyncRequest(CNode* pnode, CConnman& connman)
+{
+    CNetMsgMaker msgMaker(pnode->GetSendVersion());
+
+    // ask node for all payment votes it has (new nodes will only return votes for future payments)
+    if (pnode->nVersion == 70900) {
+        connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DYNODEPAYMENTSYNC, dnpayments.GetStorageLimit()));
+    } else {
+        connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DYNODEPAYMENTSYNC));
+    }
+}
+
 void CDynodeSync::SendGovernanceSyncRequest(CNode* pnode, CConnman& connman)
 {
     CNetMsgMaker msgMaker(pnode->GetSendVersion());
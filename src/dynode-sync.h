@@ -8,6 +8,7 @@
 
 #include "chain.h"
 #include "net.h"
+#include "sync.h"
 
 #include <univalue.h>
 
@@ -28,6 +29,13 @@ static const int DYNODE_SYNC_TIMEOUT_SECONDS = 25;
 
 static const int DYNODE_SYNC_ENOUGH_PEERS = 10;
 
+static const bool DEFAULT_PARALLEL_SYNC = false;
+// parallel sync: how often progress is checked, how many peers each asset is requested from at once
+// and how long no new data has to arrive after the peers reported their counts
+static const int DYNODE_SYNC_PARALLEL_TICK_SECONDS = 1;
+static const int DYNODE_SYNC_PARALLEL_PEERS = 3;
+static const int DYNODE_SYNC_PARALLEL_SETTLE_SECONDS = 2;
+
 extern CDynodeSync dynodeSync;
 
 //
@@ -51,12 +59,34 @@ private:
     // ... or failed
     int64_t nTimeLastFailure;
 
+    // Request assets from several peers at once and switch as soon as they are complete
+    bool fParallelSync;
+
+    struct CSyncPeerState {
+        int64_t nTimeRequested;
+        bool fReported;
+        int nCount;
+    };
+
+    // protects mapAssetPeers, which is updated from the message handler thread
+    CCriticalSection cs;
+    // Peers the current asset was requested from in parallel mode
+    std::map<NodeId, CSyncPeerState> mapAssetPeers;
+
     void Fail();
 
+    bool IsSyncPeer(CNode* pnode);
+    bool RequestAsset(CNode* pnode, CConnman& connman);
+    bool IsAssetComplete(const std::vector<CNode*>& vNodesCopy, CConnman& connman);
+
 public:
-    CDynodeSync() { Reset(); }
+    CDynodeSync() : fParallelSync(DEFAULT_PARALLEL_SYNC) { Reset(); }
 
     void SendGovernanceSyncRequest(CNode* pnode, CConnman& connman);
+    void SendPaymentSyncRequest(CNode* pnode, CConnman& connman);
+
+    void SetParallelSync(bool fParallel) { fParallelSync = fParallel; }
+    bool IsParallelSync() { return fParallelSync; }
 
     bool IsFailed() { return nRequestedDynodeAssets == DYNODE_SYNC_FAILED; }
     bool IsBlockchainSynced() { return nRequestedDynodeAssets > DYNODE_SYNC_WAITING; }
@@ -76,6 +106,7 @@ public:
 
     void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv);
     void ProcessTick(CConnman& connman);
+    void ProcessParallelTick(CConnman& connman);
 
     void AcceptedBlockHeader(const CBlockIndex* pindexNew);
     void NotifyHeaderTip(const CBlockIndex* pindexNew, bool fInitialDownload, CConnman& connman);
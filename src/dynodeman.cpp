@@ -85,6 +85,7 @@ bool CDynodeMan::Add(CDynode& dn)
 
     LogPrint("dynode", "CDynodeMan::Add -- Adding new Dynode: addr=%s, %i now\n", dn.addr.ToString(), size() + 1);
     mapDynodes[dn.outpoint] = dn;
+    InvalidateRankCache();
     fDynodesAdded = true;
     return true;
 }
@@ -208,6 +209,7 @@ void CDynodeMan::CheckAndRemove(CConnman& connman)
                 // and finally remove it from the list
                 it->second.FlagGovernanceItemsAsDirty();
                 mapDynodes.erase(it++);
+                InvalidateRankCache();
                 fDynodesRemoved = true;
             } else {
                 bool fAsk = (nAskForDnbRecovery > 0) &&
@@ -319,6 +321,15 @@ void CDynodeMan::CheckAndRemove(CConnman& connman)
             }
         }
 
+        auto itRequest = mapDnListRequests.begin();
+        while (itRequest != mapDnListRequests.end()) {
+            if (itRequest->second.nTime < GetTime() - DNLIST_REQUEST_TIMEOUT_SECONDS) {
+                mapDnListRequests.erase(itRequest++);
+            } else {
+                ++itRequest;
+            }
+        }
+
         auto it3 = mWeAskedForVerification.begin();
         while (it3 != mWeAskedForVerification.end()) {
             if (it3->second.nBlockHeight < nCachedBlockHeight - MAX_POSE_BLOCKS) {
@@ -364,9 +375,15 @@ void CDynodeMan::Clear()
 {
     LOCK(cs);
     mapDynodes.clear();
+    mapRankCache.clear();
     mAskedUsForDynodeList.clear();
     mWeAskedForDynodeList.clear();
     mWeAskedForDynodeListEntry.clear();
+    mapDnListSnapshots.clear();
+    listDnListSnapshots.clear();
+    mapDnListRequests.clear();
+    hashLastDnList.SetNull();
+    mapLastDnList.clear();
     mapSeenDynodeBroadcast.clear();
     mapSeenDynodePing.clear();
     nPsqCount = 0;
@@ -436,7 +453,19 @@ void CDynodeMan::PsegUpdate(CNode* pnode, CConnman& connman)
         }
     }
 
-    if (pnode->GetSendVersion() == 70900) {
+    if ((pnode->GetLocalServices() & NODE_DNLIST) && (pnode->nServices & NODE_DNLIST)) {
+        // ask for a diff against the last list we verified, the peer replies
+        // with a full snapshot if it no longer knows that one
+        CDnListRequest& request = mapDnListRequests[pnode->GetId()];
+        request.nTime = GetTime();
+        request.hashBase = hashLastDnList;
+        request.hashList.SetNull();
+        request.nNextPart = 0;
+        request.nParts = 0;
+        request.fRejected = false;
+        request.mapEntries = mapLastDnList;
+        connman.PushMessage(pnode, msgMaker.Make(NetMsgType::GETDNLIST, hashLastDnList));
+    } else if (pnode->GetSendVersion() == 70900) {
         connman.PushMessage(pnode, msgMaker.Make(NetMsgType::PSEG, CTxIn()));
     } else {
         connman.PushMessage(pnode, msgMaker.Make(NetMsgType::PSEG, COutPoint()));
@@ -509,6 +538,12 @@ bool CDynodeMan::Has(const COutPoint& outpoint)
     return mapDynodes.find(outpoint) != mapDynodes.end();
 }
 
+bool CDynodeMan::HasSeenDynodePing(const uint256& hash)
+{
+    LOCK(cs);
+    return mapSeenDynodePing.count(hash);
+}
+
 //
 // Deterministically select the oldest/best Dynode to pay on the network
 //
@@ -684,20 +719,43 @@ bool CDynodeMan::GetDynodeRank(const COutPoint& outpoint, int& nRankRet, int nBl
 
     LOCK(cs);
 
-    score_pair_vec_t vecDynodeScores;
-    if (!GetDynodeScores(nBlockHash, vecDynodeScores, nMinProtocol))
-        return false;
+    // InstantSend asks for the rank of every voter of every input at the same few heights,
+    // score and sort all Dynodes only once per height and reuse the table until the list changes
+    auto key = std::make_pair(nBlockHeight, nMinProtocol);
+    auto it = mapRankCache.find(key);
+    if (it == mapRankCache.end() || it->second.nBlockHash != nBlockHash) {
+        score_pair_vec_t vecDynodeScores;
+        if (!GetDynodeScores(nBlockHash, vecDynodeScores, nMinProtocol))
+            return false;
 
-    int nRank = 0;
-    for (const auto& scorePair : vecDynodeScores) {
-        nRank++;
-        if (scorePair.second->outpoint == outpoint) {
-            nRankRet = nRank;
-            return true;
+        it = mapRankCache.emplace(key, CDynodeRankTable()).first;
+        CDynodeRankTable& table = it->second;
+        table.nBlockHash = nBlockHash;
+        table.mapRanks.clear();
+        table.mapRanks.reserve(vecDynodeScores.size());
+        int nRank = 0;
+        for (const auto& scorePair : vecDynodeScores) {
+            table.mapRanks.emplace(scorePair.second->outpoint, ++nRank);
         }
     }
 
-    return false;
+    auto itRank = it->second.mapRanks.find(outpoint);
+    if (itRank != it->second.mapRanks.end()) {
+        nRankRet = itRank->second;
+    }
+
+    // drop the tables for the lowest heights
+    while (mapRankCache.size() > RANK_CACHE_MAX_ENTRIES) {
+        mapRankCache.erase(mapRankCache.begin());
+    }
+
+    return nRankRet != -1;
+}
+
+void CDynodeMan::InvalidateRankCache()
+{
+    LOCK(cs);
+    mapRankCache.clear();
 }
 
 bool CDynodeMan::GetDynodeRanks(CDynodeMan::rank_pair_vec_t& vecDynodeRanksRet, int nBlockHeight, int nMinProtocol)
@@ -931,6 +989,38 @@ void CDynodeMan::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDa
             SyncSingle(pfrom, dynodeOutpoint, connman);
         }
 
+    } else if (strCommand == NetMsgType::GETDNLIST) { // Get Dynode list snapshot or diff
+        // Same as PSEG, ignore such requests until we are fully synced
+        if (!dynodeSync.IsSynced())
+            return;
+
+        // only served when we advertise it, peers without NODE_DNLIST use PSEG
+        if (!(pfrom->GetLocalServices() & NODE_DNLIST))
+            return;
+
+        uint256 hashBase;
+        vRecv >> hashBase;
+
+        LogPrint("dynode", "GETDNLIST -- Dynode list, base=%s, peer=%d\n", hashBase.ToString(), pfrom->id);
+
+        SyncList(pfrom, hashBase, connman);
+
+    } else if (strCommand == NetMsgType::DNLIST) { // Dynode list snapshot or diff
+        CDynodeListDiff diff;
+        vRecv >> diff;
+
+        if (!dynodeSync.IsBlockchainSynced())
+            return;
+
+        LogPrint("dynode", "DNLIST -- Dynode list part %d/%d, updated=%d, removed=%d, peer=%d\n",
+            diff.nPart + 1, diff.nParts, diff.vecUpdated.size(), diff.vecRemoved.size(), pfrom->id);
+
+        ProcessListDiff(pfrom, diff, connman);
+
+        if (fDynodesAdded) {
+            NotifyDynodeUpdates(connman);
+        }
+
     } else if (strCommand == NetMsgType::DNVERIFY) { // Dynode Verify
 
         // Need LOCK2 here to ensure consistent locking order because the all functions below call GetBlockHash which locks cs_main
@@ -977,12 +1067,8 @@ void CDynodeMan::SyncSingle(CNode* pnode, const COutPoint& outpoint, CConnman& c
     }
 }
 
-void CDynodeMan::SyncAll(CNode* pnode, CConnman& connman)
+bool CDynodeMan::CheckListRequestLimit(CNode* pnode)
 {
-    // do not provide any data until our node is synced
-    if (!dynodeSync.IsSynced())
-        return;
-
     // local network
     bool isLocal = (pnode->addr.IsRFC1918() || pnode->addr.IsLocal());
 
@@ -994,12 +1080,24 @@ void CDynodeMan::SyncAll(CNode* pnode, CConnman& connman)
         if (it != mAskedUsForDynodeList.end() && it->second > GetTime()) {
             Misbehaving(pnode->GetId(), 34);
             LogPrintf("CDynodeMan::%s -- peer already asked me for the list, peer=%d\n", __func__, pnode->id);
-            return;
+            return false;
         }
         int64_t askAgain = GetTime() + PSEG_UPDATE_SECONDS;
         mAskedUsForDynodeList[addrSquashed] = askAgain;
     }
 
+    return true;
+}
+
+void CDynodeMan::SyncAll(CNode* pnode, CConnman& connman)
+{
+    // do not provide any data until our node is synced
+    if (!dynodeSync.IsSynced())
+        return;
+
+    if (!CheckListRequestLimit(pnode))
+        return;
+
     int nInvCount = 0;
 
     LOCK(cs);
@@ -1018,6 +1116,228 @@ void CDynodeMan::SyncAll(CNode* pnode, CConnman& connman)
     LogPrintf("CDynodeMan::%s -- Sent %d Dynode invs to peer=%d\n", __func__, nInvCount, pnode->id);
 }
 
+uint256 CDynodeMan::GetDnListEntryHash(const CDynodeBroadcast& dnb)
+{
+    // CDynodeBroadcast::GetHash() does not cover lastPing, hash the whole message instead
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << dnb;
+    return Hash(ss.begin(), ss.end());
+}
+
+uint256 CDynodeMan::GetDnListHash(const dnlist_entries_t& mapEntries)
+{
+    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+    for (const auto& entry : mapEntries) {
+        ss << entry.first << entry.second;
+    }
+    return ss.GetHash();
+}
+
+void CDynodeMan::GetDnListDiff(const dnlist_entries_t& mapBase, const dnlist_entries_t& mapEntries, std::vector<COutPoint>& vecUpdatedRet, std::vector<COutPoint>& vecRemovedRet)
+{
+    vecUpdatedRet.clear();
+    vecRemovedRet.clear();
+    for (const auto& entry : mapEntries) {
+        auto it = mapBase.find(entry.first);
+        if (it != mapBase.end() && it->second == entry.second)
+            continue; // unchanged
+        vecUpdatedRet.push_back(entry.first);
+    }
+    for (const auto& entry : mapBase) {
+        if (!mapEntries.count(entry.first))
+            vecRemovedRet.push_back(entry.first);
+    }
+}
+
+void CDynodeMan::ApplyDnListDiff(dnlist_entries_t& mapEntries, const dnlist_entries_t& mapUpdated, const std::vector<COutPoint>& vecRemoved)
+{
+    for (const auto& entry : mapUpdated) {
+        mapEntries[entry.first] = entry.second;
+    }
+    for (const auto& outpoint : vecRemoved) {
+        mapEntries.erase(outpoint);
+    }
+}
+
+void CDynodeMan::SyncList(CNode* pnode, const uint256& hashBase, CConnman& connman)
+{
+    // do not provide any data until our node is synced
+    if (!dynodeSync.IsSynced())
+        return;
+
+    // a diff still hashes every entry, so diffs count against the limit as well
+    if (!CheckListRequestLimit(pnode))
+        return;
+
+    LOCK(cs);
+
+    auto itBase = hashBase.IsNull() ? mapDnListSnapshots.end() : mapDnListSnapshots.find(hashBase);
+    const dnlist_entries_t* pmapBase = itBase != mapDnListSnapshots.end() ? &itBase->second : NULL;
+
+    dnlist_entries_t mapEntries;
+    for (const auto& dnpair : mapDynodes) {
+        if (Params().RequireRoutableExternalIP() &&
+            (dnpair.second.addr.IsRFC1918() || dnpair.second.addr.IsLocal()))
+            continue; // do not send local network Dynode
+        // NOTE: send Dynode regardless of its current state, the other node will need it to verify old votes.
+        mapEntries.emplace(dnpair.first, GetDnListEntryHash(CDynodeBroadcast(dnpair.second)));
+    }
+
+    // without a known base the diff against an empty list is the full snapshot
+    dnlist_entries_t mapNoBase;
+    std::vector<COutPoint> vecUpdatedOutpoints;
+    std::vector<COutPoint> vecRemoved;
+    GetDnListDiff(pmapBase ? *pmapBase : mapNoBase, mapEntries, vecUpdatedOutpoints, vecRemoved);
+
+    std::vector<CDynodeBroadcast> vecUpdated;
+    vecUpdated.reserve(vecUpdatedOutpoints.size());
+    for (const auto& outpoint : vecUpdatedOutpoints) {
+        vecUpdated.push_back(CDynodeBroadcast(mapDynodes.at(outpoint)));
+    }
+
+    CDynodeListDiff diff;
+    diff.hashBase = pmapBase ? hashBase : uint256();
+    diff.hashList = GetDnListHash(mapEntries);
+    diff.nParts = std::max<int>(1, (vecUpdated.size() + DNLIST_MAX_ENTRIES - 1) / DNLIST_MAX_ENTRIES);
+
+    if (!mapDnListSnapshots.count(diff.hashList)) {
+        mapDnListSnapshots.emplace(diff.hashList, mapEntries);
+        listDnListSnapshots.push_back(diff.hashList);
+        while (listDnListSnapshots.size() > DNLIST_SNAPSHOT_CACHE_SIZE) {
+            mapDnListSnapshots.erase(listDnListSnapshots.front());
+            listDnListSnapshots.pop_front();
+        }
+    }
+
+    CNetMsgMaker msgMaker(pnode->GetSendVersion());
+    for (diff.nPart = 0; diff.nPart < diff.nParts; diff.nPart++) {
+        size_t nBegin = std::min(vecUpdated.size(), (size_t)diff.nPart * DNLIST_MAX_ENTRIES);
+        size_t nEnd = std::min(vecUpdated.size(), nBegin + DNLIST_MAX_ENTRIES);
+        diff.vecUpdated.assign(vecUpdated.begin() + nBegin, vecUpdated.begin() + nEnd);
+        if (diff.nPart == 0) {
+            diff.vecRemoved = vecRemoved;
+        } else {
+            diff.vecRemoved.clear();
+        }
+        connman.PushMessage(pnode, msgMaker.Make(NetMsgType::DNLIST, diff));
+    }
+
+    connman.PushMessage(pnode, msgMaker.Make(NetMsgType::SYNCSTATUSCOUNT, DYNODE_SYNC_LIST, (int)mapEntries.size()));
+    LogPrintf("CDynodeMan::%s -- Sent %d of %d Dynode entries, %d removed, %s, peer=%d\n", __func__,
+        vecUpdated.size(), mapEntries.size(), vecRemoved.size(), pmapBase ? "diff" : "full", pnode->id);
+}
+
+void CDynodeMan::ProcessListDiff(CNode* pfrom, const CDynodeListDiff& diff, CConnman& connman)
+{
+    bool fInvalid = false;
+    {
+        LOCK(cs);
+        auto it = mapDnListRequests.find(pfrom->GetId());
+        if (it == mapDnListRequests.end()) {
+            LogPrint("dynode", "CDynodeMan::%s -- unrequested Dynode list, peer=%d\n", __func__, pfrom->id);
+            return;
+        }
+        CDnListRequest& request = it->second;
+        bool fValid = diff.nParts >= 1 && diff.nPart == request.nNextPart && diff.nPart < diff.nParts &&
+                      diff.vecUpdated.size() <= (size_t)DNLIST_MAX_ENTRIES;
+        if (fValid && diff.nPart == 0) {
+            // a diff must be against the base we asked for, anything else is a full snapshot
+            if (!diff.hashBase.IsNull() && diff.hashBase != request.hashBase) {
+                fValid = false;
+            } else {
+                if (diff.hashBase.IsNull())
+                    request.mapEntries.clear();
+                request.hashList = diff.hashList;
+                request.nParts = diff.nParts;
+            }
+        } else if (fValid) {
+            fValid = diff.hashList == request.hashList && diff.nParts == request.nParts && diff.vecRemoved.empty();
+        }
+        if (!fValid) {
+            LogPrintf("CDynodeMan::%s -- invalid Dynode list part %d/%d, peer=%d\n", __func__, diff.nPart + 1, diff.nParts, pfrom->id);
+            mapDnListRequests.erase(it);
+            fInvalid = true;
+        }
+    }
+
+    if (fInvalid) {
+        LOCK(cs_main);
+        Misbehaving(pfrom->GetId(), 20);
+        return;
+    }
+
+    // every entry goes through the same checks as a DNANNOUNCE, signatures are verified in one pass here
+    // only accepted entries are recorded, the list is not used as a base if any entry was rejected
+    dnlist_entries_t mapUpdated;
+    bool fRejected = false;
+    for (const auto& dnb : diff.vecUpdated) {
+        int nDos = 0;
+        if (CheckDnbAndUpdateDynodeList(pfrom, dnb, nDos, connman)) {
+            mapUpdated[dnb.outpoint] = GetDnListEntryHash(dnb);
+            // use announced Dynode as a peer
+            connman.AddNewAddress(CAddress(dnb.addr, NODE_NETWORK), pfrom->addr, 2 * 60 * 60);
+        } else {
+            fRejected = true;
+            if (nDos > 0) {
+                LOCK(cs_main);
+                Misbehaving(pfrom->GetId(), nDos);
+            }
+            continue;
+        }
+
+        // a known broadcast can still carry a newer ping, apply it like a DNPING
+        LOCK2(cs_main, cs);
+        uint256 hashDNP = dnb.lastPing.GetHash();
+        if (dnb.lastPing == CDynodePing() || mapSeenDynodePing.count(hashDNP))
+            continue;
+        mapSeenDynodePing.insert(std::make_pair(hashDNP, dnb.lastPing));
+        CDynode* pdn = Find(dnb.outpoint);
+        if (pdn && !pdn->IsNewStartRequired()) {
+            CDynodePing dnp = dnb.lastPing;
+            if (!dnp.CheckAndUpdate(pdn, false, nDos, connman) && nDos > 0)
+                Misbehaving(pfrom->GetId(), nDos);
+        }
+    }
+
+    bool fMismatch = false;
+    {
+        LOCK(cs);
+        auto it = mapDnListRequests.find(pfrom->GetId());
+        if (it == mapDnListRequests.end())
+            return;
+        CDnListRequest& request = it->second;
+        // removed entries only leave the snapshot, our own list expires Dynodes by itself
+        ApplyDnListDiff(request.mapEntries, mapUpdated, diff.vecRemoved);
+        request.fRejected |= fRejected;
+        request.nNextPart++;
+        if (request.nNextPart < request.nParts)
+            return;
+
+        if (request.fRejected) {
+            // keep the previous base, so that the next diff sends the rejected entries again
+            LogPrint("dynode", "CDynodeMan::%s -- Dynode list %s has rejected entries, not used as a base, peer=%d\n", __func__, request.hashList.ToString(), pfrom->id);
+        } else {
+            uint256 hashList = GetDnListHash(request.mapEntries);
+            if (hashList == request.hashList) {
+                hashLastDnList = hashList;
+                mapLastDnList.swap(request.mapEntries);
+                LogPrint("dynode", "CDynodeMan::%s -- verified Dynode list %s, %d entries, peer=%d\n", __func__, hashList.ToString(), mapLastDnList.size(), pfrom->id);
+            } else {
+                LogPrintf("CDynodeMan::%s -- Dynode list hash mismatch, expected=%s, got=%s, peer=%d\n", __func__, request.hashList.ToString(), hashList.ToString(), pfrom->id);
+                hashLastDnList.SetNull();
+                mapLastDnList.clear();
+                fMismatch = true;
+            }
+        }
+        mapDnListRequests.erase(it);
+    }
+
+    if (fMismatch) {
+        LOCK(cs_main);
+        Misbehaving(pfrom->GetId(), 20);
+    }
+}
+
 void CDynodeMan::PushPsegInvs(CNode* pnode, const CDynode& dn)
 {
     AssertLockHeld(cs);
@@ -1602,10 +1922,14 @@ bool CDynodeMan::CheckDnbAndUpdateDynodeList(CNode* pfrom, CDynodeBroadcast dnb,
         CDynode* pdn = Find(dnb.outpoint);
         if (pdn) {
             CDynodeBroadcast dnbOld = mapSeenDynodeBroadcast[CDynodeBroadcast(*pdn).GetHash()].second;
+            int nProtocolVersionOld = pdn->nProtocolVersion;
             if (!dnb.Update(pdn, nDos, connman)) {
                 LogPrint("dynode", "CDynodeMan::CheckDnbAndUpdateDynodeList -- Update() failed, dynode=%s\n", dnb.outpoint.ToStringShort());
                 return false;
             }
+            if (pdn->nProtocolVersion != nProtocolVersionOld) {
+                InvalidateRankCache();
+            }
             if (hash != dnbOld.GetHash()) {
                 mapSeenDynodeBroadcast.erase(dnbOld.GetHash());
             }
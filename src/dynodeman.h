@@ -14,6 +14,40 @@ class CConnman;
 
 extern CDynodeMan dnodeman;
 
+/**
+ * Reply to "getdnlist": a deterministic snapshot of the Dynode list or, when
+ * hashBase is set, the entries that changed since the snapshot with that hash.
+ * Large replies are split into nParts messages, hashBase and hashList are the
+ * same in every part.
+ */
+class CDynodeListDiff
+{
+public:
+    uint256 hashBase;
+    uint256 hashList;
+    int nPart;
+    int nParts;
+    // new or changed entries, sorted by outpoint
+    std::vector<CDynodeBroadcast> vecUpdated;
+    // entries dropped since hashBase, only sent in the first part
+    std::vector<COutPoint> vecRemoved;
+
+    CDynodeListDiff() : nPart(0), nParts(1) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(hashBase);
+        READWRITE(hashList);
+        READWRITE(nPart);
+        READWRITE(nParts);
+        READWRITE(vecUpdated);
+        READWRITE(vecRemoved);
+    }
+};
+
 class CDynodeMan
 {
 public:
@@ -21,6 +55,8 @@ public:
     typedef std::vector<score_pair_t> score_pair_vec_t;
     typedef std::pair<int, const CDynode> rank_pair_t;
     typedef std::vector<rank_pair_t> rank_pair_vec_t;
+    // Dynode list snapshot: hash of the full broadcast (incl. lastPing) per outpoint
+    typedef std::map<COutPoint, uint256> dnlist_entries_t;
 
 private:
     static const std::string SERIALIZATION_VERSION_STRING;
@@ -40,6 +76,22 @@ private:
     static const int DNB_RECOVERY_WAIT_SECONDS = 60;
     static const int DNB_RECOVERY_RETRY_SECONDS = 3 * 60 * 60;
 
+    static const int RANK_CACHE_MAX_ENTRIES = 64;
+
+    static const int DNLIST_MAX_ENTRIES = 2000;
+    static const int DNLIST_SNAPSHOT_CACHE_SIZE = 8;
+    static const int DNLIST_REQUEST_TIMEOUT_SECONDS = 5 * 60;
+
+    struct CDnListRequest {
+        int64_t nTime;
+        uint256 hashBase;
+        uint256 hashList;
+        int nNextPart;
+        int nParts;
+        bool fRejected; //!< an entry of the list was rejected by CheckDnbAndUpdateDynodeList
+        dnlist_entries_t mapEntries;
+    };
+
     // critical section to protect the inner data structures
     mutable CCriticalSection cs;
 
@@ -66,6 +118,22 @@ private:
     std::map<CService, std::pair<int64_t, CDynodeVerification> > mapPendingDNV;
     CCriticalSection cs_mapPendingDNV;
 
+    // Dynode ranks by (block height, min protocol), only valid for nBlockHash
+    struct CDynodeRankTable {
+        uint256 nBlockHash;
+        std::unordered_map<COutPoint, int, SaltedOutpointHasher> mapRanks;
+    };
+    std::map<std::pair<int, int>, CDynodeRankTable> mapRankCache;
+
+    // snapshots we recently served, so that peers can ask for a diff against them
+    std::map<uint256, dnlist_entries_t> mapDnListSnapshots;
+    std::list<uint256> listDnListSnapshots;
+    // "getdnlist" requests waiting for their "dnlist" parts
+    std::map<NodeId, CDnListRequest> mapDnListRequests;
+    // last snapshot we received and verified, base of our next "getdnlist"
+    uint256 hashLastDnList;
+    dnlist_entries_t mapLastDnList;
+
     /// Set when Dynodes are added, cleared when CGovernanceManager is notified
     bool fDynodesAdded;
 
@@ -84,6 +152,10 @@ private:
 
     void SyncSingle(CNode* pnode, const COutPoint& outpoint, CConnman& connman);
     void SyncAll(CNode* pnode, CConnman& connman);
+    void SyncList(CNode* pnode, const uint256& hashBase, CConnman& connman);
+    /// Full list requests are only served once per PSEG_UPDATE_SECONDS on mainnet
+    bool CheckListRequestLimit(CNode* pnode);
+    void ProcessListDiff(CNode* pfrom, const CDynodeListDiff& diff, CConnman& connman);
 
     void PushPsegInvs(CNode* pnode, const CDynode& dn);
 
@@ -126,6 +198,9 @@ public:
         if (ser_action.ForRead() && (strVersion != SERIALIZATION_VERSION_STRING)) {
             Clear();
         }
+        if (ser_action.ForRead()) {
+            InvalidateRankCache();
+        }
     }
 
     CDynodeMan();
@@ -152,6 +227,9 @@ public:
     /// Clear Dynode vector
     void Clear();
 
+    /// Drop cached rank tables, must be called whenever Dynodes are added, removed or change their protocol version
+    void InvalidateRankCache();
+
     /// Count Dynodes filtered by nProtocolVersion.
     /// Dynode nProtocolVersion should match or be above the one specified in param here.
     int CountDynodes(int nProtocolVersion = -1);
@@ -164,9 +242,17 @@ public:
 
     void PsegUpdate(CNode* pnode, CConnman& connman);
 
+    static uint256 GetDnListEntryHash(const CDynodeBroadcast& dnb);
+    static uint256 GetDnListHash(const dnlist_entries_t& mapEntries);
+    /// Outpoints in mapEntries that are new or changed since mapBase, and outpoints of mapBase no longer in mapEntries
+    static void GetDnListDiff(const dnlist_entries_t& mapBase, const dnlist_entries_t& mapEntries, std::vector<COutPoint>& vecUpdatedRet, std::vector<COutPoint>& vecRemovedRet);
+    /// Apply the updated entries and removed outpoints of a diff to a snapshot
+    static void ApplyDnListDiff(dnlist_entries_t& mapEntries, const dnlist_entries_t& mapUpdated, const std::vector<COutPoint>& vecRemoved);
+
     /// Versions of Find that are safe to use from outside the class
     bool Get(const COutPoint& outpoint, CDynode& dynodeRet);
     bool Has(const COutPoint& outpoint);
+    bool HasSeenDynodePing(const uint256& hash);
 
     bool GetDynodeInfo(const COutPoint& outpoint, dynode_info_t& dnInfoRet);
     bool GetDynodeInfo(const CPubKey& pubKeyDynode, dynode_info_t& dnInfoRet);
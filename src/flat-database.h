@@ -12,10 +12,14 @@
 #include "clientversion.h"
 #include "hash.h"
 #include "streams.h"
+#include "sync.h"
 #include "util.h"
 
 #include <boost/filesystem.hpp>
 
+/** Default interval in seconds between background snapshots of the cache files, 0 disables them */
+static const int DEFAULT_CACHE_SNAPSHOT_INTERVAL = 15 * 60;
+
 /** 
 *   Generic Dumping and Loading
 *   ---------------------------
@@ -41,11 +45,15 @@ private:
 
     bool Write(const T& objToSave)
     {
-        // LOCK(objToSave.cs);
+        // objects lock themselves while being serialized, this only keeps
+        // a snapshot and the shutdown dump from sharing the temporary file
+        static CCriticalSection cs_write;
+        LOCK(cs_write);
 
         int64_t nStart = GetTimeMillis();
 
-        // serialize, checksum data up to that point, then append checksum
+        // serialize, checksum data up to that point, then append checksum. Objects
+        // only hold their lock while serializing, not while the file is written
         CDataStream ssObj(SER_DISK, CLIENT_VERSION);
         ssObj << strMagicMessage;                   // specific magic message for this type of object
         ssObj << FLATDATA(Params().MessageStart()); // network specific magic number
@@ -53,19 +61,30 @@ private:
         uint256 hash = Hash(ssObj.begin(), ssObj.end());
         ssObj << hash;
 
-        // open output file, and associate with CAutoFile
-        FILE* file = fopen(pathDB.string().c_str(), "wb");
+        // open a temporary file next to the real one and associate with CAutoFile
+        boost::filesystem::path pathTmp = pathDB;
+        pathTmp += ".new";
+        FILE* file = fopen(pathTmp.string().c_str(), "wb");
         CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
         if (fileout.IsNull())
-            return error("%s: Failed to open file %s", __func__, pathDB.string());
+            return error("%s: Failed to open file %s", __func__, pathTmp.string());
 
         // Write and commit header, data
         try {
             fileout << ssObj;
         } catch (const std::exception& e) {
+            fileout.fclose();
+            boost::filesystem::remove(pathTmp);
             return error("%s: Serialize or I/O error - %s", __func__, e.what());
         }
+
+        // commit the data, then replace the old file so a crash never leaves a partial one behind
+        FileCommit(fileout.Get());
         fileout.fclose();
+        if (!RenameOver(pathTmp, pathDB)) {
+            boost::filesystem::remove(pathTmp);
+            return error("%s: Rename-into-place failed for %s", __func__, pathDB.string());
+        }
 
         LogPrintf("Written info to %s  %dms\n", strFilename, GetTimeMillis() - nStart);
         LogPrintf("     %s\n", objToSave.ToString());
@@ -166,10 +185,14 @@ public:
         strMagicMessage = strMagicMessageIn;
     }
 
-    bool Load(T& objToLoad)
+    /**
+     * Load the object from disk. With fCleanup unset the stale entry cleanup is left
+     * to the caller, so objects that depend on each other can be loaded concurrently.
+     */
+    bool Load(T& objToLoad, bool fCleanup = true)
     {
         LogPrintf("Reading info from %s...\n", strFilename);
-        ReadResult readResult = Read(objToLoad);
+        ReadResult readResult = Read(objToLoad, !fCleanup);
         if (readResult == FileError)
             LogPrintf("Missing file %s, will try to recreate\n", strFilename);
         else if (readResult != Ok) {
@@ -185,24 +208,31 @@ public:
         return true;
     }
 
-    bool Dump(T& objToSave)
+    /**
+     * Write the object to disk. Periodic snapshots pass fVerify = false: the file
+     * was already validated when it was loaded at startup and re-reading it on
+     * every snapshot would cost as much as writing it.
+     */
+    bool Dump(T& objToSave, bool fVerify = true)
     {
         int64_t nStart = GetTimeMillis();
 
-        LogPrintf("Verifying %s format...\n", strFilename);
-        T tmpObjToLoad;
-        ReadResult readResult = Read(tmpObjToLoad, true);
-
-        // there was an error and it was not an error on file opening => do not proceed
-        if (readResult == FileError)
-            LogPrintf("Missing file %s, will try to recreate\n", strFilename);
-        else if (readResult != Ok) {
-            LogPrintf("Error reading %s: ", strFilename);
-            if (readResult == IncorrectFormat)
-                LogPrintf("%s: Magic is ok but data has invalid format, will try to recreate\n", __func__);
-            else {
-                LogPrintf("%s: File format is unknown or invalid, please fix it manually\n", __func__);
-                return false;
+        if (fVerify) {
+            LogPrintf("Verifying %s format...\n", strFilename);
+            T tmpObjToLoad;
+            ReadResult readResult = Read(tmpObjToLoad, true);
+
+            // there was an error and it was not an error on file opening => do not proceed
+            if (readResult == FileError)
+                LogPrintf("Missing file %s, will try to recreate\n", strFilename);
+            else if (readResult != Ok) {
+                LogPrintf("Error reading %s: ", strFilename);
+                if (readResult == IncorrectFormat)
+                    LogPrintf("%s: Magic is ok but data has invalid format, will try to recreate\n", __func__);
+                else {
+                    LogPrintf("%s: File format is unknown or invalid, please fix it manually\n", __func__);
+                    return false;
+                }
             }
         }
 
@@ -4,6 +4,8 @@
 
 #include "chain.h"
 #include "core_io.h"
+#include "fluidinstruction.h"
+#include "hash.h"
 #include "keepass.h"
 #include "net.h"
 #include "netbase.h"
@@ -52,6 +54,29 @@ int GetFluidOpCode(const CScript& fluidScript)
     return 0;
 }
 
+/** Gets the operand pushed after the opcode of a fluid script, which is what
+ *  GetRidOfScriptStatement leaves of its assembly. */
+bool GetFluidToken(const CScript& fluidScript, std::vector<unsigned char>& vchToken)
+{
+    opcodetype opcode;
+    CScript::const_iterator pc = fluidScript.begin();
+    if (!fluidScript.GetOp(pc, opcode))
+        return false;
+    if (!fluidScript.GetOp(pc, opcode, vchToken) || opcode > OP_PUSHDATA4)
+        return false;
+    return true;
+}
+
+/** Two fluid scripts carry the same instruction if the hashes of their operands match */
+bool GetFluidInstructionHash(const CScript& fluidScript, uint256& hashInstruction)
+{
+    std::vector<unsigned char> vchToken;
+    if (!GetFluidToken(fluidScript, vchToken))
+        return false;
+    hashInstruction = Hash(vchToken.begin(), vchToken.end());
+    return true;
+}
+
 /** Initialise sovereign identities that are able to run fluid commands */
 std::vector<std::pair<std::string, CDynamicAddress> > CFluidParameters::InitialiseSovereignIdentities()
 {
@@ -69,11 +94,12 @@ std::vector<std::pair<std::string, CDynamicAddress> > CFluidParameters::Initiali
         x.push_back(std::make_pair("Test04", CDynamicAddress("DHVmS621KBBZJTJSxGDdLxoU7LCmpexWDa"))); //importprivkey QScWuazWgWDTj8cXXz1YFKJW7mNJHJgMFY2FB6hkNyh3SJDUhPZt
         x.push_back(std::make_pair("Test05", CDynamicAddress("DCZXDSRB3cJdCCUSerE4pvSfGQoXUivUxo"))); //importprivkey QUt4pEDanRPzos3meoiNGUG9g7RctCtiwLoPjhDKfNPK99oLuzcU
     } else if (Params().NetworkIDString() == CBaseChainParams::REGTEST) {
-        x.push_back(std::make_pair("RegTest01", CDynamicAddress("DSCex4e189aULrig3nLd42gVf7AbjTwnP5"))); //importprivkey QVKXuZ2hSo2cT9BhkN3CApLuZYVsuzNvidJRt1ucyniHheZ2Pfq5
-        x.push_back(std::make_pair("RegTest02", CDynamicAddress("DMAh37n3RUdDxox3uiWAnc1zEPp5yFbHiL"))); //importprivkey QU4VGDcVoej7nDZiyaSgoL7foG8xKiaVyk5odHnJdtyv4tYkmBw1
-        x.push_back(std::make_pair("RegTest03", CDynamicAddress("DN4KvqtXyygooPV3oha72TyBB5nqBbkxwj"))); //importprivkey QWjTe6sCFVtKBsXfrYDyrHzn7eBeJktsQnWzfiANkMd9PhVM4Qnp
-        x.push_back(std::make_pair("RegTest04", CDynamicAddress("DHVmS621KBBZJTJSxGDdLxoU7LCmpexWDa"))); //importprivkey QScWuazWgWDTj8cXXz1YFKJW7mNJHJgMFY2FB6hkNyh3SJDUhPZt
-        x.push_back(std::make_pair("RegTest05", CDynamicAddress("DCZXDSRB3cJdCCUSerE4pvSfGQoXUivUxo"))); //importprivkey QUt4pEDanRPzos3meoiNGUG9g7RctCtiwLoPjhDKfNPK99oLuzcU
+        // Same keys as testnet, encoded with the regtest address and secret key prefixes
+        x.push_back(std::make_pair("RegTest01", CDynamicAddress("yhP1G1RhDzYrJY4CjvygPpd2tbWMtXydhw"))); //importprivkey cUHcDdDZdFEkP4FvYW1Xev1MijmiXtLouQkzCoyHkYkwWTjurHSb
+        x.push_back(std::make_pair("RegTest02", CDynamicAddress("ycM3M4ZjXKbbvVHabs9E8PxXTt9rB4NRsE"))); //importprivkey cT2ZaHoMz6wFi8dwmiR2HRn7xTQnwcYPAXYMx5qyQf2ZshhuXcv4
+        x.push_back(std::make_pair("RegTest03", CDynamicAddress("ydEgEngE5pfBm4paVrDANFuiQa8bS24Hf8"))); //importprivkey cVhXxB44Rx6T7nbtegCKLPfEGqTUverkbZyYzWE3X7foCWdnmTNH
+        x.push_back(std::make_pair("RegTest04", CDynamicAddress("yYg7k2ohR29wG8dyeQrggkk1LpYY54kyVG"))); //importprivkey cRabDfBNrxRbf3gkL7ysjQxxGxe8uCeESKUoVtmR9jjhF7HP9Lzb
+        x.push_back(std::make_pair("RegTest05", CDynamicAddress("yTjsXPCs9TH19soyLzs8AiPCVu9Hk7hWbs"))); //importprivkey cTr98JQSxsc8jn7zSwghkZvbqJhTW6rc88Fx4VGzS8Rxwxu5JVD1
     }
     else if (Params().NetworkIDString() == CBaseChainParams::PRIVATENET) {
         x.push_back(std::make_pair("Priv01", CDynamicAddress("D6wUMdGtoXtj4zjyk4kYu6cL8LM5j6bEd7"))); //importprivkey QUQsWaE1LRdW95gLgyQgjkUjR4eqhbigmDHENzyTVYy7JCgQcYMd
@@ -142,44 +168,38 @@ std::vector<std::vector<unsigned char> > CFluidParameters::InitialiseAddressChar
 /** Checks fluid transactoin operation script amount for invalid values. */
 bool CFluid::CheckFluidOperationScript(const CScript& fluidScriptPubKey, const int64_t timeStamp, std::string& errorMessage, bool fSkipTimeStampCheck)
 {
-    std::string strFluidOpScript = ScriptToAsmStr(fluidScriptPubKey);
-    std::string verificationWithoutOpCode = GetRidOfScriptStatement(strFluidOpScript);
-    std::string strOperationCode = GetRidOfScriptStatement(strFluidOpScript, 0);
+    CFluidInstructionRef instruction = GetFluidInstruction(fluidScriptPubKey);
     if (!fSkipTimeStampCheck) {
-        if (!ExtractCheckTimestamp(strFluidOpScript, timeStamp)) {
+        if (!instruction->CheckTimestamp(timeStamp)) {
             errorMessage = "CheckFluidOperationScript fluid timestamp is too old.";
             return false;
         }
     }
-    if (IsHex(verificationWithoutOpCode)) {
-        std::string strAmount;
-        std::string strUnHexedFluidOpScript = HexToString(verificationWithoutOpCode);
-        std::vector<std::string> vecSplitScript;
-        SeparateString(strUnHexedFluidOpScript, vecSplitScript, "$");
-        if (vecSplitScript.size() > 1) {
-            strAmount = vecSplitScript[0];
-            CAmount fluidAmount;
-            if (ParseFixedPoint(strAmount, 8, &fluidAmount)) {
-                if ((strOperationCode == "OP_REWARD_MINING" || strOperationCode == "OP_REWARD_DYNODE") && fluidAmount < 0) {
-                    errorMessage = "CheckFluidOperationScript fluid reward amount is less than zero: " + strAmount;
-                    return false;
-                } else if (strOperationCode == "OP_MINT" && (fluidAmount > FLUID_MAX_FOR_MINT)) {
-                    errorMessage = "CheckFluidOperationScript fluid OP_MINT amount exceeds maximum: " + strAmount;
-                    return false;
-                } else if (strOperationCode == "OP_REWARD_MINING" && (fluidAmount > FLUID_MAX_REWARD_FOR_MINING)) {
-                    errorMessage = "CheckFluidOperationScript fluid OP_REWARD_MINING amount exceeds maximum: " + strAmount;
-                    return false;
-                } else if (strOperationCode == "OP_REWARD_DYNODE" && (fluidAmount > FLUID_MAX_REWARD_FOR_DYNODE)) {
-                    errorMessage = "CheckFluidOperationScript fluid OP_REWARD_DYNODE amount exceeds maximum: " + strAmount;
-                    return false;
-                }
+    if (instruction->IsNull()) {
+        errorMessage = "CheckFluidOperationScript fluid token is missing. " + ScriptToAsmStr(fluidScriptPubKey);
+        return false;
+    }
+    if (instruction->vMessageFields.size() > 1) {
+        const std::string& strAmount = instruction->vMessageFields[0];
+        if (instruction->fAmount) {
+            int nOpCode = GetFluidOpCode(fluidScriptPubKey);
+            CAmount fluidAmount = instruction->nAmount;
+            if ((nOpCode == OP_REWARD_MINING || nOpCode == OP_REWARD_DYNODE) && fluidAmount < 0) {
+                errorMessage = "CheckFluidOperationScript fluid reward amount is less than zero: " + strAmount;
+                return false;
+            } else if (nOpCode == OP_MINT && (fluidAmount > FLUID_MAX_FOR_MINT)) {
+                errorMessage = "CheckFluidOperationScript fluid OP_MINT amount exceeds maximum: " + strAmount;
+                return false;
+            } else if (nOpCode == OP_REWARD_MINING && (fluidAmount > FLUID_MAX_REWARD_FOR_MINING)) {
+                errorMessage = "CheckFluidOperationScript fluid OP_REWARD_MINING amount exceeds maximum: " + strAmount;
+                return false;
+            } else if (nOpCode == OP_REWARD_DYNODE && (fluidAmount > FLUID_MAX_REWARD_FOR_DYNODE)) {
+                errorMessage = "CheckFluidOperationScript fluid OP_REWARD_DYNODE amount exceeds maximum: " + strAmount;
+                return false;
             }
-        } else {
-            errorMessage = "CheckFluidOperationScript fluid token invalid. " + strUnHexedFluidOpScript;
-            return false;
         }
     } else {
-        errorMessage = "CheckFluidOperationScript fluid token is not hex. " + verificationWithoutOpCode;
+        errorMessage = "CheckFluidOperationScript fluid token invalid. " + instruction->strMessage;
         return false;
     }
 
@@ -189,21 +209,14 @@ bool CFluid::CheckFluidOperationScript(const CScript& fluidScriptPubKey, const i
 /** Checks whether fluid transaction is in the memory pool already */
 bool CFluid::CheckIfExistsInMemPool(const CTxMemPool& pool, const CScript& fluidScriptPubKey, std::string& errorMessage)
 {
-    for (const CTxMemPoolEntry& e : pool.mapTx) {
-        const CTransaction& tx = e.GetTx();
-        for (const CTxOut& txOut : tx.vout) {
-            if (IsTransactionFluid(txOut.scriptPubKey)) {
-                std::string strNewFluidScript = ScriptToAsmStr(fluidScriptPubKey);
-                std::string strMemPoolFluidScript = ScriptToAsmStr(txOut.scriptPubKey);
-                std::string strNewTxWithoutOpCode = GetRidOfScriptStatement(strNewFluidScript);
-                std::string strMemPoolTxWithoutOpCode = GetRidOfScriptStatement(strMemPoolFluidScript);
-                if (strNewTxWithoutOpCode == strMemPoolTxWithoutOpCode) {
-                    errorMessage = "CheckIfExistsInMemPool: fluid transaction is already in the memory pool!";
-                    LogPrintf("CheckIfExistsInMemPool: fluid transaction, %s is already in the memory pool! %s\n", tx.GetHash().ToString(), strNewTxWithoutOpCode);
-                    return true;
-                }
-            }
-        }
+    uint256 hashInstruction, txid;
+    if (!GetFluidInstructionHash(fluidScriptPubKey, hashInstruction))
+        return false;
+
+    if (pool.existsFluidInstruction(hashInstruction, txid)) {
+        errorMessage = "CheckIfExistsInMemPool: fluid transaction is already in the memory pool!";
+        LogPrintf("CheckIfExistsInMemPool: fluid transaction, %s is already in the memory pool! %s\n", txid.ToString(), ScriptToAsmStr(fluidScriptPubKey));
+        return true;
     }
 
     return false;
@@ -212,51 +225,15 @@ bool CFluid::CheckIfExistsInMemPool(const CTxMemPool& pool, const CScript& fluid
 /** Checks whether as to parties have actually signed it - please use this with ones with the OP_CODE */
 bool CFluid::CheckIfQuorumExists(const std::string consentToken, std::string& message, bool individual)
 {
-    std::vector<std::string> fluidSovereigns;
-    std::pair<CDynamicAddress, bool> keyOne;
-    std::pair<CDynamicAddress, bool> keyTwo;
-    std::pair<CDynamicAddress, bool> keyThree;
-    keyOne.second = false, keyTwo.second = false;
-    keyThree.second = false;
-
-    GetLastBlockIndex(chainActive.Tip());
-    CBlockIndex* pindex = chainActive.Tip();
-
-    if (pindex != NULL) {
-        //TODO fluid
-        fluidSovereigns = InitialiseAddresses(); //pindex->fluidParams.fluidSovereigns;
-    } else
-        fluidSovereigns = InitialiseAddresses();
-
-    for (const std::string& address : fluidSovereigns) {
-        CDynamicAddress attemptKey, xKey(address);
-
-        if (!xKey.IsValid())
-            return false;
-
-        if (GenericVerifyInstruction(consentToken, attemptKey, message, 1) && xKey == attemptKey) {
-            keyOne = std::make_pair(attemptKey.ToString(), true);
-        }
-
-        if (GenericVerifyInstruction(consentToken, attemptKey, message, 2) && xKey == attemptKey) {
-            keyTwo = std::make_pair(attemptKey.ToString(), true);
-        }
-
-        if (GenericVerifyInstruction(consentToken, attemptKey, message, 3) && xKey == attemptKey) {
-            keyThree = std::make_pair(attemptKey.ToString(), true);
-        }
-    }
-
-    bool fValid = (keyOne.first.ToString() != keyTwo.first.ToString() && keyTwo.first.ToString() != keyThree.first.ToString() && keyOne.first.ToString() != keyThree.first.ToString());
-
-    LogPrint("fluid", "CheckIfQuorumExists(): Addresses validating this consent token are: %s, %s and %s\n", keyOne.first.ToString(), keyTwo.first.ToString(), keyThree.first.ToString());
-
-    if (individual)
-        return (keyOne.second || keyTwo.second || keyThree.second);
-    else if (fValid)
-        return (keyOne.second && keyTwo.second && keyThree.second);
+    CFluidInstructionRef instruction = GetFluidInstruction(consentToken);
+    message = instruction->strMessage;
+    return CheckIfQuorumExists(*instruction, individual);
+}
 
-    return false;
+/** Checks a decoded instruction against the current sovereign addresses */
+bool CFluid::CheckIfQuorumExists(const CFluidInstruction& instruction, bool individual)
+{
+    return instruction.CheckQuorum(InitialiseAddresses(), individual);
 }
 
 
@@ -296,66 +273,33 @@ bool CFluid::GenericConsentMessage(std::string message, std::string& signedStrin
 /** Extract timestamp from a Fluid Transaction */
 bool CFluid::ExtractCheckTimestamp(const std::string consentToken, const int64_t timeStamp)
 {
-    std::string consentTokenNoScript = GetRidOfScriptStatement(consentToken);
-    std::string dehexString = HexToString(consentTokenNoScript);
-    std::vector<std::string> strs, ptrs;
-    SeparateString(dehexString, strs, false);
-    SeparateString(strs.at(0), ptrs, true);
-
-    if (1 >= (int)strs.size())
-        return false;
-
-    std::string ls = ptrs.at(1);
-
-    ScrubString(ls, true);
-    int64_t tokenTimeStamp;
-    ParseInt64(ls, &tokenTimeStamp);
-
-    if (timeStamp > tokenTimeStamp + fluid.MAX_FLUID_TIME_DISTORT)
-        return false;
-
-    return true;
+    return GetFluidInstruction(consentToken)->CheckTimestamp(timeStamp);
 }
 
-bool CFluid::ProcessFluidToken(const std::string consentToken, std::vector<std::string>& ptrs, int strVecNo)
+bool CFluid::ExtractCheckTimestamp(const CScript& fluidScript, const int64_t timeStamp)
 {
-    std::string consentTokenNoScript = GetRidOfScriptStatement(consentToken);
-
-    std::string message;
-    if (!CheckNonScriptQuorum(consentTokenNoScript, message))
-        return false;
-
-    std::string dehexString = HexToString(consentTokenNoScript);
-
-    std::vector<std::string> strs;
-    SeparateString(dehexString, strs, false);
-    SeparateString(strs.at(0), ptrs, true);
-
-    if (strVecNo >= (int)strs.size())
-        return false;
-
-    return true;
+    return GetFluidInstruction(fluidScript)->CheckTimestamp(timeStamp);
 }
 
 /** It gets a number from the ASM of an OP_CODE without signature verification */
 bool CFluid::GenericParseNumber(const std::string consentToken, const int64_t timeStamp, CAmount& coinAmount, bool txCheckPurpose)
 {
-    std::vector<std::string> ptrs;
+    return GenericParseNumber(*GetFluidInstruction(consentToken), timeStamp, coinAmount, txCheckPurpose);
+}
 
-    if (!ProcessFluidToken(consentToken, ptrs, 1))
+bool CFluid::GenericParseNumber(const CFluidInstruction& instruction, const int64_t timeStamp, CAmount& coinAmount, bool txCheckPurpose)
+{
+    if (!CheckIfQuorumExists(instruction))
         return false;
 
-    std::string lr = ptrs.at(0);
-    ScrubString(lr, true);
-    std::string ls = ptrs.at(1);
-    ScrubString(ls, true);
-    int64_t tokenTimeStamp;
-    ParseInt64(ls, &tokenTimeStamp);
+    if (instruction.vSignatures.empty() || instruction.vMessageFields.size() < 2)
+        return false;
 
-    if (timeStamp > tokenTimeStamp + fluid.MAX_FLUID_TIME_DISTORT && !txCheckPurpose)
+    if (!txCheckPurpose && !instruction.CheckTimestamp(timeStamp))
         return false;
 
-    ParseFixedPoint(lr, 8, &coinAmount);
+    if (instruction.fScrubbedAmount)
+        coinAmount = instruction.nScrubbedAmount;
 
     return true;
 }
@@ -367,7 +311,7 @@ CDynamicAddress CFluid::GetAddressFromDigestSignature(const std::string digestSi
 
     if (fInvalid) {
         LogPrintf("GenericVerifyInstruction(): Digest Signature Found Invalid, Signature: %s \n", digestSignature);
-        return nullptr;
+        return CDynamicAddress();
     }
 
     CHashWriter ss(SER_GETHASH, 0);
@@ -378,7 +322,7 @@ CDynamicAddress CFluid::GetAddressFromDigestSignature(const std::string digestSi
 
     if (!pubkey.RecoverCompact(ss.GetHash(), vchSig)) {
         LogPrintf("GenericVerifyInstruction(): Public Key Recovery Failed! Hash: %s\n", ss.GetHash().ToString());
-        return nullptr;
+        return CDynamicAddress();
     }
     CDynamicAddress newAddress;
     newAddress.Set(pubkey.GetID());
@@ -410,33 +354,29 @@ bool CFluid::GenericVerifyInstruction(const std::string consentToken, CDynamicAd
 
 bool CFluid::ParseMintKey(const int64_t nTime, CDynamicAddress& destination, CAmount& coinAmount, std::string uniqueIdentifier, bool txCheckPurpose)
 {
-    std::vector<std::string> ptrs;
+    return ParseMintKey(nTime, destination, coinAmount, *GetFluidInstruction(uniqueIdentifier), txCheckPurpose);
+}
 
-    if (!ProcessFluidToken(uniqueIdentifier, ptrs, 1))
+bool CFluid::ParseMintKey(const int64_t nTime, CDynamicAddress& destination, CAmount& coinAmount, const CFluidInstruction& instruction, bool txCheckPurpose)
+{
+    if (!CheckIfQuorumExists(instruction))
         return false;
 
-    if (2 >= (int)ptrs.size())
+    if (instruction.vSignatures.empty() || instruction.vMessageFields.size() < 3)
         return false;
 
-    std::string lr = ptrs.at(0);
-    ScrubString(lr, true);
-    std::string ls = ptrs.at(1);
-    ScrubString(ls, true);
-    int64_t tokenTimeStamp;
-    ParseInt64(ls, &tokenTimeStamp);
-
-    if (nTime > tokenTimeStamp + fluid.MAX_FLUID_TIME_DISTORT && !txCheckPurpose)
+    if (!txCheckPurpose && !instruction.CheckTimestamp(nTime))
         return false;
 
-    ParseFixedPoint(lr, 8, &coinAmount);
+    if (instruction.fScrubbedAmount)
+        coinAmount = instruction.nScrubbedAmount;
 
-    std::string recipientAddress = ptrs.at(2);
-    destination.SetString(recipientAddress);
+    destination.SetString(instruction.GetDestination());
 
     if (!destination.IsValid())
         return false;
 
-    LogPrintf("ParseMintKey(): Token Data -- Address %s | Coins to be minted: %s | Time: %s\n", ptrs.at(2), coinAmount / COIN, ls);
+    LogPrintf("ParseMintKey(): Token Data -- Address %s | Coins to be minted: %s | Time: %s\n", instruction.GetDestination(), coinAmount / COIN, instruction.nScrubbedTimeStamp);
 
     return true;
 }
@@ -467,9 +407,9 @@ bool CFluid::GetMintingInstructions(const CBlockIndex* pblockindex, CDynamicAddr
         for (const CTransactionRef& tx : block.vtx) {
             for (const CTxOut& txout : tx->vout) {
                 if (txout.scriptPubKey.IsProtocolInstruction(MINT_TX)) {
-                    std::string message;
-                    if (CheckIfQuorumExists(ScriptToAsmStr(txout.scriptPubKey), message))
-                        return ParseMintKey(block.nTime, toMintAddress, mintAmount, ScriptToAsmStr(txout.scriptPubKey));
+                    CFluidInstructionRef instruction = GetFluidInstruction(txout.scriptPubKey);
+                    if (CheckIfQuorumExists(*instruction))
+                        return ParseMintKey(block.nTime, toMintAddress, mintAmount, *instruction);
                 }
             }
         }
@@ -484,9 +424,9 @@ bool CFluid::GetProofOverrideRequest(const CBlockIndex* pblockindex, CAmount& co
         for (const CTransactionRef& tx : block.vtx) {
             for (const CTxOut& txout : tx->vout) {
                 if (txout.scriptPubKey.IsProtocolInstruction(MINING_MODIFY_TX)) {
-                    std::string message;
-                    if (CheckIfQuorumExists(ScriptToAsmStr(txout.scriptPubKey), message))
-                        return GenericParseNumber(ScriptToAsmStr(txout.scriptPubKey), block.nTime, coinAmount);
+                    CFluidInstructionRef instruction = GetFluidInstruction(txout.scriptPubKey);
+                    if (CheckIfQuorumExists(*instruction))
+                        return GenericParseNumber(*instruction, block.nTime, coinAmount);
                 }
             }
         }
@@ -501,9 +441,9 @@ bool CFluid::GetDynodeOverrideRequest(const CBlockIndex* pblockindex, CAmount& c
         for (const CTransactionRef& tx : block.vtx) {
             for (const CTxOut& txout : tx->vout) {
                 if (txout.scriptPubKey.IsProtocolInstruction(DYNODE_MODFIY_TX)) {
-                    std::string message;
-                    if (CheckIfQuorumExists(ScriptToAsmStr(txout.scriptPubKey), message))
-                        return GenericParseNumber(ScriptToAsmStr(txout.scriptPubKey), block.nTime, coinAmount);
+                    CFluidInstructionRef instruction = GetFluidInstruction(txout.scriptPubKey);
+                    if (CheckIfQuorumExists(*instruction))
+                        return GenericParseNumber(*instruction, block.nTime, coinAmount);
                 }
             }
         }
@@ -548,10 +488,9 @@ bool CFluid::CheckTransactionInRecord(CScript fluidInstruction, CBlockIndex* pin
         }
         */
         std::vector<std::string> transactionRecord; //fluidIndex.fluidHistory;
-        verificationString = ScriptToAsmStr(fluidInstruction);
-        std::string verificationWithoutOpCode = GetRidOfScriptStatement(verificationString);
-        std::string message;
-        if (CheckIfQuorumExists(verificationString, message)) {
+        if (!transactionRecord.empty() && CheckIfQuorumExists(*GetFluidInstruction(fluidInstruction))) {
+            verificationString = ScriptToAsmStr(fluidInstruction);
+            std::string verificationWithoutOpCode = GetRidOfScriptStatement(verificationString);
             for (const std::string& existingRecord : transactionRecord) {
                 std::string existingWithoutOpCode = GetRidOfScriptStatement(existingRecord);
                 LogPrint("fluid", "CheckTransactionInRecord(): operation code removed. existingRecord  = %s verificationString = %s\n", existingWithoutOpCode, verificationWithoutOpCode);
@@ -572,10 +511,8 @@ bool CFluid::InsertTransactionToRecord(CScript fluidInstruction, std::vector<std
     std::string verificationString;
 
     if (IsTransactionFluid(fluidInstruction)) {
-        verificationString = ScriptToAsmStr(fluidInstruction);
-
-        std::string message;
-        if (CheckIfQuorumExists(verificationString, message)) {
+        if (CheckIfQuorumExists(*GetFluidInstruction(fluidInstruction))) {
+            verificationString = ScriptToAsmStr(fluidInstruction);
             for (const std::string& existingRecord : transactionRecord) {
                 if (existingRecord == verificationString) {
                     return false;
@@ -617,23 +554,23 @@ CAmount GetStandardDynodePayment(const int nHeight)
 
 bool CFluid::ValidationProcesses(CValidationState& state, CScript txOut, CAmount txValue)
 {
-    std::string message;
     CAmount mintAmount;
     CDynamicAddress toMintAddress;
 
     if (IsTransactionFluid(txOut)) {
-        if (!CheckIfQuorumExists(ScriptToAsmStr(txOut), message)) {
+        CFluidInstructionRef instruction = GetFluidInstruction(txOut);
+        if (!CheckIfQuorumExists(*instruction)) {
             return state.DoS(100, false, REJECT_INVALID, "bad-txns-fluid-auth-failure");
         }
 
         if (txOut.IsProtocolInstruction(MINT_TX) &&
-            !ParseMintKey(0, toMintAddress, mintAmount, ScriptToAsmStr(txOut), true)) {
+            !ParseMintKey(0, toMintAddress, mintAmount, *instruction, true)) {
             return state.DoS(100, false, REJECT_INVALID, "bad-txns-fluid-mint-auth-failure");
         }
 
         if ((txOut.IsProtocolInstruction(DYNODE_MODFIY_TX) ||
                 txOut.IsProtocolInstruction(MINING_MODIFY_TX)) &&
-            !GenericParseNumber(ScriptToAsmStr(txOut), 0, mintAmount, true)) {
+            !GenericParseNumber(*instruction, 0, mintAmount, true)) {
             return state.DoS(100, false, REJECT_INVALID, "bad-txns-fluid-modify-parse-failure");
         }
     }
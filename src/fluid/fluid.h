@@ -19,6 +19,7 @@
 #include <boost/lexical_cast.hpp>
 
 class CBlock;
+class CFluidInstruction;
 class CTxMemPool;
 struct CBlockTemplate;
 class CTransaction;
@@ -54,16 +55,19 @@ public:
     bool CheckFluidOperationScript(const CScript& fluidScriptPubKey, const int64_t timeStamp, std::string& errorMessage, bool fSkipTimeStampCheck = false);
     bool CheckIfExistsInMemPool(const CTxMemPool& pool, const CScript& fluidScriptPubKey, std::string& errorMessage);
     bool CheckIfQuorumExists(const std::string consentToken, std::string& message, bool individual = false);
+    bool CheckIfQuorumExists(const CFluidInstruction& instruction, bool individual = false);
     bool CheckNonScriptQuorum(const std::string consentToken, std::string& message, bool individual = false);
     bool CheckTransactionInRecord(CScript fluidInstruction, CBlockIndex* pindex = NULL);
 
     bool GenericConsentMessage(std::string message, std::string& signedString, CDynamicAddress signer);
     bool GenericParseNumber(const std::string consentToken, const int64_t timeStamp, CAmount& howMuch, bool txCheckPurpose = false);
+    bool GenericParseNumber(const CFluidInstruction& instruction, const int64_t timeStamp, CAmount& howMuch, bool txCheckPurpose = false);
     bool GenericVerifyInstruction(const std::string consentToken, CDynamicAddress& signer, std::string& messageTokenKey, int whereToLook = 1);
 
     bool ExtractCheckTimestamp(const std::string consentToken, const int64_t timeStamp);
+    bool ExtractCheckTimestamp(const CScript& fluidScript, const int64_t timeStamp);
     bool ParseMintKey(const int64_t nTime, CDynamicAddress& destination, CAmount& coinAmount, std::string uniqueIdentifier, bool txCheckPurpose = false);
-    bool ProcessFluidToken(const std::string consentToken, std::vector<std::string>& ptrs, int strVecNo);
+    bool ParseMintKey(const int64_t nTime, CDynamicAddress& destination, CAmount& coinAmount, const CFluidInstruction& instruction, bool txCheckPurpose = false);
 
     bool GetMintingInstructions(const CBlockIndex* pblockindex, CDynamicAddress& toMintAddress, CAmount& mintAmount);
     bool GetProofOverrideRequest(const CBlockIndex* pblockindex, CAmount& howMuch);
@@ -87,6 +91,8 @@ void BuildFluidInformationIndex(CBlockIndex* pindex, CAmount& nExpectedBlockValu
 bool IsTransactionFluid(const CScript& txOut);
 bool IsTransactionFluid(const CTransaction& tx, CScript& fluidScript);
 int GetFluidOpCode(const CScript& fluidScript);
+bool GetFluidToken(const CScript& fluidScript, std::vector<unsigned char>& vchToken);
+bool GetFluidInstructionHash(const CScript& fluidScript, uint256& hashInstruction);
 
 std::vector<unsigned char> CharVectorFromString(const std::string& str);
 std::string StringFromCharVector(const std::vector<unsigned char>& vch);
@@ -5,6 +5,7 @@
 #include "base58.h"
 #include "fluid.h"
 #include "fluiddynode.h"
+#include "fluidinstruction.h"
 #include "fluidmining.h"
 #include "fluidmint.h"
 #include "fluidsovereign.h"
@@ -166,47 +167,12 @@ bool GetLastFluidSovereignAddressStrings(std::vector<std::string>& sovereignAddr
 /** Checks whether 3 of 5 sovereign addresses signed the token in the script to meet the quorum requirements */
 bool CheckSignatureQuorum(const std::vector<unsigned char>& vchFluidScript, std::string& errMessage, bool individual)
 {
-    std::string consentToken = StringFromCharVector(vchFluidScript);
     std::vector<std::string> fluidSovereigns;
     if (!GetLastFluidSovereignAddressStrings(fluidSovereigns)) {
         return false;
     }
 
-    std::pair<CDynamicAddress, bool> keyOne;
-    std::pair<CDynamicAddress, bool> keyTwo;
-    std::pair<CDynamicAddress, bool> keyThree;
-    keyOne.second = false;
-    keyTwo.second = false;
-    keyThree.second = false;
-
-    for (const std::string& sovereignAddress : fluidSovereigns) {
-        CDynamicAddress attemptKey;
-        CDynamicAddress xKey(sovereignAddress);
-
-        if (!xKey.IsValid())
-            return false;
-        CFluid fluid;
-        if (fluid.GenericVerifyInstruction(consentToken, attemptKey, errMessage, 1) && xKey == attemptKey) {
-            keyOne = std::make_pair(attemptKey.ToString(), true);
-        }
-
-        if (fluid.GenericVerifyInstruction(consentToken, attemptKey, errMessage, 2) && xKey == attemptKey) {
-            keyTwo = std::make_pair(attemptKey.ToString(), true);
-        }
-
-        if (fluid.GenericVerifyInstruction(consentToken, attemptKey, errMessage, 3) && xKey == attemptKey) {
-            keyThree = std::make_pair(attemptKey.ToString(), true);
-        }
-    }
-
-    bool fValid = (keyOne.first.ToString() != keyTwo.first.ToString() && keyTwo.first.ToString() != keyThree.first.ToString() && keyOne.first.ToString() != keyThree.first.ToString());
-
-    LogPrint("fluid", "CheckSignatureQuorum(): Addresses validating this consent token are: %s, %s and %s\n", keyOne.first.ToString(), keyTwo.first.ToString(), keyThree.first.ToString());
-
-    if (individual)
-        return (keyOne.second || keyTwo.second || keyThree.second);
-    else if (fValid)
-        return (keyOne.second && keyTwo.second && keyThree.second);
-
-    return false;
+    CFluidInstructionRef instruction = GetFluidInstruction(StringFromCharVector(vchFluidScript));
+    errMessage = instruction->strMessage;
+    return instruction->CheckQuorum(fluidSovereigns, individual);
 }
\ No newline at end of file
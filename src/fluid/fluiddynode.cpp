@@ -5,6 +5,7 @@
 
 #include "core_io.h"
 #include "fluid.h"
+#include "fluidinstruction.h"
 #include "operations.h"
 #include "script/script.h"
 
@@ -14,34 +15,23 @@ CFluidDynodeDB* pFluidDynodeDB = NULL;
 
 bool GetFluidDynodeData(const CScript& scriptPubKey, CFluidDynode& entry)
 {
-    std::string fluidOperationString = ScriptToAsmStr(scriptPubKey);
-    std::string strOperationCode = GetRidOfScriptStatement(fluidOperationString, 0);
-    std::string verificationWithoutOpCode = GetRidOfScriptStatement(fluidOperationString);
-    std::vector<std::string> splitString;
-    HexFunctions hexConvert;
-    hexConvert.ConvertToString(verificationWithoutOpCode);
-    SeparateString(verificationWithoutOpCode, splitString, false);
-    std::string messageTokenKey = splitString.at(0);
-    std::vector<std::string> vecSplitScript;
-    SeparateFluidOpString(verificationWithoutOpCode, vecSplitScript);
-
-    if (vecSplitScript.size() == 5 && strOperationCode == "OP_REWARD_DYNODE") {
-        std::vector<unsigned char> vchFluidOperation = CharVectorFromString(fluidOperationString);
+    if (GetFluidOpCode(scriptPubKey) != OP_REWARD_DYNODE)
+        return false;
+
+    CFluidInstructionRef instruction = GetFluidInstruction(scriptPubKey);
+    if (instruction->vMessageFields.size() + instruction->vSignatures.size() == 5 && instruction->vSigners.size() == 3) {
+        std::vector<unsigned char> vchFluidOperation = CharVectorFromString(ScriptToAsmStr(scriptPubKey));
         entry.FluidScript.insert(entry.FluidScript.end(), vchFluidOperation.begin(), vchFluidOperation.end());
-        std::string strAmount = vecSplitScript[0];
-        CAmount fluidAmount;
-        if (ParseFixedPoint(strAmount, 8, &fluidAmount)) {
-            entry.DynodeReward = fluidAmount;
+        const std::string& strAmount = instruction->vMessageFields[0];
+        if (instruction->fAmount) {
+            entry.DynodeReward = instruction->nAmount;
         }
-        std::string strTimeStamp = vecSplitScript[1];
-        int64_t tokenTimeStamp;
-        if (ParseInt64(strTimeStamp, &tokenTimeStamp)) {
-            entry.nTimeStamp = tokenTimeStamp;
+        if (instruction->fTimeStamp) {
+            entry.nTimeStamp = instruction->nTimeStamp;
         }
         entry.SovereignAddresses.clear();
-        entry.SovereignAddresses.push_back(CharVectorFromString(fluid.GetAddressFromDigestSignature(vecSplitScript[2], messageTokenKey).ToString()));
-        entry.SovereignAddresses.push_back(CharVectorFromString(fluid.GetAddressFromDigestSignature(vecSplitScript[3], messageTokenKey).ToString()));
-        entry.SovereignAddresses.push_back(CharVectorFromString(fluid.GetAddressFromDigestSignature(vecSplitScript[4], messageTokenKey).ToString()));
+        for (const CDynamicAddress& signer : instruction->vSigners)
+            entry.SovereignAddresses.push_back(CharVectorFromString(signer.ToString()));
 
         LogPrintf("GetFluidDynodeData: strAmount = %s, strTimeStamp = %d, Addresses1 = %s, Addresses2 = %s, Addresses3 = %s \n",
             strAmount, entry.nTimeStamp, StringFromCharVector(entry.SovereignAddresses[0]),
@@ -0,0 +1,150 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "fluidinstruction.h"
+
+#include "fluid.h"
+#include "hash.h"
+#include "operations.h"
+#include "script/script.h"
+#include "sync.h"
+#include "util.h"
+#include "utilstrencodings.h"
+
+#include <list>
+#include <map>
+
+static CCriticalSection cs_fluidInstructions;
+static std::map<uint256, CFluidInstructionRef> mapFluidInstructions;
+static std::list<uint256> listFluidInstructions;
+
+void CFluidInstruction::SetNull()
+{
+    strMessage.clear();
+    vMessageFields.clear();
+    vSignatures.clear();
+    vSigners.clear();
+    fAmount = false;
+    nAmount = 0;
+    fTimeStamp = false;
+    nTimeStamp = 0;
+    fScrubbedAmount = false;
+    nScrubbedAmount = 0;
+    fScrubbedTimeStamp = false;
+    nScrubbedTimeStamp = 0;
+}
+
+void CFluidInstruction::Decode(const std::string& strToken)
+{
+    SetNull();
+    std::vector<std::string> vParts;
+    SeparateString(strToken, vParts);
+    strMessage = vParts.at(0);
+    vSignatures.assign(vParts.begin() + 1, vParts.end());
+    SeparateString(strMessage, vMessageFields, true);
+
+    std::string strAmount = vMessageFields.at(0);
+    fAmount = ParseFixedPoint(strAmount, 8, &nAmount);
+    ScrubString(strAmount, true);
+    fScrubbedAmount = ParseFixedPoint(strAmount, 8, &nScrubbedAmount);
+    if (vMessageFields.size() > 1) {
+        std::string strTimeStamp = vMessageFields[1];
+        fTimeStamp = ParseInt64(strTimeStamp, &nTimeStamp);
+        ScrubString(strTimeStamp, true);
+        fScrubbedTimeStamp = ParseInt64(strTimeStamp, &nScrubbedTimeStamp);
+    }
+
+    // Quorum checks only ever look at the first three digests
+    for (size_t i = 0; i < vSignatures.size() && i < 3; i++)
+        vSigners.push_back(fluid.GetAddressFromDigestSignature(vSignatures[i], strMessage));
+}
+
+std::string CFluidInstruction::GetDestination() const
+{
+    if (vMessageFields.size() < 3)
+        return "";
+    return vMessageFields[2];
+}
+
+bool CFluidInstruction::CheckTimestamp(const int64_t timeStamp) const
+{
+    if (vSignatures.empty() || !fScrubbedTimeStamp)
+        return false;
+
+    return timeStamp <= nScrubbedTimeStamp + CFluidParameters::MAX_FLUID_TIME_DISTORT;
+}
+
+bool CFluidInstruction::CheckQuorum(const std::vector<std::string>& vSovereigns, bool individual) const
+{
+    std::pair<CDynamicAddress, bool> keys[3];
+    for (const std::string& strSovereign : vSovereigns) {
+        CDynamicAddress sovereignAddress(strSovereign);
+        if (!sovereignAddress.IsValid())
+            return false;
+
+        for (size_t i = 0; i < vSigners.size(); i++) {
+            if (vSigners[i] == sovereignAddress)
+                keys[i] = std::make_pair(sovereignAddress, true);
+        }
+    }
+
+    std::string strKeyOne = keys[0].first.ToString();
+    std::string strKeyTwo = keys[1].first.ToString();
+    std::string strKeyThree = keys[2].first.ToString();
+    bool fValid = (strKeyOne != strKeyTwo && strKeyTwo != strKeyThree && strKeyOne != strKeyThree);
+
+    LogPrint("fluid", "%s: Addresses validating this consent token are: %s, %s and %s\n", __func__, strKeyOne, strKeyTwo, strKeyThree);
+
+    if (individual)
+        return (keys[0].second || keys[1].second || keys[2].second);
+    else if (fValid)
+        return (keys[0].second && keys[1].second && keys[2].second);
+
+    return false;
+}
+
+static CFluidInstructionRef DecodeFluidToken(const std::string& strToken)
+{
+    uint256 hashInstruction = Hash(strToken.begin(), strToken.end());
+    {
+        LOCK(cs_fluidInstructions);
+        std::map<uint256, CFluidInstructionRef>::const_iterator it = mapFluidInstructions.find(hashInstruction);
+        if (it != mapFluidInstructions.end())
+            return it->second;
+    }
+
+    // Decode without holding the lock, recovering the signers is the expensive part
+    std::shared_ptr<CFluidInstruction> instruction = std::make_shared<CFluidInstruction>();
+    instruction->Decode(strToken);
+
+    LOCK(cs_fluidInstructions);
+    if (mapFluidInstructions.emplace(hashInstruction, instruction).second) {
+        listFluidInstructions.push_back(hashInstruction);
+        if (listFluidInstructions.size() > FLUID_INSTRUCTION_CACHE_SIZE) {
+            mapFluidInstructions.erase(listFluidInstructions.front());
+            listFluidInstructions.pop_front();
+        }
+    }
+    return instruction;
+}
+
+CFluidInstructionRef GetFluidInstruction(const CScript& fluidScript)
+{
+    std::vector<unsigned char> vchToken;
+    if (!GetFluidToken(fluidScript, vchToken))
+        return std::make_shared<const CFluidInstruction>();
+
+    return DecodeFluidToken(std::string(vchToken.begin(), vchToken.end()));
+}
+
+CFluidInstructionRef GetFluidInstruction(const std::string& strFluidScript)
+{
+    size_t nBegin = strFluidScript.find(' ');
+    if (nBegin == std::string::npos)
+        return std::make_shared<const CFluidInstruction>();
+
+    size_t nEnd = strFluidScript.find(' ', nBegin + 1);
+    std::string strHexToken = strFluidScript.substr(nBegin + 1, nEnd == std::string::npos ? std::string::npos : nEnd - nBegin - 1);
+    return DecodeFluidToken(HexFunctions().HexToString(strHexToken));
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef FLUID_INSTRUCTION_H
+#define FLUID_INSTRUCTION_H
+
+#include "amount.h"
+#include "base58.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class CScript;
+
+/** Number of fluid instructions kept decoded */
+static const size_t FLUID_INSTRUCTION_CACHE_SIZE = 1000;
+
+/**
+ * The operand of a fluid script, decoded once.
+ *
+ * A fluid token is "message@signature1@signature2@signature3" where the message
+ * is "amount$timestamp" or "amount$timestamp$address". The signers are recovered
+ * while decoding, so the checks run from CheckTransaction, AcceptToMemoryPool,
+ * CheckBlock and ConnectBlock neither re-parse the token nor repeat the public
+ * key recovery.
+ */
+class CFluidInstruction
+{
+public:
+    // Signed part of the token and its fields split at the sub delimiter
+    std::string strMessage;
+    std::vector<std::string> vMessageFields;
+    // Base64 digests following the message
+    std::vector<std::string> vSignatures;
+    // Signers recovered from the first three digests, invalid if recovery failed
+    std::vector<CDynamicAddress> vSigners;
+
+    // Amount and timestamp fields parsed as they are, like CheckFluidOperationScript and the fluid databases do
+    bool fAmount;
+    CAmount nAmount;
+    bool fTimeStamp;
+    int64_t nTimeStamp;
+    // Same fields with spaces scrubbed first, like the timestamp check and the override and mint lookups do
+    bool fScrubbedAmount;
+    CAmount nScrubbedAmount;
+    bool fScrubbedTimeStamp;
+    int64_t nScrubbedTimeStamp;
+
+    CFluidInstruction()
+    {
+        SetNull();
+    }
+
+    void SetNull();
+    bool IsNull() const { return strMessage.empty() && vSignatures.empty(); }
+
+    void Decode(const std::string& strToken);
+
+    /** Destination address of a mint instruction */
+    std::string GetDestination() const;
+
+    /** Checks the instruction timestamp against the maximum fluid time distortion */
+    bool CheckTimestamp(const int64_t timeStamp) const;
+
+    /** Checks whether three different sovereigns signed the instruction, or any of them if individual */
+    bool CheckQuorum(const std::vector<std::string>& vSovereigns, bool individual = false) const;
+};
+
+typedef std::shared_ptr<const CFluidInstruction> CFluidInstructionRef;
+
+/** Returns the decoded operand of a fluid script, decoding it only on first use */
+CFluidInstructionRef GetFluidInstruction(const CScript& fluidScript);
+/** Same for a fluid script in assembly form, as kept by the fluid databases */
+CFluidInstructionRef GetFluidInstruction(const std::string& strFluidScript);
+
+#endif // FLUID_INSTRUCTION_H
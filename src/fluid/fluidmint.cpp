@@ -6,6 +6,7 @@
 #include "base58.h"
 #include "core_io.h"
 #include "fluid.h"
+#include "fluidinstruction.h"
 #include "operations.h"
 #include "script/script.h"
 
@@ -15,36 +16,25 @@ CFluidMintDB* pFluidMintDB = NULL;
 
 bool GetFluidMintData(const CScript& scriptPubKey, CFluidMint& entry)
 {
-    std::string fluidOperationString = ScriptToAsmStr(scriptPubKey);
-    std::string strOperationCode = GetRidOfScriptStatement(fluidOperationString, 0);
-    std::string verificationWithoutOpCode = GetRidOfScriptStatement(fluidOperationString);
-    std::vector<std::string> splitString;
-    HexFunctions hexConvert;
-    hexConvert.ConvertToString(verificationWithoutOpCode);
-    SeparateString(verificationWithoutOpCode, splitString, false);
-    std::string messageTokenKey = splitString.at(0);
-    std::vector<std::string> vecSplitScript;
-    SeparateFluidOpString(verificationWithoutOpCode, vecSplitScript);
-
-    if (vecSplitScript.size() >= 6 && strOperationCode == "OP_MINT") {
-        std::vector<unsigned char> vchFluidOperation = CharVectorFromString(fluidOperationString);
+    if (GetFluidOpCode(scriptPubKey) != OP_MINT)
+        return false;
+
+    CFluidInstructionRef instruction = GetFluidInstruction(scriptPubKey);
+    if (instruction->vMessageFields.size() + instruction->vSignatures.size() >= 6 && instruction->vSigners.size() == 3) {
+        std::vector<unsigned char> vchFluidOperation = CharVectorFromString(ScriptToAsmStr(scriptPubKey));
         entry.FluidScript.insert(entry.FluidScript.end(), vchFluidOperation.begin(), vchFluidOperation.end());
-        std::string strAmount = vecSplitScript[0];
-        CAmount fluidAmount;
-        if (ParseFixedPoint(strAmount, 8, &fluidAmount)) {
-            entry.MintAmount = fluidAmount;
+        const std::string& strAmount = instruction->vMessageFields[0];
+        if (instruction->fAmount) {
+            entry.MintAmount = instruction->nAmount;
         }
-        std::string strTimeStamp = vecSplitScript[1];
-        int64_t tokenTimeStamp;
-        if (ParseInt64(strTimeStamp, &tokenTimeStamp)) {
-            entry.nTimeStamp = tokenTimeStamp;
+        if (instruction->fTimeStamp) {
+            entry.nTimeStamp = instruction->nTimeStamp;
         }
-        std::vector<unsigned char> vchDestinationAddress = CharVectorFromString(vecSplitScript[2]);
-        entry.DestinationAddress.insert(entry.DestinationAddress.end(), vchDestinationAddress.begin(), vchDestinationAddress.end());
+        std::string strDestination = instruction->GetDestination();
+        entry.DestinationAddress.insert(entry.DestinationAddress.end(), strDestination.begin(), strDestination.end());
         entry.SovereignAddresses.clear();
-        entry.SovereignAddresses.push_back(CharVectorFromString(fluid.GetAddressFromDigestSignature(vecSplitScript[3], messageTokenKey).ToString()));
-        entry.SovereignAddresses.push_back(CharVectorFromString(fluid.GetAddressFromDigestSignature(vecSplitScript[4], messageTokenKey).ToString()));
-        entry.SovereignAddresses.push_back(CharVectorFromString(fluid.GetAddressFromDigestSignature(vecSplitScript[5], messageTokenKey).ToString()));
+        for (const CDynamicAddress& signer : instruction->vSigners)
+            entry.SovereignAddresses.push_back(CharVectorFromString(signer.ToString()));
 
         LogPrintf("GetFluidMintData: strAmount = %s, strTimeStamp = %d, DestinationAddress = %s, Addresses1 = %s, Addresses2 = %s, Addresses3 = %s \n",
             strAmount, entry.nTimeStamp,
@@ -211,6 +211,7 @@ void CGovernanceTriggerManager::CleanAndRemove()
                 if (pObj->nDeletionTime == 0) {
                     pObj->nDeletionTime = GetAdjustedTime();
                 }
+                governance.QueueForDeletion(*pObj);
             }
             // delete the trigger
             mapTrigger.erase(it++);
@@ -304,6 +305,9 @@ bool CSuperblockManager::IsSuperblockTriggered(int nBlockHeight)
         // MAKE SURE THIS TRIGGER IS ACTIVE VIA FUNDING CACHE FLAG
 
         pObj->UpdateSentinelVariables();
+        if (pObj->IsSetCachedDelete()) {
+            governance.QueueForDeletion(*pObj);
+        }
 
         if (pObj->IsSetCachedFunding()) {
             LogPrint("gobject", "CSuperblockManager::IsSuperblockTriggered -- fCacheFunding = true, returning true\n");
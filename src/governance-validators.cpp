@@ -63,6 +63,11 @@ bool CProposalValidator::Validate(bool fCheckExpiration)
     return true;
 }
 
+bool CProposalValidator::GetEndEpoch(int64_t& nEndEpochRet)
+{
+    return fJSONValid && GetDataValue("end_epoch", nEndEpochRet);
+}
+
 bool CProposalValidator::ValidateName()
 {
     std::string strName;
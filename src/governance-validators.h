@@ -22,6 +22,9 @@ public:
 
     bool Validate(bool fCheckExpiration = true);
 
+    /// The time after which Validate() fails with "expired", false if the proposal has no end_epoch
+    bool GetEndEpoch(int64_t& nEndEpochRet);
+
     const std::string& GetErrorMessages()
     {
         return strErrorMessages;
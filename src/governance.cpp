@@ -36,6 +36,11 @@ CGovernanceManager::CGovernanceManager()
       mapErasedGovernanceObjects(),
       mapDynodeOrphanObjects(),
       cmapVoteToObject(MAX_CACHE_SIZE),
+      mapObjectVotes(),
+      setDirtyObjects(),
+      mmapDeletionQueue(),
+      mmapProposalExpiry(),
+      mmapErasedExpiry(),
       cmapInvalidVotes(MAX_CACHE_SIZE),
       cmmapOrphanVotes(MAX_CACHE_SIZE),
       mapLastDynodeObject(),
@@ -285,6 +290,7 @@ void CGovernanceManager::CheckOrphanVotes(CGovernanceObject& govobj, CGovernance
             fRemove = true;
         } else if (govobj.ProcessVote(nullptr, vote, exception, connman)) {
             vote.Relay(connman);
+            setDirtyObjects.insert(nHash);
             fRemove = true;
         }
         if (fRemove) {
@@ -341,9 +347,17 @@ void CGovernanceManager::AddGovernanceObject(CGovernanceObject& govobj, CConnman
             if (objref.nDeletionTime == 0) {
                 objref.nDeletionTime = GetAdjustedTime();
             }
+            QueueForDeletion(objref);
             return;
         }
         DBG(std::cout << "CGovernanceManager::AddGovernanceObject After AddNewTrigger" << std::endl;);
+    } else if (govobj.nObjectType == GOVERNANCE_OBJECT_PROPOSAL) {
+        QueueProposalExpiry(govobj);
+    }
+
+    setDirtyObjects.insert(nHash);
+    if (govobj.IsSetCachedDelete()) {
+        QueueForDeletion(govobj);
     }
 
     LogPrintf("CGovernanceManager::AddGovernanceObject -- %s new, received from %s\n", strHash, pfrom ? pfrom->GetAddrName() : "nullptr");
@@ -381,6 +395,7 @@ void CGovernanceManager::UpdateCachesAndClean()
         }
         it->second.ClearDynodeVotes();
         it->second.fDirtyCache = true;
+        setDirtyObjects.insert(it->first);
     }
 
     ScopedLockBool guard(cs, fRateChecksEnabled, false);
@@ -388,21 +403,18 @@ void CGovernanceManager::UpdateCachesAndClean()
     // Clean up any expired or invalid triggers
     triggerman.CleanAndRemove();
 
-    object_m_it it = mapObjects.begin();
     int64_t nNow = GetAdjustedTime();
 
-    while (it != mapObjects.end()) {
-        CGovernanceObject* pObj = &((*it).second);
-
-        if (!pObj) {
-            ++it;
+    // Only objects which got new votes or lost dynode votes since the last pass need their caches updated
+    hash_s_it dirty_it = setDirtyObjects.begin();
+    while (dirty_it != setDirtyObjects.end()) {
+        object_m_it it = mapObjects.find(*dirty_it);
+        if (it == mapObjects.end()) {
+            setDirtyObjects.erase(dirty_it++);
             continue;
         }
+        CGovernanceObject* pObj = &((*it).second);
 
-        uint256 nHash = it->first;
-        std::string strHash = nHash.ToString();
-
-        // IF CACHE IS NOT DIRTY, WHY DO THIS?
         if (pObj->IsSetDirtyCache()) {
             // UPDATE LOCAL VALIDITY AGAINST CRYPTO DATA
             pObj->UpdateLocalValidity();
@@ -411,69 +423,142 @@ void CGovernanceManager::UpdateCachesAndClean()
             pObj->UpdateSentinelVariables();
         }
 
-        // IF DELETE=TRUE, THEN CLEAN THE MESS UP!
+        if (pObj->IsSetCachedDelete() || pObj->IsSetExpired()) {
+            QueueForDeletion(*pObj);
+        }
 
-        int64_t nTimeSinceDeletion = nNow - pObj->GetDeletionTime();
+        // the cache stays dirty while there are no enabled dynodes to count votes against
+        if (pObj->IsSetDirtyCache()) {
+            ++dirty_it;
+        } else {
+            setDirtyObjects.erase(dirty_it++);
+        }
+    }
 
-        LogPrint("gobject", "CGovernanceManager::UpdateCachesAndClean -- Checking object for deletion: %s, deletion time = %d, time since deletion = %d, delete flag = %d, expired flag = %d\n",
-            strHash, pObj->GetDeletionTime(), nTimeSinceDeletion, pObj->IsSetCachedDelete(), pObj->IsSetExpired());
-
-        if ((pObj->IsSetCachedDelete() || pObj->IsSetExpired()) &&
-            (nTimeSinceDeletion >= GOVERNANCE_DELETION_DELAY)) {
-            LogPrint("gobject", "CGovernanceManager::UpdateCachesAndClean -- erase obj %s\n", (*it).first.ToString());
-            dnodeman.RemoveGovernanceObject(pObj->GetHash());
-
-            // Remove vote references
-            const object_ref_cm_t::list_t& listItems = cmapVoteToObject.GetItemList();
-            object_ref_cm_t::list_cit lit = listItems.begin();
-            while (lit != listItems.end()) {
-                if (lit->value == pObj) {
-                    uint256 nKey = lit->key;
-                    ++lit;
-                    cmapVoteToObject.Erase(nKey);
-                } else {
-                    ++lit;
-                }
-            }
+    // NOTE: triggers are handled via triggerman
+    while (!mmapProposalExpiry.empty() && mmapProposalExpiry.begin()->first <= nNow) {
+        uint256 nHash = mmapProposalExpiry.begin()->second;
+        mmapProposalExpiry.erase(mmapProposalExpiry.begin());
 
-            int64_t nTimeExpired{0};
+        object_m_it it = mapObjects.find(nHash);
+        if (it == mapObjects.end()) {
+            continue;
+        }
+        CGovernanceObject* pObj = &((*it).second);
 
-            if (pObj->GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL) {
-                // keep hashes of deleted proposals forever
-                nTimeExpired = std::numeric_limits<int64_t>::max();
-            } else {
-                int64_t nSuperblockCycleSeconds = Params().GetConsensus().nSuperblockCycle * Params().GetConsensus().nPowTargetSpacing;
-                nTimeExpired = pObj->GetCreationTime() + 2 * nSuperblockCycleSeconds + GOVERNANCE_DELETION_DELAY;
+        CProposalValidator validator(pObj->GetDataAsHexString());
+        if (!validator.Validate()) {
+            LogPrint("gobject", "CGovernanceManager::UpdateCachesAndClean -- set for deletion expired obj %s\n", nHash.ToString());
+            pObj->fCachedDelete = true;
+            if (pObj->nDeletionTime == 0) {
+                pObj->nDeletionTime = nNow;
             }
+            QueueForDeletion(*pObj);
+        }
+    }
 
-            mapErasedGovernanceObjects.insert(std::make_pair(nHash, nTimeExpired));
-            mapObjects.erase(it++);
-        } else {
-            // NOTE: triggers are handled via triggerman
-            if (pObj->GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL) {
-                CProposalValidator validator(pObj->GetDataAsHexString());
-                if (!validator.Validate()) {
-                    LogPrint("gobject", "CGovernanceManager::UpdateCachesAndClean -- set for deletion expired obj %s\n", (*it).first.ToString());
-                    pObj->fCachedDelete = true;
-                    if (pObj->nDeletionTime == 0) {
-                        pObj->nDeletionTime = nNow;
-                    }
-                }
-            }
-            ++it;
+    // IF DELETE=TRUE, THEN CLEAN THE MESS UP!
+    while (!mmapDeletionQueue.empty() && mmapDeletionQueue.begin()->first <= nNow) {
+        uint256 nHash = mmapDeletionQueue.begin()->second;
+        mmapDeletionQueue.erase(mmapDeletionQueue.begin());
+
+        object_m_it it = mapObjects.find(nHash);
+        if (it == mapObjects.end()) {
+            continue;
         }
+        CGovernanceObject* pObj = &((*it).second);
+
+        int64_t nTimeSinceDeletion = nNow - pObj->GetDeletionTime();
+
+        LogPrint("gobject", "CGovernanceManager::UpdateCachesAndClean -- Checking object for deletion: %s, deletion time = %d, time since deletion = %d, delete flag = %d, expired flag = %d\n",
+            nHash.ToString(), pObj->GetDeletionTime(), nTimeSinceDeletion, pObj->IsSetCachedDelete(), pObj->IsSetExpired());
+
+        if (nTimeSinceDeletion < GOVERNANCE_DELETION_DELAY) {
+            // the deletion time was pushed back after the object was queued
+            QueueForDeletion(*pObj);
+            continue;
+        }
+
+        EraseObject(it, nNow);
     }
 
     // forget about expired deleted objects
-    hash_time_m_it s_it = mapErasedGovernanceObjects.begin();
-    while (s_it != mapErasedGovernanceObjects.end()) {
-        if (s_it->second < nNow)
-            mapErasedGovernanceObjects.erase(s_it++);
-        else
-            ++s_it;
+    while (!mmapErasedExpiry.empty() && mmapErasedExpiry.begin()->first < nNow) {
+        hash_time_m_it s_it = mapErasedGovernanceObjects.find(mmapErasedExpiry.begin()->second);
+        if (s_it != mapErasedGovernanceObjects.end() && s_it->second < nNow) {
+            mapErasedGovernanceObjects.erase(s_it);
+        }
+        mmapErasedExpiry.erase(mmapErasedExpiry.begin());
     }
 
-    LogPrint("gobject", "CGovernanceManager::UpdateCachesAndClean -- %s\n", ToString());
+    if (LogAcceptCategory("gobject")) {
+        LogPrint("gobject", "CGovernanceManager::UpdateCachesAndClean -- %s\n", ToString());
+    }
+}
+
+void CGovernanceManager::EraseObject(object_m_it it, int64_t nNow)
+{
+    AssertLockHeld(cs);
+
+    const uint256 nHash = it->first;
+    CGovernanceObject* pObj = &((*it).second);
+
+    LogPrint("gobject", "CGovernanceManager::UpdateCachesAndClean -- erase obj %s\n", nHash.ToString());
+    dnodeman.RemoveGovernanceObject(nHash);
+
+    // Remove vote references
+    hash_s_m_t::iterator votes_it = mapObjectVotes.find(nHash);
+    if (votes_it != mapObjectVotes.end()) {
+        for (const uint256& nHashVote : votes_it->second) {
+            cmapVoteToObject.Erase(nHashVote);
+        }
+        mapObjectVotes.erase(votes_it);
+    }
+
+    int64_t nTimeExpired{0};
+
+    if (pObj->GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL) {
+        // keep hashes of deleted proposals forever
+        nTimeExpired = std::numeric_limits<int64_t>::max();
+    } else {
+        int64_t nSuperblockCycleSeconds = Params().GetConsensus().nSuperblockCycle * Params().GetConsensus().nPowTargetSpacing;
+        nTimeExpired = pObj->GetCreationTime() + 2 * nSuperblockCycleSeconds + GOVERNANCE_DELETION_DELAY;
+        mmapErasedExpiry.insert(std::make_pair(nTimeExpired, nHash));
+    }
+
+    mapErasedGovernanceObjects.insert(std::make_pair(nHash, nTimeExpired));
+    setDirtyObjects.erase(nHash);
+    mapObjects.erase(it);
+}
+
+void CGovernanceManager::QueueForDeletion(const CGovernanceObject& govobj)
+{
+    AssertLockHeld(cs);
+
+    int64_t nTimeErase = govobj.GetDeletionTime() + GOVERNANCE_DELETION_DELAY;
+    uint256 nHash = govobj.GetHash();
+
+    std::pair<time_hash_mm_t::iterator, time_hash_mm_t::iterator> range = mmapDeletionQueue.equal_range(nTimeErase);
+    for (time_hash_mm_t::iterator it = range.first; it != range.second; ++it) {
+        if (it->second == nHash) {
+            return;
+        }
+    }
+    mmapDeletionQueue.insert(range.second, std::make_pair(nTimeErase, nHash));
+}
+
+void CGovernanceManager::QueueProposalExpiry(const CGovernanceObject& govobj)
+{
+    AssertLockHeld(cs);
+
+    // Everything but the expiration is fixed by the object data, so proposals
+    // failing the other checks are due right away
+    CProposalValidator validator(govobj.GetDataAsHexString());
+    int64_t nEndEpoch = 0;
+    if (!validator.Validate(false) || !validator.GetEndEpoch(nEndEpoch)) {
+        nEndEpoch = 0;
+    }
+    mmapProposalExpiry.insert(std::make_pair(nEndEpoch, govobj.GetHash()));
 }
 
 CGovernanceObject* CGovernanceManager::FindGovernanceObject(const uint256& nHash)
@@ -888,6 +973,10 @@ bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote,
     }
 
     bool fOk = govobj.ProcessVote(pfrom, vote, exception, connman) && cmapVoteToObject.Insert(nHashVote, &govobj);
+    if (fOk) {
+        mapObjectVotes[nHashGovobj].insert(nHashVote);
+        setDirtyObjects.insert(nHashGovobj);
+    }
     LEAVE_CRITICAL_SECTION(cs);
     return fOk;
 }
@@ -900,6 +989,9 @@ void CGovernanceManager::CheckDynodeOrphanVotes(CConnman& connman)
 
     for (auto& objPair : mapObjects) {
         objPair.second.CheckOrphanVotes(connman);
+        if (objPair.second.IsSetDirtyCache()) {
+            setDirtyObjects.insert(objPair.first);
+        }
     }
 }
 
@@ -1191,11 +1283,43 @@ void CGovernanceManager::RebuildIndexes()
     LOCK(cs);
 
     cmapVoteToObject.Clear();
+    mapObjectVotes.clear();
     for (auto& objPair : mapObjects) {
         CGovernanceObject& govobj = objPair.second;
         std::vector<CGovernanceVote> vecVotes = govobj.GetVoteFile().GetVotes();
+        hash_s_t& setVotes = mapObjectVotes[objPair.first];
         for (size_t i = 0; i < vecVotes.size(); ++i) {
-            cmapVoteToObject.Insert(vecVotes[i].GetHash(), &govobj);
+            uint256 nHashVote = vecVotes[i].GetHash();
+            cmapVoteToObject.Insert(nHashVote, &govobj);
+            setVotes.insert(nHashVote);
+        }
+    }
+}
+
+void CGovernanceManager::RebuildMaintenanceQueues()
+{
+    LOCK(cs);
+
+    setDirtyObjects.clear();
+    mmapDeletionQueue.clear();
+    mmapProposalExpiry.clear();
+    mmapErasedExpiry.clear();
+
+    for (const auto& objPair : mapObjects) {
+        const CGovernanceObject& govobj = objPair.second;
+        if (govobj.IsSetDirtyCache()) {
+            setDirtyObjects.insert(objPair.first);
+        }
+        if (govobj.IsSetCachedDelete() || govobj.IsSetExpired()) {
+            QueueForDeletion(govobj);
+        } else if (govobj.GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL) {
+            QueueProposalExpiry(govobj);
+        }
+    }
+
+    for (const auto& erasedPair : mapErasedGovernanceObjects) {
+        if (erasedPair.second != std::numeric_limits<int64_t>::max()) {
+            mmapErasedExpiry.insert(std::make_pair(erasedPair.second, erasedPair.first));
         }
     }
 }
@@ -1216,6 +1340,7 @@ void CGovernanceManager::AddCachedTriggers()
             if (govobj.nDeletionTime == 0) {
                 govobj.nDeletionTime = GetAdjustedTime();
             }
+            QueueForDeletion(govobj);
         }
     }
 }
@@ -220,6 +220,10 @@ public: // Types
 
     typedef hash_time_m_t::const_iterator hash_time_m_cit;
 
+    typedef std::multimap<int64_t, uint256> time_hash_mm_t;
+
+    typedef std::map<uint256, hash_s_t> hash_s_m_t;
+
 private:
     static const int MAX_CACHE_SIZE = 1000000;
 
@@ -249,6 +253,24 @@ private:
 
     object_ref_cm_t cmapVoteToObject;
 
+    // reverse index of cmapVoteToObject: hashes of the votes known for each object
+    hash_s_m_t mapObjectVotes;
+
+    // The maintenance queues below let UpdateCachesAndClean touch only the
+    // objects that changed or are due, they are derived from mapObjects on load.
+
+    // objects whose cached validity and sentinel flags have to be recomputed
+    hash_s_t setDirtyObjects;
+
+    // objects flagged for deletion or expired, keyed by the time they can be erased
+    time_hash_mm_t mmapDeletionQueue;
+
+    // proposals keyed by their end_epoch, after which they are flagged for deletion
+    time_hash_mm_t mmapProposalExpiry;
+
+    // mapErasedGovernanceObjects entries keyed by their expiration time
+    time_hash_mm_t mmapErasedExpiry;
+
     vote_cm_t cmapInvalidVotes;
 
     vote_cmm_t cmmapOrphanVotes;
@@ -323,6 +345,11 @@ public:
         mapObjects.clear();
         mapErasedGovernanceObjects.clear();
         cmapVoteToObject.Clear();
+        mapObjectVotes.clear();
+        setDirtyObjects.clear();
+        mmapDeletionQueue.clear();
+        mmapProposalExpiry.clear();
+        mmapErasedExpiry.clear();
         cmapInvalidVotes.Clear();
         cmmapOrphanVotes.Clear();
         mapLastDynodeObject.clear();
@@ -354,6 +381,9 @@ public:
             Clear();
             return;
         }
+        if (ser_action.ForRead()) {
+            RebuildMaintenanceQueues();
+        }
     }
 
     void UpdatedBlockTip(const CBlockIndex* pindex, CConnman& connman);
@@ -404,6 +434,9 @@ public:
 
     void CheckPostponedObjects(CConnman& connman);
 
+    /// Queue an object flagged for deletion or expired to be erased GOVERNANCE_DELETION_DELAY after its deletion time
+    void QueueForDeletion(const CGovernanceObject& govobj);
+
     bool AreRateChecksEnabled() const
     {
         LOCK(cs);
@@ -442,6 +475,12 @@ private:
 
     void RebuildIndexes();
 
+    void RebuildMaintenanceQueues();
+
+    void QueueProposalExpiry(const CGovernanceObject& govobj);
+
+    void EraseObject(object_m_it it, int64_t nNow);
+
     void AddCachedTriggers();
 
     void RequestOrphanObjects(CConnman& connman);
@@ -211,6 +211,33 @@ public:
 static CCoinsViewErrorCatcher* pcoinscatcher = NULL;
 static std::unique_ptr<ECCVerifyHandle> globalVerifyHandle;
 
+/** Store the data caches into their dat files, also run periodically so a crash doesn't lose them */
+static void DumpCacheFiles(bool fVerify)
+{
+    CFlatDB<CDynodeMan> flatdb1("dncache.dat", "magicDynodeCache");
+    flatdb1.Dump(dnodeman, fVerify);
+    CFlatDB<CDynodePayments> flatdb2("dnpayments.dat", "magicDynodePaymentsCache");
+    flatdb2.Dump(dnpayments, fVerify);
+    CFlatDB<CGovernanceManager> flatdb3("governance.dat", "magicGovernanceCache");
+    flatdb3.Dump(governance, fVerify);
+    CFlatDB<CNetFulfilledRequestManager> flatdb4("netfulfilled.dat", "magicFulfilledCache");
+    flatdb4.Dump(netfulfilledman, fVerify);
+    if (fEnableInstantSend) {
+        CFlatDB<CInstantSend> flatdb5("instantsend.dat", "magicInstantSendCache");
+        flatdb5.Dump(instantsend, fVerify);
+    }
+    CFlatDB<CSporkManager> flatdb6("sporks.dat", "magicSporkCache");
+    flatdb6.Dump(sporkManager, fVerify);
+}
+
+/** Load one data cache without cleaning it, see the cache loading step of AppInitMain */
+template <typename T>
+static void LoadCacheFile(T& objToLoad, const std::string& strFilename, const std::string& strMagicMessage, bool& fLoadedRet)
+{
+    CFlatDB<T> flatdb(strFilename, strMagicMessage);
+    fLoadedRet = flatdb.Load(objToLoad, false);
+}
+
 void Interrupt(boost::thread_group& threadGroup)
 {
     InterruptHTTPServer();
@@ -266,20 +293,7 @@ void PrepareShutdown()
 
     if (!fLiteMode && !fRPCInWarmup) {
         // STORE DATA CACHES INTO SERIALIZED DAT FILES
-        CFlatDB<CDynodeMan> flatdb1("dncache.dat", "magicDynodeCache");
-        flatdb1.Dump(dnodeman);
-        CFlatDB<CDynodePayments> flatdb2("dnpayments.dat", "magicDynodePaymentsCache");
-        flatdb2.Dump(dnpayments);
-        CFlatDB<CGovernanceManager> flatdb3("governance.dat", "magicGovernanceCache");
-        flatdb3.Dump(governance);
-        CFlatDB<CNetFulfilledRequestManager> flatdb4("netfulfilled.dat", "magicFulfilledCache");
-        flatdb4.Dump(netfulfilledman);
-        if (fEnableInstantSend) {
-            CFlatDB<CInstantSend> flatdb5("instantsend.dat", "magicInstantSendCache");
-            flatdb5.Dump(instantsend);
-        }
-        CFlatDB<CSporkManager> flatdb6("sporks.dat", "magicSporkCache");
-        flatdb6.Dump(sporkManager);
+        DumpCacheFiles(true);
     }
 
     UnregisterNodeSignals(GetNodeSignals());
@@ -481,6 +495,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-maxreceivebuffer=<n>", strprintf(_("Maximum per-connection receive buffer, <n>*1000 bytes (default: %u)"), DEFAULT_MAXRECEIVEBUFFER));
     strUsage += HelpMessageOpt("-maxsendbuffer=<n>", strprintf(_("Maximum per-connection send buffer, <n>*1000 bytes (default: %u)"), DEFAULT_MAXSENDBUFFER));
     strUsage += HelpMessageOpt("-maxtimeadjustment", strprintf(_("Maximum allowed median peer time offset adjustment. Local perspective of time may be influenced by peers forward or backward by this amount. (default: %u seconds)"), DEFAULT_MAX_TIME_ADJUSTMENT));
+    strUsage += HelpMessageOpt("-msghandlerthreads=<n>", strprintf(_("Number of threads processing peer messages. With more than one, peers are spread over the threads and messages that need the chain state are handled by a separate validation queue (1-%d, default: %d)"), MAX_MSG_HANDLER_THREADS, DEFAULT_MSG_HANDLER_THREADS));
     strUsage += HelpMessageOpt("-onion=<ip:port>", strprintf(_("Use separate SOCKS5 proxy to reach peers via Tor hidden services (default: %s)"), "-proxy"));
     strUsage += HelpMessageOpt("-onlynet=<net>", _("Only connect to nodes in network <net> (ipv4, ipv6 or onion)"));
     strUsage += HelpMessageOpt("-permitbaremultisig", strprintf(_("Relay non-P2SH multisig (default: %u)"), DEFAULT_PERMIT_BAREMULTISIG));
@@ -488,6 +503,9 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-port=<port>", strprintf(_("Listen for connections on <port> (default: %u or testnet: %u)"), Params(CBaseChainParams::MAIN).GetDefaultPort(), Params(CBaseChainParams::TESTNET).GetDefaultPort()));
     strUsage += HelpMessageOpt("-proxy=<ip:port>", _("Connect through SOCKS5 proxy"));
     strUsage += HelpMessageOpt("-proxyrandomize", strprintf(_("Randomize credentials for every proxy connection. This enables Tor stream isolation (default: %u)"), DEFAULT_PROXYRANDOMIZE));
+#ifdef USE_EPOLL
+    strUsage += HelpMessageOpt("-socketevents=<mode>", strprintf(_("Socket events mode, which must be one of 'select' or 'epoll'; 'epoll' lifts the FD_SETSIZE cap on -maxconnections (default: %s)"), DEFAULT_SOCKETEVENTS));
+#endif
     strUsage += HelpMessageOpt("-seednode=<ip>", _("Connect to a node to retrieve peer addresses, and disconnect"));
     strUsage += HelpMessageOpt("-timeout=<n>", strprintf(_("Specify connection timeout in milliseconds (minimum: 1, default: %d)"), DEFAULT_CONNECT_TIMEOUT));
     strUsage += HelpMessageOpt("-torcontrol=<ip>:<port>", strprintf(_("Tor control port to use if onion listening enabled (default: %s)"), DEFAULT_TOR_CONTROL));
@@ -514,12 +532,19 @@ std::string HelpMessage(HelpMessageMode mode)
 
 #if ENABLE_ZMQ
     strUsage += HelpMessageGroup(_("ZeroMQ notification options:"));
+    strUsage += HelpMessageOpt("-zmqpubbdaphistory=<address>", _("Enable publish BDAP entry history (JSON) in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubbdaprecord=<address>", _("Enable publish BDAP entry records (JSON) in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubhashbdapentry=<address>", _("Enable publish transaction hash of added, updated and deleted BDAP entries in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubhashbdaplink=<address>", _("Enable publish transaction hash of BDAP link requests and accepts in <address>"));
     strUsage += HelpMessageOpt("-zmqpubhashblock=<address>", _("Enable publish hash block in <address>"));
     strUsage += HelpMessageOpt("-zmqpubhashtx=<address>", _("Enable publish hash transaction in <address>"));
     strUsage += HelpMessageOpt("-zmqpubhashtxlock=<address>", _("Enable publish hash transaction (locked via InstantSend) in <address>"));
     strUsage += HelpMessageOpt("-zmqpubhashgovernancevote=<address>", _("Enable publish hash of governance votes in <address>"));
     strUsage += HelpMessageOpt("-zmqpubhashgovernanceobject=<address>", _("Enable publish hash of governance objects (like proposals) in <address>"));
     strUsage += HelpMessageOpt("-zmqpubhashinstantsenddoublespend=<address>", _("Enable publish transaction hashes of attempted InstantSend double spend in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubminerstats=<address>", _("Enable publish miner hash rate and block template statistics (JSON) on every new block in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubrawbdapentry=<address>", _("Enable publish raw added, updated and deleted BDAP entries in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubrawbdaplink=<address>", _("Enable publish raw BDAP link requests and accepts in <address>"));
     strUsage += HelpMessageOpt("-zmqpubrawblock=<address>", _("Enable publish raw block in <address>"));
     strUsage += HelpMessageOpt("-zmqpubrawtx=<address>", _("Enable publish raw transaction in <address>"));
     strUsage += HelpMessageOpt("-zmqpubrawtxlock=<address>", _("Enable publish raw transaction (locked via InstantSend) in <address>"));
@@ -584,6 +609,8 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-dnconf=<file>", strprintf(_("Specify Dynode configuration file (default: %s)"), "dynode.conf"));
     strUsage += HelpMessageOpt("-dnconflock=<n>", strprintf(_("Lock Dynodes from Dynode configuration file (default: %u)"), 1));
     strUsage += HelpMessageOpt("-dynodepairingkey=<n>", _("Set the Dynode private key"));
+    strUsage += HelpMessageOpt("-parallelsync=<n>", strprintf(_("Request Dynode list, payment votes and governance data from several peers at once during sync (0-1, default: %u)"), DEFAULT_PARALLEL_SYNC));
+    strUsage += HelpMessageOpt("-cachesnapshotinterval=<n>", strprintf(_("Write the Dynode, governance and spork caches to disk every <n> seconds, 0 to only write them at shutdown (default: %u)"), DEFAULT_CACHE_SNAPSHOT_INTERVAL));
 
 #ifdef ENABLE_WALLET
     strUsage += HelpMessageGroup(_("PrivateSend options:"));
@@ -614,7 +641,7 @@ std::string HelpMessage(HelpMessageMode mode)
 
     strUsage += HelpMessageGroup(_("Block creation options:"));
     strUsage += HelpMessageOpt("-blockmaxsize=<n>", strprintf(_("Set maximum block size in bytes (default: %d)"), DEFAULT_BLOCK_MAX_SIZE));
-    strUsage += HelpMessageOpt("-blockprioritysize=<n>", strprintf(_("Set maximum size of high-priority/low-fee transactions in bytes (default: %d)"), DEFAULT_BLOCK_PRIORITY_SIZE));
+    strUsage += HelpMessageOpt("-blockprioritysize=<n>", strprintf(_("Set maximum size of high-priority/low-fee transactions in bytes, a nonzero size selects block transactions from scratch for every template (default: %d)"), DEFAULT_BLOCK_PRIORITY_SIZE));
     strUsage += HelpMessageOpt("-blockmintxfee=<amt>", strprintf(_("Set lowest fee rate (in %s/kB) for transactions to be included in block creation. (default: %s)"), CURRENCY_UNIT, FormatMoney(DEFAULT_BLOCK_MIN_TX_FEE)));
     if (showDebug)
         strUsage += HelpMessageOpt("-blockversion=<n>", "Override block version to test forking scenarios");
@@ -745,6 +772,9 @@ void ThreadImport(std::vector<boost::filesystem::path> vImportFiles)
 
         // -reindex
         if (fReindex) {
+            int nFiles = 0;
+            while (boost::filesystem::exists(GetBlockPosFilename(CDiskBlockPos(nFiles, 0), "blk")))
+                nFiles++;
             int nFile = 0;
             while (true) {
                 CDiskBlockPos pos(nFile, 0);
@@ -754,9 +784,11 @@ void ThreadImport(std::vector<boost::filesystem::path> vImportFiles)
                 if (!file)
                     break; // This error is logged in OpenBlockFile
                 LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
+                uiInterface.ShowProgress(_("Reindexing blocks..."), std::max(1, std::min(99, nFile * 100 / std::max(nFiles, 1))));
                 LoadExternalBlockFile(chainparams, file, &pos);
                 nFile++;
             }
+            uiInterface.ShowProgress("", 100);
             pblocktree->WriteReindexing(false);
             fReindex = false;
             LogPrintf("Reindexing finished\n");
@@ -979,7 +1011,8 @@ ServiceFlags nRelevantServices = NODE_NETWORK;
 int nMaxConnections;
 int nUserMaxConnections;
 int nFD;
-ServiceFlags nLocalServices = NODE_NETWORK;
+ServiceFlags nLocalServices = ServiceFlags(NODE_NETWORK | NODE_DNLIST);
+SocketEventsMode socketEventsMode = SOCKETEVENTS_SELECT;
 
 } // namespace
 
@@ -1077,8 +1110,21 @@ bool AppInitParameterInteraction()
     nUserMaxConnections = GetArg("-maxconnections", DEFAULT_MAX_PEER_CONNECTIONS);
     nMaxConnections = std::max(nUserMaxConnections, 0);
 
+    std::string strSocketEventsMode = GetArg("-socketevents", DEFAULT_SOCKETEVENTS);
+    if (strSocketEventsMode == "select") {
+        socketEventsMode = SOCKETEVENTS_SELECT;
+#ifdef USE_EPOLL
+    } else if (strSocketEventsMode == "epoll") {
+        socketEventsMode = SOCKETEVENTS_EPOLL;
+#endif
+    } else {
+        return InitError(strprintf(_("Invalid -socketevents ('%s') specified."), strSocketEventsMode));
+    }
+
     // Trim requested connection counts, to fit into system limitations
-    nMaxConnections = std::max(std::min(nMaxConnections, (int)(FD_SETSIZE - nBind - MIN_CORE_FILEDESCRIPTORS - MAX_ADDNODE_CONNECTIONS)), 0);
+    // (select() cannot watch descriptors at or above FD_SETSIZE, epoll is only bounded by the fd limit)
+    if (socketEventsMode == SOCKETEVENTS_SELECT)
+        nMaxConnections = std::max(std::min(nMaxConnections, (int)(FD_SETSIZE - nBind - MIN_CORE_FILEDESCRIPTORS - MAX_ADDNODE_CONNECTIONS)), 0);
     nFD = RaiseFileDescriptorLimit(nMaxConnections + MIN_CORE_FILEDESCRIPTORS + MAX_ADDNODE_CONNECTIONS);
     if (nFD < MIN_CORE_FILEDESCRIPTORS)
         return InitError(_("Not enough file descriptors available."));
@@ -1844,6 +1890,8 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
         return InitError(_("You can not start a dynode in lite mode."));
     }
 
+    dynodeSync.SetParallelSync(GetBoolArg("-parallelsync", DEFAULT_PARALLEL_SYNC));
+
     if (fDynodeMode) {
         LogPrintf("DYNODE:\n");
 
@@ -1913,57 +1961,63 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
     if (!fLiteMode) {
         boost::filesystem::path pathDB = GetDataDir();
-        std::string strDBName;
 
-        strDBName = "dncache.dat";
-        uiInterface.InitMessage(_("Loading Dynode cache..."));
-        CFlatDB<CDynodeMan> flatdb1(strDBName, "magicDynodeCache");
-        if (!flatdb1.Load(dnodeman)) {
-            return InitError(_("Failed to load Dynode cache from") + "\n" + (pathDB / strDBName).string());
+        // The files are read concurrently, the cleanup of stale entries runs afterwards
+        // in the original order because it looks across managers (e.g. governance -> dynodes)
+        uiInterface.InitMessage(_("Loading Dynode, governance and spork caches..."));
+        bool fLoadedDynodes = false, fLoadedPayments = false, fLoadedGovernance = false;
+        bool fLoadedFulfilled = false, fLoadedInstantSend = true, fLoadedSporks = false;
+        {
+            boost::thread_group threadsLoad;
+            threadsLoad.create_thread(boost::bind(&LoadCacheFile<CDynodeMan>, boost::ref(dnodeman), "dncache.dat", "magicDynodeCache", boost::ref(fLoadedDynodes)));
+            threadsLoad.create_thread(boost::bind(&LoadCacheFile<CDynodePayments>, boost::ref(dnpayments), "dnpayments.dat", "magicDynodePaymentsCache", boost::ref(fLoadedPayments)));
+            threadsLoad.create_thread(boost::bind(&LoadCacheFile<CGovernanceManager>, boost::ref(governance), "governance.dat", "magicGovernanceCache", boost::ref(fLoadedGovernance)));
+            threadsLoad.create_thread(boost::bind(&LoadCacheFile<CNetFulfilledRequestManager>, boost::ref(netfulfilledman), "netfulfilled.dat", "magicFulfilledCache", boost::ref(fLoadedFulfilled)));
+            if (fEnableInstantSend)
+                threadsLoad.create_thread(boost::bind(&LoadCacheFile<CInstantSend>, boost::ref(instantsend), "instantsend.dat", "magicInstantSendCache", boost::ref(fLoadedInstantSend)));
+            threadsLoad.create_thread(boost::bind(&LoadCacheFile<CSporkManager>, boost::ref(sporkManager), "sporks.dat", "magicSporkCache", boost::ref(fLoadedSporks)));
+            threadsLoad.join_all();
+        }
+
+        if (!fLoadedDynodes) {
+            return InitError(_("Failed to load Dynode cache from") + "\n" + (pathDB / "dncache.dat").string());
         }
+        dnodeman.CheckAndRemove();
 
         if (dnodeman.size()) {
-            strDBName = "dnpayments.dat";
-            uiInterface.InitMessage(_("Loading Dynode payment cache..."));
-            CFlatDB<CDynodePayments> flatdb2(strDBName, "magicDynodePaymentsCache");
-            if (!flatdb2.Load(dnpayments)) {
-                return InitError(_("Failed to load Dynode payments cache from") + "\n" + (pathDB / strDBName).string());
+            if (!fLoadedPayments) {
+                return InitError(_("Failed to load Dynode payments cache from") + "\n" + (pathDB / "dnpayments.dat").string());
             }
+            dnpayments.CheckAndRemove();
 
-            strDBName = "governance.dat";
-            uiInterface.InitMessage(_("Loading governance cache..."));
-            CFlatDB<CGovernanceManager> flatdb3(strDBName, "magicGovernanceCache");
-            if (!flatdb3.Load(governance)) {
-                return InitError(_("Failed to load governance cache from") + "\n" + (pathDB / strDBName).string());
+            if (!fLoadedGovernance) {
+                return InitError(_("Failed to load governance cache from") + "\n" + (pathDB / "governance.dat").string());
             }
+            governance.CheckAndRemove();
             governance.InitOnLoad();
         } else {
             uiInterface.InitMessage(_("Dynode cache is empty, skipping payments and governance cache..."));
+            dnpayments.Clear();
+            governance.Clear();
         }
         governance.InitOnLoad();
 
-        strDBName = "netfulfilled.dat";
-        uiInterface.InitMessage(_("Loading fulfilled requests cache..."));
-        CFlatDB<CNetFulfilledRequestManager> flatdb4(strDBName, "magicFulfilledCache");
-        if (!flatdb4.Load(netfulfilledman)) {
-            return InitError(_("Failed to load fulfilled requests cache from") + "\n" + (pathDB / strDBName).string());
+        if (!fLoadedFulfilled) {
+            return InitError(_("Failed to load fulfilled requests cache from") + "\n" + (pathDB / "netfulfilled.dat").string());
         }
+        netfulfilledman.CheckAndRemove();
 
         if (fEnableInstantSend) {
-            strDBName = "instantsend.dat";
-            uiInterface.InitMessage(_("Loading InstantSend data cache..."));
-            CFlatDB<CInstantSend> flatdb5(strDBName, "magicInstantSendCache");
-            if (!flatdb5.Load(instantsend)) {
-                return InitError(_("Failed to load InstantSend data cache from") + "\n" + (pathDB / strDBName).string());
+            if (!fLoadedInstantSend) {
+                return InitError(_("Failed to load InstantSend data cache from") + "\n" + (pathDB / "instantsend.dat").string());
             }
+            instantsend.CheckAndRemove();
         }
 
-        strDBName = "sporks.dat";
-        uiInterface.InitMessage(_("Loading sporks cache..."));
-        CFlatDB<CSporkManager> flatdb6(strDBName, "magicSporkCache");
-        if (!flatdb6.Load(sporkManager)) {
-            return InitError(_("Failed to load sporks cache from") + "\n" + (pathDB / strDBName).string());
+        if (!fLoadedSporks) {
+            return InitError(_("Failed to load sporks cache from") + "\n" + (pathDB / "sporks.dat").string());
         }
+        sporkManager.CheckAndRemove();
     }
 
     // ********************************************************* Step 11d: start dynamic-ps-<smth> threads
@@ -1971,6 +2025,8 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     if (!fLiteMode) {
         scheduler.scheduleEvery(boost::bind(&CNetFulfilledRequestManager::DoMaintenance, boost::ref(netfulfilledman)), 60);
         scheduler.scheduleEvery(boost::bind(&CDynodeSync::DoMaintenance, boost::ref(dynodeSync), boost::ref(*g_connman)), DYNODE_SYNC_TICK_SECONDS);
+        if (dynodeSync.IsParallelSync())
+            scheduler.scheduleEvery(boost::bind(&CDynodeSync::ProcessParallelTick, boost::ref(dynodeSync), boost::ref(*g_connman)), DYNODE_SYNC_PARALLEL_TICK_SECONDS);
         scheduler.scheduleEvery(boost::bind(&CDynodeMan::DoMaintenance, boost::ref(dnodeman), boost::ref(*g_connman)), 1);
         scheduler.scheduleEvery(boost::bind(&CActiveDynode::DoMaintenance, boost::ref(activeDynode), boost::ref(*g_connman)), DYNODE_MIN_DNP_SECONDS);
 
@@ -1979,6 +2035,10 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
         scheduler.scheduleEvery(boost::bind(&CInstantSend::DoMaintenance, boost::ref(instantsend)), 60);
 
+        int nSnapshotInterval = GetArg("-cachesnapshotinterval", DEFAULT_CACHE_SNAPSHOT_INTERVAL);
+        if (nSnapshotInterval > 0)
+            scheduler.scheduleEvery(boost::bind(&DumpCacheFiles, false), nSnapshotInterval);
+
         if (fDynodeMode)
             scheduler.scheduleEvery(boost::bind(&CPrivateSendServer::DoMaintenance, boost::ref(privateSendServer), boost::ref(*g_connman)), 1);
 #ifdef ENABLE_WALLET
@@ -2021,6 +2081,8 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
 
     connOptions.nMaxOutboundTimeframe = nMaxOutboundTimeframe;
     connOptions.nMaxOutboundLimit = nMaxOutboundLimit;
+    connOptions.socketEventsMode = socketEventsMode;
+    connOptions.nMessageHandlerThreads = std::max(1, std::min((int)GetArg("-msghandlerthreads", DEFAULT_MSG_HANDLER_THREADS), MAX_MSG_HANDLER_THREADS));
 
     if (!connman.Start(scheduler, strNodeError, connOptions))
         return InitError(strNodeError);
@@ -1,4 +1,3 @@
-
 // Copyright (c) 2019 Duality Blockchain Solutions Developers
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
@@ -6,33 +5,166 @@
 #include "miner/internal/hash-rate-counter.h"
 #include "utiltime.h"
 
+#include <algorithm>
+
+
+void HashRateStats::Add(const HashRateStats& other)
+{
+    hashes += other.hashes;
+    hashes_per_sec += other.hashes_per_sec;
+    templates += other.templates;
+    stale_templates += other.stale_templates;
+    blocks_accepted += other.blocks_accepted;
+    blocks_rejected += other.blocks_rejected;
+    refresh_latency_total += other.refresh_latency_total;
+    refresh_latency_max = std::max(refresh_latency_max, other.refresh_latency_max);
+}
+
+HashRateCounter::~HashRateCounter()
+{
+    // Keep totals of finished miner threads in the group statistics
+    if (_parent) {
+        HashRateStats stats = GetStats();
+        stats.hashes_per_sec = 0;
+        std::lock_guard<std::mutex> guard(_parent->_mutex);
+        _parent->_retired.Add(stats);
+    }
+}
+
+HashRateCounterRef HashRateCounter::MakeChild()
+{
+    HashRateCounterRef child = std::make_shared<HashRateCounter>(shared_from_this());
+    std::lock_guard<std::mutex> guard(_mutex);
+    _children.erase(std::remove_if(_children.begin(), _children.end(),
+                        [](const std::weak_ptr<HashRateCounter>& ref) { return ref.expired(); }),
+        _children.end());
+    _children.push_back(child);
+    return child;
+}
 
 void HashRateCounter::Increment(int64_t amount)
 {
-    // Set start time if not set and return
-    if (_timer_start == 0) {
-        Reset();
-        return;
+    // Only the owning thread writes, no need for atomic read-modify-write
+    int64_t hashes = _hashes.load(std::memory_order_relaxed) + amount;
+    _hashes.store(hashes, std::memory_order_relaxed);
+
+    int64_t now = GetTimeMillis();
+    if (_reset.exchange(false, std::memory_order_relaxed)) {
+        _samples.clear();
     }
-    // Increment hashes done
-    _count += amount;
-    if (_parent) {
-        _parent->Increment(amount);
+    // Set start of the window if not set and return
+    if (_samples.empty()) {
+        _samples.emplace_back(now, hashes);
+        return;
     }
-    // Ignore until at least 4 seconds passed
-    if (GetTimeMillis() - _timer_start < 4000) {
+    // Ignore until at least one sample interval passed
+    if (now - _samples.back().first < SAMPLE_MILLIS) {
         return;
     }
-    // Set count per second
-    _count_per_sec = 1000.0 * _count / (GetTimeMillis() - _timer_start);
-    // Reset timer and count
-    _count = 0;
-    _timer_start = GetTimeMillis();
+    _samples.emplace_back(now, hashes);
+    // Drop samples which fell out of the window, always keeping one to compare with
+    while (_samples.size() > 2 && now - _samples[1].first >= WINDOW_MILLIS) {
+        _samples.pop_front();
+    }
+    const auto& first = _samples.front();
+    _count_per_sec.store(1000 * (hashes - first.second) / (now - first.first), std::memory_order_relaxed);
+}
+
+void HashRateCounter::AddTemplate(int64_t latency_millis, bool stale)
+{
+    _templates.store(_templates.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (stale) {
+        _stale_templates.store(_stale_templates.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    _latency_total.store(_latency_total.load(std::memory_order_relaxed) + latency_millis, std::memory_order_relaxed);
+    if (latency_millis > _latency_max.load(std::memory_order_relaxed)) {
+        _latency_max.store(latency_millis, std::memory_order_relaxed);
+    }
+}
+
+void HashRateCounter::AddBlock(bool accepted)
+{
+    std::atomic<int64_t>& counter = accepted ? _blocks_accepted : _blocks_rejected;
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 }
 
 void HashRateCounter::Reset()
 {
-    _count = 0;
     _count_per_sec = 0;
-    _timer_start = GetTimeMillis();
+    _reset = true;
+    for (const auto& child : GetChildren()) {
+        child->Reset();
+    }
+}
+
+void HashRateCounter::SetDevice(const std::string& device)
+{
+    std::lock_guard<std::mutex> guard(_mutex);
+    _device = device;
+}
+
+int64_t HashRateCounter::GetHashRate() const
+{
+    int64_t rate = _count_per_sec.load(std::memory_order_relaxed);
+    for (const auto& child : GetChildren()) {
+        rate += child->GetHashRate();
+    }
+    return rate;
+}
+
+std::vector<HashRateCounterRef> HashRateCounter::GetChildren() const
+{
+    // Returned by value so that no child is destroyed while holding the lock,
+    // its destructor locks this counter
+    std::vector<HashRateCounterRef> children;
+    std::lock_guard<std::mutex> guard(_mutex);
+    for (const auto& ref : _children) {
+        if (HashRateCounterRef child = ref.lock()) {
+            children.push_back(child);
+        }
+    }
+    return children;
+}
+
+HashRateStats HashRateCounter::GetOwnStats() const
+{
+    HashRateStats stats;
+    stats.hashes = _hashes.load(std::memory_order_relaxed);
+    stats.hashes_per_sec = _count_per_sec.load(std::memory_order_relaxed);
+    stats.templates = _templates.load(std::memory_order_relaxed);
+    stats.stale_templates = _stale_templates.load(std::memory_order_relaxed);
+    stats.blocks_accepted = _blocks_accepted.load(std::memory_order_relaxed);
+    stats.blocks_rejected = _blocks_rejected.load(std::memory_order_relaxed);
+    stats.refresh_latency_total = _latency_total.load(std::memory_order_relaxed);
+    stats.refresh_latency_max = _latency_max.load(std::memory_order_relaxed);
+    return stats;
+}
+
+HashRateStats HashRateCounter::GetStats() const
+{
+    HashRateStats stats = GetOwnStats();
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        stats.device = _device;
+        stats.Add(_retired);
+    }
+    for (const auto& child : GetChildren()) {
+        stats.Add(child->GetStats());
+    }
+    return stats;
+}
+
+void HashRateCounter::GetThreadStats(std::vector<HashRateStats>& stats) const
+{
+    int thread = 0;
+    for (const auto& child : GetChildren()) {
+        HashRateStats child_stats = child->GetStats();
+        // Miner threads name their counter, groups recurse into their threads
+        if (!child_stats.device.empty()) {
+            child_stats.thread = thread++;
+            stats.push_back(child_stats);
+        } else {
+            child->GetThreadStats(stats);
+        }
+    }
 }
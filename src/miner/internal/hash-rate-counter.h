@@ -6,41 +6,127 @@
 #define DYNAMIC_INTERNAL_HASH_RATE_COUNTER_H
 
 #include <atomic>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 
 struct HashRateCounter;
 using HashRateCounterRef = std::shared_ptr<HashRateCounter>;
 
+/**
+ * Statistics of a single miner thread or the sum over a group of them.
+ */
+struct HashRateStats {
+    // Miner device (e.g. "GPU#1"), empty for groups
+    std::string device;
+    // Miner thread number within its group, -1 for groups
+    int thread = -1;
+    // Total hashes done
+    int64_t hashes = 0;
+    // Hashes per second over the sliding window
+    int64_t hashes_per_sec = 0;
+    // Block templates mined on until they were replaced
+    int64_t templates = 0;
+    // Templates abandoned because the chain tip changed under them
+    int64_t stale_templates = 0;
+    // Found blocks accepted and rejected by ProcessBlockFound
+    int64_t blocks_accepted = 0;
+    int64_t blocks_rejected = 0;
+    // Milliseconds between a new template and the miner switching to it
+    int64_t refresh_latency_total = 0;
+    int64_t refresh_latency_max = 0;
+
+    // Adds statistics of another thread or group
+    void Add(const HashRateStats& other);
+};
+
 /**
  * Hash rate counter struct.
+ *
+ * Every miner thread owns a leaf counter which only that thread writes,
+ * so the mining loop never touches memory shared with other threads.
+ * Group counters don't count themselves, they sum up their children
+ * when read.
  */
 struct HashRateCounter : public std::enable_shared_from_this<HashRateCounter> {
+public:
+    // Hash rate is averaged over this window
+    static const int64_t WINDOW_MILLIS = 60 * 1000;
+    // Minimum time between two window samples
+    static const int64_t SAMPLE_MILLIS = 4 * 1000;
+
 private:
-    std::atomic<int64_t> _count{0};
-    std::atomic<int64_t> _timer_start{0};
+    // Written by the owning miner thread only, padded so that
+    // counters of different threads never share a cache line
+    char _pad_begin[64];
+    std::atomic<int64_t> _hashes{0};
     std::atomic<int64_t> _count_per_sec{0};
+    std::atomic<int64_t> _templates{0};
+    std::atomic<int64_t> _stale_templates{0};
+    std::atomic<int64_t> _blocks_accepted{0};
+    std::atomic<int64_t> _blocks_rejected{0};
+    std::atomic<int64_t> _latency_total{0};
+    std::atomic<int64_t> _latency_max{0};
+    // Set by Reset() from another thread, handled by the owner
+    std::atomic<bool> _reset{false};
+    char _pad_end[64];
+
+    // Window samples of (time, hashes), owning thread only
+    std::deque<std::pair<int64_t, int64_t> > _samples;
 
     HashRateCounterRef _parent;
 
+    // Protects everything below
+    mutable std::mutex _mutex;
+    std::string _device;
+    std::vector<std::weak_ptr<HashRateCounter> > _children;
+    // Totals of children that have already been destroyed
+    HashRateStats _retired;
+
+    // Returns statistics of this counter only
+    HashRateStats GetOwnStats() const;
+
+    // Returns children which are still alive
+    std::vector<HashRateCounterRef> GetChildren() const;
+
 public:
     explicit HashRateCounter() : _parent(nullptr){};
     explicit HashRateCounter(HashRateCounterRef parent) : _parent(parent){};
+    ~HashRateCounter();
 
     // Returns hash rate per second
-    operator int64_t() { return _count_per_sec; };
+    operator int64_t() const { return GetHashRate(); };
 
     // Creates new child counter
-    HashRateCounterRef MakeChild() { return std::make_shared<HashRateCounter>(shared_from_this()); }
+    HashRateCounterRef MakeChild();
 
     // Increments counter
     void Increment(int64_t amount);
 
-    // Resets counter and timer
+    // Records a switch to a new block template
+    void AddTemplate(int64_t latency_millis, bool stale);
+
+    // Records a found block
+    void AddBlock(bool accepted);
+
+    // Resets hash rate of this counter and all its children
     void Reset();
 
-    // Returns start time
-    int64_t start() const { return _timer_start; };
+    // Sets miner device name shown in statistics
+    void SetDevice(const std::string& device);
+
+    // Returns hash rate per second of this counter or sum of its children
+    int64_t GetHashRate() const;
+
+    // Returns statistics including all children
+    HashRateStats GetStats() const;
+
+    // Appends statistics of every miner thread counter below this one
+    void GetThreadStats(std::vector<HashRateStats>& stats) const;
 };
 
 #endif // DYNAMIC_INTERNAL_HASH_RATE_COUNTER_H
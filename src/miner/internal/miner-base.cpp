@@ -35,6 +35,7 @@ void MinerBase::Loop()
     LogPrintf("DynamicMiner -- started on %s#%d\n", DeviceName(), _device_index);
     SetThreadPriority(THREAD_PRIORITY_LOWEST);
     RenameThread(tfm::format("dynamic-%s-miner-%d", DeviceName(), _device_index).data());
+    _ctx->counter->SetDevice(tfm::format("%s#%d", DeviceName(), _device_index));
 
     CBlock block;
     CBlockIndex* chain_tip = nullptr;
@@ -45,16 +46,19 @@ void MinerBase::Loop()
         while (true) {
             // Update block and tip if changed
             if (block_time != _ctx->shared->block_time()) {
-                // set new block template
-                block_template = _ctx->shared->block_template();
+                // set new block template, its chain tip,
+                // block flag and creation time are read together with it
+                CBlockIndex* prev_tip = chain_tip;
+                int64_t template_time = 0;
+                block_template = _ctx->shared->block_template(chain_tip, block_time, template_time);
+                // time we kept mining the previous template since the new one was created,
+                // it was stale if the new template is built on another chain tip
+                if (prev_tip != nullptr) {
+                    _ctx->counter->AddTemplate(GetTimeMillis() - template_time, prev_tip != chain_tip);
+                }
                 block = block_template->block;
                 // set block reserve script
                 SetBlockPubkeyScript(block, _coinbase_script->reserveScript);
-                // set block flag only after template
-                // so we've waited for RecreateBlock
-                block_time = _ctx->shared->block_time();
-                // block template chain tip
-                chain_tip = _ctx->shared->tip();
             }
             // Make sure we have a tip
             assert(chain_tip != nullptr);
@@ -109,7 +113,7 @@ void MinerBase::ProcessFoundSolution(const CBlock& block, const uint256& hash)
     // Found a solution
     SetThreadPriority(THREAD_PRIORITY_NORMAL);
     LogPrintf("DynamicMiner%s:\n proof-of-work found  \n  hash: %s  \ntarget: %s\n", DeviceName(), hash.GetHex(), _hash_target.GetHex());
-    ProcessBlockFound(block, _ctx->chainparams());
+    _ctx->counter->AddBlock(ProcessBlockFound(block, _ctx->chainparams()));
     SetThreadPriority(THREAD_PRIORITY_LOWEST);
     _coinbase_script->KeepScript();
 
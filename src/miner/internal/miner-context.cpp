@@ -14,17 +14,63 @@ MinerContext::MinerContext(const CChainParams& chainparams_, CConnman& connman_)
 MinerContext::MinerContext(MinerSharedContextRef shared_, HashRateCounterRef counter_)
     : counter(counter_), shared(shared_){};
 
-void MinerSharedContext::RecreateBlock()
+void MinerSharedContext::RecreateBlock(bool empty)
+{
+    CBlockIndex* chain_tip;
+    uint32_t txn_time;
+    std::shared_ptr<CBlockTemplate> block_template;
+    if (empty) {
+        // Called from the tip notification with cs_main held, so it does not
+        // wait for _build_mutex: a full build holds it while taking cs_main
+        {
+            LOCK(cs_main);
+            chain_tip = chainActive.Tip();
+            txn_time = mempool.GetTransactionsUpdated();
+            // pass if nothing changed, any template will do for an empty one
+            if (_chain_tip == chain_tip)
+                return;
+            block_template = CreateNewBlock(chainparams, nullptr, false);
+        }
+        PublishBlock(chain_tip, block_template, txn_time, true, 0);
+        return;
+    }
+    // Only one thread builds at a time, the others
+    // find the template up to date afterwards
+    std::lock_guard<std::mutex> build_guard(_build_mutex);
+    int64_t generation = _tip_generation;
+    {
+        LOCK(cs_main);
+        chain_tip = chainActive.Tip();
+        txn_time = mempool.GetTransactionsUpdated();
+        // pass if nothing changed
+        if (_chain_tip == chain_tip && !_empty && _last_txn == txn_time)
+            return;
+        // miners keep working on the current template meanwhile
+        block_template = CreateNewBlock(chainparams, nullptr, true);
+    }
+    if (!PublishBlock(chain_tip, block_template, txn_time, false, generation))
+        LogPrint("miner", "MinerSharedContext::%s -- tip changed while building, template dropped\n", __func__);
+}
+
+bool MinerSharedContext::PublishBlock(CBlockIndex* chain_tip, std::shared_ptr<CBlockTemplate> block_template, uint32_t txn_time, bool empty, int64_t generation)
 {
     // Then we acquire unique lock so that miners wait
-    // for the new block to be created
+    // for the new block to be swapped in
     boost::unique_lock<boost::shared_mutex> guard(_mutex);
-    uint32_t txn_time = mempool.GetTransactionsUpdated();
-    // pass if nothing changed
-    if (_chain_tip == chainActive.Tip() && _last_txn == txn_time)
-        return;
-    _chain_tip = chainActive.Tip();
-    _block_time = GetTime();
-    _block_template = CreateNewBlock(chainparams);
+    if (empty) {
+        // a full template for the same tip may have been swapped in meanwhile
+        if (_chain_tip == chain_tip)
+            return false;
+        ++_tip_generation;
+    } else if (_tip_generation != generation) {
+        // the template is for an older tip than the one miners work on
+        return false;
+    }
+    _chain_tip = chain_tip;
+    _block_template = block_template;
+    _empty = empty;
+    _template_time = GetTimeMillis();
     _last_txn = txn_time;
+    ++_block_time;
+    return true;
 }
@@ -11,6 +11,7 @@
 #include <boost/thread/shared_mutex.hpp>
 
 #include <atomic>
+#include <mutex>
 
 class CBlock;
 class CChainParams;
@@ -21,6 +22,7 @@ struct CBlockTemplate;
 class MinerBase;
 class MinerContext;
 class MinerSignals;
+class MinerTemplateBuilder;
 class MinersController;
 
 /** Miner context shared_ptr */
@@ -37,12 +39,15 @@ public:
     // Returns chain tip of current block template
     CBlockIndex* tip() const { return _chain_tip; }
 
-    // Returns miner block template creation time
+    // Returns counter incremented on every new block template
     int64_t block_time() const { return _block_time; }
 
     // Returns time of last transaction in the block
     uint32_t last_txn() const { return _last_txn; }
 
+    // Returns counter incremented on every chain tip switch
+    int64_t tip_generation() const { return _tip_generation; }
+
     // Returns miner block template
     std::shared_ptr<CBlockTemplate> block_template()
     {
@@ -50,25 +55,49 @@ public:
         return _block_template;
     }
 
+    // Returns miner block template along with its chain tip, counter and creation time
+    std::shared_ptr<CBlockTemplate> block_template(CBlockIndex*& tip, int64_t& block_time, int64_t& template_time)
+    {
+        boost::shared_lock<boost::shared_mutex> guard(_mutex);
+        tip = _chain_tip;
+        block_time = _block_time;
+        template_time = _template_time;
+        return _block_template;
+    }
+
 protected:
     friend class MinerBase;
     friend class MinerSignals;
+    friend class MinerTemplateBuilder;
     friend class MinersController;
 
-    // recreates miners block template
-    void RecreateBlock();
+    // recreates miners block template, without mempool transactions if empty
+    // the template is built before miners are locked out to swap it in
+    void RecreateBlock(bool empty = false);
+
+    // swaps in a template built for chain_tip, an empty one starts a new tip generation
+    // returns false and drops a full one if a tip was published since generation
+    bool PublishBlock(CBlockIndex* chain_tip, std::shared_ptr<CBlockTemplate> block_template, uint32_t txn_time, bool empty, int64_t generation);
 
 private:
     // current block chain tip
     std::atomic<CBlockIndex*> _chain_tip{nullptr};
     // atomic flag incremented on recreated block
     std::atomic<int64_t> _block_time{0};
+    // atomic flag incremented when an empty template switches the tip
+    std::atomic<int64_t> _tip_generation{0};
+    // set while the template holds the coinbase only
+    std::atomic<bool> _empty{false};
+    // block template creation time in milliseconds
+    std::atomic<int64_t> _template_time{0};
     // last transaction update time
     std::atomic<uint32_t> _last_txn{0};
     // shared block template for miners
     std::shared_ptr<CBlockTemplate> _block_template{nullptr};
-    // mutex protecting multiple threads recreating block
+    // mutex protecting the block template while it is swapped
     mutable boost::shared_mutex _mutex;
+    // mutex serializing threads recreating a full block, taken before cs_main
+    std::mutex _build_mutex;
 };
 
 using MinerSharedContextRef = std::shared_ptr<MinerSharedContext>;
@@ -6,7 +6,9 @@
 #include "chain.h"
 #include "miner/internal/miner-context.h"
 #include "miner/miner-util.h"
+#include "miner/miner.h"
 #include "net.h"
+#include "univalue.h"
 #include "validation.h"
 #include "validationinterface.h"
 
@@ -26,9 +28,10 @@ void MinersController::Start()
 {
     _connected = _ctx->connman().GetNodeCount(CConnman::CONNECTIONS_ALL) >= 2;
     _enable_start = true;
-    _signals = std::make_shared<MinerSignals>(this);
     // initialize block template
     _ctx->shared->RecreateBlock();
+    _builder = std::make_shared<MinerTemplateBuilder>(_ctx->shared);
+    _signals = std::make_shared<MinerSignals>(this);
     LogPrintf("MinersController::Start can_start = %v\n", can_start());
 
     if (can_start()) {
@@ -43,6 +46,7 @@ void MinersController::Shutdown()
 {
     _enable_start = false;
     _signals = nullptr; // remove signals receiver
+    _builder = nullptr; // stops template builder
 
     _group_cpu.Shutdown();
 #ifdef ENABLE_GPU
@@ -59,6 +63,13 @@ int64_t MinersController::GetHashRate() const
 #endif // ENABLE_GPU
 }
 
+std::vector<HashRateStats> MinersController::GetThreadStats() const
+{
+    std::vector<HashRateStats> stats;
+    _ctx->counter->GetThreadStats(stats);
+    return stats;
+}
+
 MinerSignals::MinerSignals(MinersController* ctr)
     : _ctr(ctr),
       _node(_ctr->ctx()->connman().ConnectSignalNode(boost::bind(&MinerSignals::NotifyNode, this, _1))),
@@ -81,8 +92,12 @@ void MinerSignals::NotifyBlock(const CBlockIndex* index_new, const CBlockIndex*
     // Compare with current tip (checks for unexpected behaviour or old block)
     if (index_new != chainActive.Tip())
         return;
-    // Create new block template for miners
-    _ctr->_ctx->shared->RecreateBlock();
+    // Switch miners to the new tip at once with an empty block template,
+    // the one filled from the mempool is swapped in once built
+    _ctr->_ctx->shared->RecreateBlock(true);
+    _ctr->_builder->Request();
+    // Publish miner statistics once per block
+    GetMainSignals().NotifyMinerStats(GetMinerStats().write());
     // start miners
     if (_ctr->can_start()) {
         _ctr->_group_cpu.Start();
@@ -97,7 +112,6 @@ void MinerSignals::NotifyTransaction(const CTransaction& txn, const CBlockIndex*
     // check if blockchain has synced, has more than 1 peer and is enabled before recreating blocks
     if (IsInitialBlockDownload() || !_ctr->can_start())
         return;
-    if (GetTime() - _ctr->_ctx->shared->last_txn() > 60) {
-        _ctr->_ctx->shared->RecreateBlock();
-    }
+    // rebuilt off this thread, once for a burst of transactions
+    _ctr->_builder->Request(MinerTemplateBuilder::MEMPOOL_DELAY_MILLIS);
 };
@@ -11,6 +11,7 @@
 #include "miner/impl/miner-cpu.h"
 #include "miner/impl/miner-gpu.h"
 #include "miner/internal/miners-group.h"
+#include "miner/internal/template-builder.h"
 
 class CNode;
 class CConnman;
@@ -44,6 +45,12 @@ public:
     // Gets combined hash rate of GPU and CPU
     int64_t GetHashRate() const;
 
+    // Gets combined statistics of GPU and CPU miners
+    HashRateStats GetStats() const { return _ctx->counter->GetStats(); }
+
+    // Gets statistics of every GPU and CPU miner thread
+    std::vector<HashRateStats> GetThreadStats() const;
+
     // Returns CPU miners thread group
     MinersThreadGroup<CPUMiner>& group_cpu() { return _group_cpu; }
 
@@ -72,6 +79,10 @@ protected:
     // It can be empty when miner is shutdown
     std::shared_ptr<MinerSignals> _signals{nullptr};
 
+    // Background block template builder
+    // It can be empty when miner is shutdown
+    std::shared_ptr<MinerTemplateBuilder> _builder{nullptr};
+
     // Miner context
     MinerContextRef _ctx;
     // Miner CPU Thread group
@@ -86,11 +97,6 @@ protected:
 
     // Set to true when user requested start
     bool _enable_start = false;
-
-    // Time of last transaction signal
-    int64_t _last_txn_time = 0;
-    // Time of last time block template was created
-    int64_t _last_sync_time = 0;
 };
 
 class MinerSignals
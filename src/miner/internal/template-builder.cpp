@@ -0,0 +1,62 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "miner/internal/template-builder.h"
+#include "miner/internal/miner-context.h"
+#include "util.h"
+#include "utiltime.h"
+
+#include <chrono>
+#include <stdexcept>
+
+
+MinerTemplateBuilder::MinerTemplateBuilder(MinerSharedContextRef shared)
+    : _shared(shared),
+      _thread(&MinerTemplateBuilder::Loop, this){};
+
+MinerTemplateBuilder::~MinerTemplateBuilder()
+{
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        _stop = true;
+    }
+    _cond.notify_all();
+    _thread.join();
+}
+
+void MinerTemplateBuilder::Request(int64_t delay_millis)
+{
+    int64_t due = GetTimeMillis() + delay_millis;
+    {
+        std::lock_guard<std::mutex> guard(_mutex);
+        if (_due != 0 && _due <= due)
+            return;
+        _due = due;
+    }
+    _cond.notify_all();
+}
+
+void MinerTemplateBuilder::Loop()
+{
+    RenameThread("dynamic-miner-template");
+    while (true) {
+        {
+            std::unique_lock<std::mutex> guard(_mutex);
+            while (!_stop && (_due == 0 || GetTimeMillis() < _due)) {
+                if (_due == 0)
+                    _cond.wait(guard);
+                else
+                    _cond.wait_for(guard, std::chrono::milliseconds(_due - GetTimeMillis()));
+            }
+            if (_stop)
+                return;
+            _due = 0;
+        }
+        try {
+            _shared->RecreateBlock();
+        } catch (const std::runtime_error& e) {
+            LogPrintf("MinerTemplateBuilder -- runtime error: %s\n", e.what());
+        }
+    }
+}
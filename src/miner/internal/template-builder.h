@@ -0,0 +1,53 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DYNAMIC_INTERNAL_TEMPLATE_BUILDER_H
+#define DYNAMIC_INTERNAL_TEMPLATE_BUILDER_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+struct MinerSharedContext;
+using MinerSharedContextRef = std::shared_ptr<MinerSharedContext>;
+
+/**
+ * Builds miner block templates on its own thread.
+ *
+ * Filling a template from the mempool and testing its validity takes
+ * long enough to stall validation callbacks, so they only request a
+ * rebuild here. Requests are coalesced: the first one schedules a
+ * rebuild and requests arriving before it is due are folded into it.
+ */
+class MinerTemplateBuilder
+{
+public:
+    // Delay of a rebuild requested because of mempool changes
+    static const int64_t MEMPOOL_DELAY_MILLIS = 5 * 1000;
+
+    explicit MinerTemplateBuilder(MinerSharedContextRef shared);
+    ~MinerTemplateBuilder();
+
+    // Schedules a rebuild in delay_millis, an earlier pending one is kept
+    void Request(int64_t delay_millis = 0);
+
+private:
+    // Builder thread loop
+    void Loop();
+
+    MinerSharedContextRef _shared;
+
+    // Protects everything below
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    // Time the pending rebuild is due in milliseconds, 0 if none
+    int64_t _due = 0;
+    // Set when the builder shuts down
+    bool _stop = false;
+
+    std::thread _thread;
+};
+
+#endif // DYNAMIC_INTERNAL_TEMPLATE_BUILDER_H
@@ -14,6 +14,7 @@
 #include "fluid/fluidmining.h"
 #include "fluid/fluidmint.h"
 #include "governance.h"
+#include "miner/template-assembler.h"
 #include "policy/policy.h"
 #include "pow.h"
 #include "primitives/transaction.h"
@@ -67,16 +68,12 @@ int64_t UpdateTime(CBlockHeader& block, const Consensus::Params& cparams, const
     return new_time - old_time;
 }
 
-class ScoreCompare
+static CBlockTemplateAssembler& GetTemplateAssembler()
 {
-public:
-    ScoreCompare() {}
-
-    bool operator()(const CTxMemPool::txiter a, const CTxMemPool::txiter b)
-    {
-        return CompareTxMemPoolEntryByScore()(*b, *a); // Convert to less than
-    }
-};
+    // Follows the mempool from the first template on
+    static CBlockTemplateAssembler assembler(mempool);
+    return assembler;
+}
 
 // Unconfirmed transactions in the memory pool often depend on other
 // transactions in the memory pool. When we select transactions from the
@@ -85,7 +82,7 @@ public:
 uint64_t nLastBlockTx = 0;
 uint64_t nLastBlockSize = 0;
 
-std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams, const CScript* scriptPubKeyIn)
+std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams, const CScript* scriptPubKeyIn, bool fIncludeMempool)
 {
     // Create new block
     std::unique_ptr<CBlockTemplate> pblocktemplate(new CBlockTemplate());
@@ -153,7 +150,21 @@ std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams,
         int64_t nLockTimeCutoff = (STANDARD_LOCKTIME_VERIFY_FLAGS & LOCKTIME_MEDIAN_TIME_PAST) ? nMedianTimePast : block.GetBlockTime();
 
 
-        bool fPriorityBlock = nBlockPrioritySize > 0;
+        bool fPriorityBlock = fIncludeMempool && nBlockPrioritySize > 0;
+        // Without a priority area the selection is kept up to date from mempool events
+        const bool fIncremental = fIncludeMempool && !fPriorityBlock;
+        if (fIncremental) {
+            for (CTxMemPool::txiter iter : GetTemplateAssembler().Update(indexPrev, nLockTimeCutoff, nBlockMaxSize, nBlockMinSize)) {
+                block.vtx.emplace_back(iter->GetSharedTx());
+                pblocktemplate->vTxFees.push_back(iter->GetFee());
+                pblocktemplate->vTxSigOps.push_back(iter->GetSigOpCount());
+                nBlockSize += iter->GetTxSize();
+                ++nBlockTx;
+                nBlockSigOps += iter->GetSigOpCount();
+                nFees += iter->GetFee();
+            }
+        }
+
         if (fPriorityBlock) {
             vecPriority.reserve(mempool.mapTx.size());
             for (CTxMemPool::indexed_transaction_set::iterator mi = mempool.mapTx.begin(); mi != mempool.mapTx.end(); ++mi) {
@@ -168,7 +179,7 @@ std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams,
         CTxMemPool::indexed_transaction_set::index<mining_score>::type::iterator mi = mempool.mapTx.get<mining_score>().begin();
         CTxMemPool::txiter iter;
 
-        while (mi != mempool.mapTx.get<mining_score>().end() || !clearedTxs.empty()) {
+        while (fIncludeMempool && !fIncremental && (mi != mempool.mapTx.get<mining_score>().end() || !clearedTxs.empty())) {
             bool priorityTx = false;
             if (fPriorityBlock && !vecPriority.empty()) { // add a tx from priority queue to fill the blockprioritysize
                 priorityTx = true;
@@ -42,8 +42,8 @@ struct CBlockTemplate {
 
 /** Set pubkey script in generated block */
 void SetBlockPubkeyScript(CBlock& block, const CScript& scriptPubKeyIn);
-/** Generate a new block, without valid proof-of-work */
-std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams, const CScript* scriptPubKeyIn = nullptr);
+/** Generate a new block, without valid proof-of-work and with the coinbase only unless fIncludeMempool */
+std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams, const CScript* scriptPubKeyIn = nullptr, bool fIncludeMempool = true);
 std::unique_ptr<CBlockTemplate> CreateNewBlock(const CChainParams& chainparams, const CScript& scriptPubKeyIn);
 /** Called by a miner when new block was found. */
 bool ProcessBlockFound(const CBlock& block, const CChainParams& chainparams);
@@ -12,6 +12,7 @@
 #include "miner/internal/miners-controller.h"
 #include "net.h"
 #include "primitives/transaction.h"
+#include "univalue.h"
 #include "utilmoneystr.h"
 #include "validation.h"
 #include "validationinterface.h"
@@ -71,6 +72,41 @@ int64_t GetGPUHashRate()
     return 0;
 };
 
+static UniValue MinerStatsToJSON(const HashRateStats& stats)
+{
+    UniValue obj(UniValue::VOBJ);
+    if (!stats.device.empty()) {
+        obj.push_back(Pair("device", stats.device));
+        obj.push_back(Pair("thread", stats.thread));
+    }
+    obj.push_back(Pair("hashespersec", stats.hashes_per_sec));
+    obj.push_back(Pair("hashes", stats.hashes));
+    obj.push_back(Pair("templates", stats.templates));
+    obj.push_back(Pair("staletemplates", stats.stale_templates));
+    obj.push_back(Pair("blocksaccepted", stats.blocks_accepted));
+    obj.push_back(Pair("blocksrejected", stats.blocks_rejected));
+    obj.push_back(Pair("refreshlatencyavg", stats.templates ? stats.refresh_latency_total / stats.templates : 0));
+    obj.push_back(Pair("refreshlatencymax", stats.refresh_latency_max));
+    return obj;
+}
+
+UniValue GetMinerStats()
+{
+    HashRateStats stats;
+    std::vector<HashRateStats> thread_stats;
+    if (gMiners) {
+        stats = gMiners->GetStats();
+        thread_stats = gMiners->GetThreadStats();
+    }
+    UniValue obj = MinerStatsToJSON(stats);
+    UniValue threads(UniValue::VARR);
+    for (const auto& thread : thread_stats) {
+        threads.push_back(MinerStatsToJSON(thread));
+    }
+    obj.push_back(Pair("threads", threads));
+    return obj;
+}
+
 void SetCPUMinerThreads(uint8_t target)
 {
     assert(gMiners);
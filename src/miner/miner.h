@@ -11,6 +11,7 @@ class CConnman;
 class CChainParams;
 
 class MinersController;
+class UniValue;
 
 /** It's constructed and set in init.cpp */
 extern std::unique_ptr<MinersController> gMiners;
@@ -32,6 +33,8 @@ int64_t GetHashRate();
 int64_t GetCPUHashRate();
 /** Gets hash rate of GPU */
 int64_t GetGPUHashRate();
+/** Gets hash rate and block template statistics of all miners and of every miner thread */
+UniValue GetMinerStats();
 
 /** Sets amount of CPU miner threads */
 void SetCPUMinerThreads(uint8_t target);
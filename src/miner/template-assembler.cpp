@@ -0,0 +1,245 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "miner/template-assembler.h"
+#include "chain.h"
+#include "consensus/consensus.h"
+#include "validation.h"
+
+#include <queue>
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+CBlockTemplateAssembler::CBlockTemplateAssembler(CTxMemPool& poolIn)
+    : pool(poolIn),
+      connAdded(pool.NotifyEntryAdded.connect(boost::bind(&CBlockTemplateAssembler::TransactionAddedToMempool, this, _1))),
+      connRemoved(pool.NotifyEntryRemoved.connect(boost::bind(&CBlockTemplateAssembler::TransactionRemovedFromMempool, this, _1, _2))),
+      nHeight(0),
+      nLockTimeCutoff(0),
+      nBlockMaxSize(0),
+      nBlockMinSize(0)
+{
+    Reset();
+}
+
+void CBlockTemplateAssembler::Reset()
+{
+    vSelected.clear();
+    setSelected.clear();
+    nBlockSize = 1000;
+    nBlockSigOps = 100;
+    fRefill = true;
+    fCleared = false;
+    nMinScoreFee = 0;
+    nMinScoreSize = 0;
+}
+
+bool CBlockTemplateAssembler::HasSelectedParents(CTxMemPool::txiter iter) const
+{
+    BOOST_FOREACH (CTxMemPool::txiter parent, pool.GetMemPoolParents(iter)) {
+        if (!setSelected.count(parent->GetTx().GetHash()))
+            return false;
+    }
+    return true;
+}
+
+void CBlockTemplateAssembler::Select(CTxMemPool::txiter iter)
+{
+    const uint256& hash = iter->GetTx().GetHash();
+    vSelected.push_back(hash);
+    setSelected.insert(hash);
+    nBlockSize += iter->GetTxSize();
+    nBlockSigOps += iter->GetSigOpCount();
+
+    // Same ordering as CompareTxMemPoolEntryByScore
+    if (nMinScoreSize == 0 || (double)iter->GetModifiedFee() * nMinScoreSize < (double)nMinScoreFee * iter->GetTxSize()) {
+        nMinScoreFee = iter->GetModifiedFee();
+        nMinScoreSize = iter->GetTxSize();
+    }
+}
+
+void CBlockTemplateAssembler::TransactionAddedToMempool(CTransactionRef tx)
+{
+    LOCK(pool.cs);
+
+    // Nothing to keep up to date before the first template
+    if (hashPrevBlock.IsNull())
+        return;
+
+    if (setSelected.count(tx->GetHash()))
+        fCleared = true;
+    vAdded.push_back(tx->GetHash());
+}
+
+bool CBlockTemplateAssembler::SelectAdded()
+{
+    std::vector<uint256> vQueued;
+    vQueued.swap(vAdded);
+
+    for (const uint256& hash : vQueued) {
+        // Gone again or selected by a refill in the meantime
+        CTxMemPool::txiter iter = pool.mapTx.find(hash);
+        if (iter == pool.mapTx.end() || setSelected.count(hash) || !HasSelectedParents(iter))
+            continue;
+
+        unsigned int nTxSize = iter->GetTxSize();
+        if (iter->GetModifiedFee() < ::minRelayTxFee.GetFee(nTxSize) && nBlockSize >= nBlockMinSize)
+            continue;
+        if (!IsFinalTx(iter->GetTx(), nHeight, nLockTimeCutoff))
+            continue;
+        if (nBlockSize + nTxSize >= nBlockMaxSize || nBlockSigOps + iter->GetSigOpCount() >= MAX_BLOCK_SIGOPS) {
+            // Appending only would leave a better paying transaction out of the block
+            if ((double)iter->GetModifiedFee() * nMinScoreSize > (double)nMinScoreFee * nTxSize)
+                return false;
+            continue;
+        }
+
+        Select(iter);
+    }
+    return true;
+}
+
+void CBlockTemplateAssembler::TransactionRemovedFromMempool(CTransactionRef tx, MemPoolRemovalReason reason)
+{
+    // Children of a transaction removed for a block stay valid, for any
+    // other reason the mempool removes them as well and we get notified
+    const uint256& hash = tx->GetHash();
+    if (!setSelected.erase(hash))
+        return;
+
+    // The entry is still in the mempool while it is being removed
+    CTxMemPool::txiter iter = pool.mapTx.find(hash);
+    if (iter != pool.mapTx.end()) {
+        nBlockSize -= iter->GetTxSize();
+        nBlockSigOps -= iter->GetSigOpCount();
+    }
+    fRefill = true;
+}
+
+void CBlockTemplateAssembler::Refill()
+{
+    // Same selection as the fee part of CreateNewBlock, skipping what is selected already
+    CTxMemPool::setEntries waitSet;
+    std::priority_queue<CTxMemPool::txiter, std::vector<CTxMemPool::txiter>, ScoreCompare> clearedTxs;
+    int lastFewTxs = 0;
+
+    CTxMemPool::indexed_transaction_set::index<mining_score>::type::iterator mi = pool.mapTx.get<mining_score>().begin();
+    CTxMemPool::txiter iter;
+
+    while (mi != pool.mapTx.get<mining_score>().end() || !clearedTxs.empty()) {
+        if (clearedTxs.empty()) { // add tx with next highest score
+            iter = pool.mapTx.project<0>(mi);
+            mi++;
+        } else { // try to add a previously postponed child tx
+            iter = clearedTxs.top();
+            clearedTxs.pop();
+        }
+
+        if (setSelected.count(iter->GetTx().GetHash()))
+            continue;
+
+        if (!HasSelectedParents(iter)) {
+            waitSet.insert(iter);
+            continue;
+        }
+
+        unsigned int nTxSize = iter->GetTxSize();
+        if (iter->GetModifiedFee() < ::minRelayTxFee.GetFee(nTxSize) && nBlockSize >= nBlockMinSize) {
+            break;
+        }
+        if (nBlockSize + nTxSize >= nBlockMaxSize) {
+            if (nBlockSize > nBlockMaxSize - 100 || lastFewTxs > 50) {
+                break;
+            }
+            // Once we're within 1000 bytes of a full block, only look at 50 more txs
+            // to try to fill the remaining space.
+            if (nBlockSize > nBlockMaxSize - 1000) {
+                lastFewTxs++;
+            }
+            continue;
+        }
+
+        if (!IsFinalTx(iter->GetTx(), nHeight, nLockTimeCutoff))
+            continue;
+
+        unsigned int nTxSigOps = iter->GetSigOpCount();
+        if (nBlockSigOps + nTxSigOps >= MAX_BLOCK_SIGOPS) {
+            if (nBlockSigOps > MAX_BLOCK_SIGOPS - 2) {
+                break;
+            }
+            continue;
+        }
+
+        Select(iter);
+
+        // Add transactions that depend on this one to the priority queue
+        BOOST_FOREACH (CTxMemPool::txiter child, pool.GetMemPoolChildren(iter)) {
+            if (waitSet.count(child)) {
+                clearedTxs.push(child);
+                waitSet.erase(child);
+            }
+        }
+    }
+    fRefill = false;
+}
+
+std::vector<CTxMemPool::txiter> CBlockTemplateAssembler::Update(const CBlockIndex* indexPrev, int64_t nLockTimeCutoffIn, unsigned int nBlockMaxSizeIn, unsigned int nBlockMinSizeIn)
+{
+    AssertLockHeld(pool.cs);
+
+    // Blocks connected on top of the selection only free space,
+    // anything else means selecting from scratch
+    const CBlockIndex* pindexSelected = hashPrevBlock.IsNull() ? NULL : indexPrev->GetAncestor(nHeight - 1);
+    bool fConnected = pindexSelected && pindexSelected->GetBlockHash() == hashPrevBlock && !fCleared &&
+                      nBlockMaxSizeIn == nBlockMaxSize && nBlockMinSizeIn == nBlockMinSize;
+    if (!fConnected) {
+        Reset();
+        vAdded.clear();
+    } else if (indexPrev->GetBlockHash() != hashPrevBlock || nLockTimeCutoffIn != nLockTimeCutoff) {
+        // Transactions may have become final
+        fRefill = true;
+    }
+    hashPrevBlock = indexPrev->GetBlockHash();
+    nHeight = indexPrev->nHeight + 1;
+    nLockTimeCutoff = nLockTimeCutoffIn;
+    nBlockMaxSize = nBlockMaxSizeIn;
+    nBlockMinSize = nBlockMinSizeIn;
+
+    // Drop transactions that left the selection, a transaction selected
+    // again after leaving it counts at its last position
+    if (vSelected.size() != setSelected.size()) {
+        std::set<uint256> setSeen;
+        std::vector<uint256> vKeep;
+        for (std::vector<uint256>::const_reverse_iterator it = vSelected.rbegin(); it != vSelected.rend(); ++it) {
+            if (setSelected.count(*it) && setSeen.insert(*it).second)
+                vKeep.push_back(*it);
+        }
+        vSelected.assign(vKeep.rbegin(), vKeep.rend());
+    }
+
+    if (fRefill)
+        Refill();
+    if (!SelectAdded()) {
+        Reset();
+        Refill();
+    }
+
+    std::vector<CTxMemPool::txiter> vIters;
+    vIters.reserve(vSelected.size());
+    for (const uint256& hash : vSelected) {
+        CTxMemPool::txiter iter = pool.mapTx.find(hash);
+        if (iter == pool.mapTx.end()) {
+            // The mempool was cleared without removal notifications
+            Reset();
+            Refill();
+            vIters.clear();
+            for (const uint256& hashSelected : vSelected)
+                vIters.push_back(pool.mapTx.find(hashSelected));
+            break;
+        }
+        vIters.push_back(iter);
+    }
+    return vIters;
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef DYNAMIC_MINER_TEMPLATE_ASSEMBLER_H
+#define DYNAMIC_MINER_TEMPLATE_ASSEMBLER_H
+
+#include "amount.h"
+#include "txmempool.h"
+#include "uint256.h"
+
+#include <set>
+#include <vector>
+
+#include <boost/signals2/signal.hpp>
+
+class CBlockIndex;
+
+class ScoreCompare
+{
+public:
+    ScoreCompare() {}
+
+    bool operator()(const CTxMemPool::txiter a, const CTxMemPool::txiter b)
+    {
+        return CompareTxMemPoolEntryByScore()(*b, *a); // Convert to less than
+    }
+};
+
+/**
+ * Mempool transactions selected for the next block, kept up to date
+ * from mempool events instead of being selected from scratch for every
+ * block template.
+ *
+ * Transactions entering the mempool are queued and appended on the next
+ * update when their parents are selected and they fit, transactions
+ * leaving it are dropped from the selection. Once a new block connects
+ * the freed space is filled in mining score order. The selection is
+ * rebuilt from scratch after a reorg, when the block size limits change
+ * or when a transaction that does not fit anymore outscores the lowest
+ * scoring one selected.
+ *
+ * Selection follows the fee part of CreateNewBlock, transactions getting
+ * in for free because of their priority are left to the full selection.
+ * All members are guarded by pool.cs.
+ */
+class CBlockTemplateAssembler
+{
+public:
+    explicit CBlockTemplateAssembler(CTxMemPool& poolIn);
+
+    /**
+     * Brings the selection up to date for a block on top of indexPrev and
+     * returns it in block order. Requires pool.cs.
+     */
+    std::vector<CTxMemPool::txiter> Update(const CBlockIndex* indexPrev, int64_t nLockTimeCutoff, unsigned int nBlockMaxSizeIn, unsigned int nBlockMinSizeIn);
+
+private:
+    CTxMemPool& pool;
+
+    boost::signals2::scoped_connection connAdded;
+    boost::signals2::scoped_connection connRemoved;
+
+    // Block the selection is made for, null until the first update
+    uint256 hashPrevBlock;
+    int nHeight;
+    int64_t nLockTimeCutoff;
+    unsigned int nBlockMaxSize;
+    unsigned int nBlockMinSize;
+
+    // Selected transactions in block order
+    std::vector<uint256> vSelected;
+    std::set<uint256> setSelected;
+    // Set when transactions left the selection and their space can be refilled
+    bool fRefill;
+    // Transactions added to the mempool since the last update, the
+    // notification arrives before the entry is in pool.mapTx
+    std::vector<uint256> vAdded;
+    // Set when a selected transaction is added again, the mempool was
+    // cleared without removal notifications
+    bool fCleared;
+    // Score of the lowest scoring selected transaction, may be lower than
+    // the actual lowest once transactions leave the selection
+    CAmount nMinScoreFee;
+    size_t nMinScoreSize;
+
+    // Totals including the space reserved for the coinbase
+    uint64_t nBlockSize;
+    unsigned int nBlockSigOps;
+
+    void TransactionAddedToMempool(CTransactionRef tx);
+    void TransactionRemovedFromMempool(CTransactionRef tx, MemPoolRemovalReason reason);
+
+    void Reset();
+    void Refill();
+    bool HasSelectedParents(CTxMemPool::txiter iter) const;
+    void Select(CTxMemPool::txiter iter);
+    /** Selects the transactions queued by TransactionAddedToMempool, returns false when the selection has to be rebuilt */
+    bool SelectAdded();
+};
+
+#endif // DYNAMIC_MINER_TEMPLATE_ASSEMBLER_H
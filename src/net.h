@@ -28,6 +28,7 @@
 #include <condition_variable>
 #include <deque>
 #include <memory>
+#include <set>
 #include <stdint.h>
 #include <thread>
 
@@ -98,6 +99,25 @@ static const size_t DEFAULT_MAXSENDBUFFER = 1 * 1000;
 
 static const ServiceFlags REQUIRED_SERVICES = NODE_NETWORK;
 
+/** Mechanism used by the socket handler thread to wait for socket readiness */
+enum SocketEventsMode {
+    SOCKETEVENTS_SELECT = 0,
+    SOCKETEVENTS_EPOLL = 1,
+};
+
+/** -socketevents default */
+#ifdef USE_EPOLL
+static const char* const DEFAULT_SOCKETEVENTS = "epoll";
+#else
+static const char* const DEFAULT_SOCKETEVENTS = "select";
+#endif
+/** Maximum number of ready sockets returned by a single epoll_wait() call */
+static const int MAX_EPOLL_EVENTS = 1024;
+/** -msghandlerthreads default, 1 keeps all message processing on a single thread */
+static const int DEFAULT_MSG_HANDLER_THREADS = 1;
+/** Maximum number of message handler threads */
+static const int MAX_MSG_HANDLER_THREADS = 16;
+
 // NOTE: When adjusting this, update rpcnet:setban's help ("24h")
 static const unsigned int DEFAULT_MISBEHAVING_BANTIME = 60 * 60 * 24; // Default 24-hour ban
 
@@ -155,6 +175,8 @@ public:
         unsigned int nReceiveFloodSize = 0;
         uint64_t nMaxOutboundTimeframe = 0;
         uint64_t nMaxOutboundLimit = 0;
+        SocketEventsMode socketEventsMode = SOCKETEVENTS_SELECT;
+        int nMessageHandlerThreads = DEFAULT_MSG_HANDLER_THREADS;
     };
     CConnman(uint64_t seed0, uint64_t seed1);
     ~CConnman();
@@ -405,6 +427,18 @@ public:
     unsigned int GetReceiveFloodSize() const;
 
     void WakeMessageHandler();
+    void WakeMessageHandler(const CNode* pnode);
+
+    /** Whether peers are spread over several message handler threads, with cs_main work going through the validation queue */
+    bool IsMessageHandlerSharded() const { return nMessageHandlerThreads > 1; }
+    /**
+     * Run func on the validation thread. No further messages of pnode are
+     * processed until it has completed, so per-peer ordering is preserved.
+     */
+    void PushValidationTask(CNode* pnode, std::function<void()> func);
+
+    /** Whether the socket events backend can wait on hSocket */
+    bool IsSocketUsable(SOCKET hSocket) const;
 
 private:
     struct ListenSocket {
@@ -417,8 +451,14 @@ private:
     void ThreadOpenAddedConnections();
     void ProcessOneShot();
     void ThreadOpenConnections();
-    void ThreadMessageHandler();
+    void ThreadMessageHandler(int nShard);
+    void ThreadValidationQueue();
     void AcceptConnection(const ListenSocket& hListenSocket);
+    void SocketEvents(std::set<SOCKET>& recv_set, std::set<SOCKET>& send_set, std::set<SOCKET>& error_set);
+    void SocketEventsSelect(std::set<SOCKET>& recv_set, std::set<SOCKET>& send_set, std::set<SOCKET>& error_set);
+#ifdef USE_EPOLL
+    void SocketEventsEpoll(std::set<SOCKET>& recv_set, std::set<SOCKET>& send_set, std::set<SOCKET>& error_set);
+#endif
     void ThreadSocketHandler();
     void ThreadDNSAddressSeed();
     void ThreadOpenDynodeConnections();
@@ -477,6 +517,8 @@ private:
     unsigned int nReceiveFloodSize;
 
     std::vector<ListenSocket> vhListenSocket;
+    SocketEventsMode socketEventsMode;
+    int epollfd;
     std::atomic<bool> fNetworkActive;
     banmap_t setBanned;
     CCriticalSection cs_setBanned;
@@ -517,12 +559,18 @@ private:
     const uint64_t nSeed0, nSeed1;
 
     /** flag for waking the message processor. */
-    bool fMsgProcWake;
+    int nMessageHandlerThreads;
+    // per message handler thread wake flags, guarded by mutexMsgProc
+    std::vector<bool> vMsgProcWake;
 
     std::condition_variable condMsgProc;
     std::mutex mutexMsgProc;
     std::atomic<bool> flagInterruptMsgProc;
 
+    std::deque<std::pair<CNode*, std::function<void()> > > queueValidation;
+    std::condition_variable condValidation;
+    std::mutex mutexValidation;
+
     CThreadInterrupt interruptNet;
 
     std::thread threadDNSAddressSeed;
@@ -530,7 +578,8 @@ private:
     std::thread threadOpenAddedConnections;
     std::thread threadOpenConnections;
     std::thread threadOpenDynodeConnections;
-    std::thread threadMessageHandler;
+    std::vector<std::thread> threadMessageHandlers;
+    std::thread threadValidationQueue;
 };
 extern std::unique_ptr<CConnman> g_connman;
 void Discover(boost::thread_group& threadGroup);
@@ -702,6 +751,8 @@ public:
     std::deque<std::vector<unsigned char> > vSendMsg;
     CCriticalSection cs_vSend;
     CCriticalSection cs_hSocket;
+    // epoll interest currently registered for hSocket, -1 if not registered (guarded by cs_hSocket)
+    int nEpollEvents;
     CCriticalSection cs_vRecv;
 
     CCriticalSection cs_vProcessMsg;
@@ -755,6 +806,8 @@ public:
 
     std::atomic_bool fPauseRecv;
     std::atomic_bool fPauseSend;
+    // a message of this peer is waiting on (or running in) the validation queue
+    std::atomic_bool fValidationPending;
 
 protected:
     mapMsgCmdSize mapSendBytesPerMsgCmd;
@@ -994,6 +994,9 @@ static void RelayAddress(const CAddress& addr, bool fReachable, CConnman& connma
         }
     };
 
+    // SendMessages() reads the address queues of the peers under cs_main,
+    // with sharded message handlers they run on other threads
+    LOCK(cs_main);
     auto pushfunc = [&addr, &best, nRelayNodes, &insecure_rand] {
         for (unsigned int i = 0; i < nRelayNodes && best[i].first != 0; i++) {
             best[i].second->PushAddress(addr, insecure_rand);
@@ -1003,10 +1006,15 @@ static void RelayAddress(const CAddress& addr, bool fReachable, CConnman& connma
     connman.ForEachNodeThen(std::move(sortfunc), std::move(pushfunc));
 }
 
-void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParams, CConnman& connman, const std::atomic<bool>& interruptMsgProc)
+/**
+ * Serves the getdata requests that need cs_main. A plain block request is
+ * only checked here, its disk position is returned in posRawBlock so the
+ * caller reads and sends it after cs_main is released. Returns false when
+ * interrupted.
+ */
+bool static ProcessGetDataLocked(CNode* pfrom, const Consensus::Params& consensusParams, CConnman& connman, const std::atomic<bool>& interruptMsgProc,
+                                 std::deque<CInv>::iterator& it, std::vector<CInv>& vNotFound, CDiskBlockPos& posRawBlock, std::vector<CInv>& vContinueInv)
 {
-    std::deque<CInv>::iterator it = pfrom->vRecvGetData.begin();
-    std::vector<CInv> vNotFound;
     const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
     LOCK(cs_main);
 
@@ -1019,7 +1027,7 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
         LogPrint("net", "ProcessGetData -- inv = %s\n", inv.ToString());
         {
             if (interruptMsgProc)
-                return;
+                return false;
 
             it++;
 
@@ -1070,12 +1078,13 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
                 // Pruned nodes may have deleted the block, so check whether
                 // it's available before trying to send.
                 if (send && (mi->second->nStatus & BLOCK_HAVE_DATA)) {
-                    // Send block from disk
+                    // Send block from disk. Plain blocks are sent as the raw bytes stored
+                    // on disk once cs_main is released; no deserialize, Argon2d rehash or reserialize.
                     CBlock block;
-                    if (!ReadBlockFromDisk(block, (*mi).second, consensusParams))
+                    if (inv.type != MSG_BLOCK && !ReadBlockFromDisk(block, (*mi).second, consensusParams))
                         assert(!"cannot load block from disk");
                     if (inv.type == MSG_BLOCK)
-                        connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::BLOCK, block));
+                        posRawBlock = (*mi).second->GetBlockPos();
                     else if (inv.type == MSG_FILTERED_BLOCK) {
                         bool sendMerkleBlock = false;
                         CMerkleBlock merkleBlock;
@@ -1117,9 +1126,7 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
                         // Bypass PushInventory, this must send even if redundant,
                         // and we want it right after the last block so they don't
                         // wait for other stuff first.
-                        std::vector<CInv> vInv;
-                        vInv.push_back(CInv(MSG_BLOCK, chainActive.Tip()->GetBlockHash()));
-                        connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::INV, vInv));
+                        vContinueInv.push_back(CInv(MSG_BLOCK, chainActive.Tip()->GetBlockHash()));
                         pfrom->hashContinue.SetNull();
                     }
                 }
@@ -1268,6 +1275,31 @@ void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParam
                 break;
         }
     }
+    return true;
+}
+
+void static ProcessGetData(CNode* pfrom, const Consensus::Params& consensusParams, CConnman& connman, const std::atomic<bool>& interruptMsgProc)
+{
+    std::deque<CInv>::iterator it = pfrom->vRecvGetData.begin();
+    std::vector<CInv> vNotFound;
+    const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
+    CDiskBlockPos posRawBlock;
+    std::vector<CInv> vContinueInv;
+    if (!ProcessGetDataLocked(pfrom, consensusParams, connman, interruptMsgProc, it, vNotFound, posRawBlock, vContinueInv))
+        return;
+
+    if (!posRawBlock.IsNull()) {
+        // The block may have been pruned since cs_main was released; the peer will then time out the request
+        CSerializedNetMsg msg;
+        msg.command = NetMsgType::BLOCK;
+        if (ReadRawBlockFromDisk(msg.data, posRawBlock, Params().MessageStart()))
+            connman.PushMessage(pfrom, std::move(msg));
+        else if (!fPruneMode)
+            assert(!"cannot load block from disk");
+    }
+
+    if (!vContinueInv.empty())
+        connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::INV, vContinueInv));
 
     pfrom->vRecvGetData.erase(pfrom->vRecvGetData.begin(), it);
 
@@ -2804,6 +2836,88 @@ static bool SendRejectsAndCheckIfBanned(CNode* pnode, CConnman& connman)
     return false;
 }
 
+/**
+ * Messages handled directly on the peer's message handler thread when message
+ * processing is sharded. Their handlers only touch state of the sending peer
+ * and need cs_main at most briefly (Misbehaving()).
+ */
+static bool IsLightweightMessage(const std::string& strCommand)
+{
+    return strCommand == NetMsgType::PING ||
+           strCommand == NetMsgType::PONG ||
+           strCommand == NetMsgType::NOTFOUND ||
+           strCommand == NetMsgType::REJECT ||
+           strCommand == NetMsgType::FILTERLOAD ||
+           strCommand == NetMsgType::FILTERADD ||
+           strCommand == NetMsgType::FILTERCLEAR;
+}
+
+/**
+ * Cheap checks done without cs_main before a message is handed to the
+ * validation queue, so that gossip we already have does not occupy it.
+ * Returns false if the message can be dropped.
+ */
+static bool PreValidateMessage(CNode* pfrom, const std::string& strCommand, const CDataStream& vRecv)
+{
+    try {
+        if (strCommand == NetMsgType::DNPING) {
+            CDataStream ss(vRecv);
+            CDynodePing dnp;
+            ss >> dnp;
+            uint256 nHash = dnp.GetHash();
+            if (!dynodeSync.IsBlockchainSynced() || dnodeman.HasSeenDynodePing(nHash)) {
+                pfrom->setAskFor.erase(nHash);
+                return false;
+            }
+        } else if (strCommand == NetMsgType::TXLOCKVOTE && pfrom->nVersion >= MIN_INSTANTSEND_PROTO_VERSION) {
+            CDataStream ss(vRecv);
+            CTxLockVote vote;
+            ss >> vote;
+            uint256 nVoteHash = vote.GetHash();
+            if (!dynodeSync.IsDynodeListSynced() || instantsend.AlreadyHave(nVoteHash)) {
+                pfrom->setAskFor.erase(nVoteHash);
+                return false;
+            }
+        }
+    } catch (const std::exception&) {
+        // Leave malformed messages to the full handler, which reports them
+    }
+    return true;
+}
+
+static bool ProcessMessageCatchingExceptions(CNode* pfrom, CNetMessage& msg, const CChainParams& chainparams, CConnman& connman, const std::atomic<bool>& interruptMsgProc)
+{
+    const std::string strCommand = msg.hdr.GetCommand();
+    unsigned int nMessageSize = msg.hdr.nMessageSize;
+    bool fRet = false;
+    try {
+        fRet = ProcessMessage(pfrom, strCommand, msg.vRecv, msg.nTime, chainparams, connman, interruptMsgProc);
+    } catch (const std::ios_base::failure& e) {
+        connman.PushMessage(pfrom, CNetMsgMaker(INIT_PROTO_VERSION).Make(NetMsgType::REJECT, strCommand, REJECT_MALFORMED, std::string("error parsing message")));
+        if (strstr(e.what(), "end of data")) {
+            // Allow exceptions from under-length message on vRecv
+            LogPrintf("%s(%s, %u bytes): Exception '%s' caught, normally caused by a message being shorter than its stated length\n", __func__, SanitizeString(strCommand), nMessageSize, e.what());
+        } else if (strstr(e.what(), "size too large")) {
+            // Allow exceptions from over-long size
+            LogPrintf("%s(%s, %u bytes): Exception '%s' caught\n", __func__, SanitizeString(strCommand), nMessageSize, e.what());
+        } else if (strstr(e.what(), "non-canonical ReadCompactSize()")) {
+            // Allow exceptions from non-canonical encoding
+            LogPrintf("%s(%s, %u bytes): Exception '%s' caught\n", __func__, SanitizeString(strCommand), nMessageSize, e.what());
+        } else {
+            PrintExceptionContinue(&e, "ProcessMessages()");
+        }
+    } catch (const std::exception& e) {
+        PrintExceptionContinue(&e, "ProcessMessages()");
+    } catch (...) {
+        PrintExceptionContinue(NULL, "ProcessMessages()");
+    }
+
+    if (!fRet)
+        LogPrintf("%s(%s, %u bytes) FAILED peer=%d\n", __func__, SanitizeString(strCommand), nMessageSize, pfrom->id);
+
+    return fRet;
+}
+
 bool ProcessMessages(CNode* pfrom, CConnman& connman, const std::atomic<bool>& interruptMsgProc)
 {
     const CChainParams& chainparams = Params();
@@ -2817,8 +2931,23 @@ bool ProcessMessages(CNode* pfrom, CConnman& connman, const std::atomic<bool>& i
     //
     bool fMoreWork = false;
 
-    if (!pfrom->vRecvGetData.empty())
+    // An earlier message of this peer is still in the validation queue, which
+    // wakes us up again once it is done
+    if (pfrom->fValidationPending)
+        return false;
+
+    if (!pfrom->vRecvGetData.empty()) {
+        if (connman.IsMessageHandlerSharded()) {
+            // Getdata takes cs_main and reads from disk, keep it off the message handler threads
+            CConnman* pconnman = &connman;
+            const std::atomic<bool>* pinterruptMsgProc = &interruptMsgProc;
+            connman.PushValidationTask(pfrom, [pfrom, pconnman, pinterruptMsgProc]() {
+                ProcessGetData(pfrom, Params().GetConsensus(), *pconnman, *pinterruptMsgProc);
+            });
+            return false;
+        }
         ProcessGetData(pfrom, chainparams.GetConsensus(), connman, interruptMsgProc);
+    }
 
     if (pfrom->fDisconnect)
         return false;
@@ -2831,7 +2960,8 @@ bool ProcessMessages(CNode* pfrom, CConnman& connman, const std::atomic<bool>& i
     if (pfrom->fPauseSend)
         return false;
 
-    std::list<CNetMessage> msgs;
+    std::shared_ptr<std::list<CNetMessage> > pmsgs = std::make_shared<std::list<CNetMessage> >();
+    std::list<CNetMessage>& msgs = *pmsgs;
     {
         LOCK(pfrom->cs_vProcessMsg);
         if (pfrom->vProcessMsg.empty())
@@ -2874,39 +3004,39 @@ bool ProcessMessages(CNode* pfrom, CConnman& connman, const std::atomic<bool>& i
         return fMoreWork;
     }
 
-    // Process message
-    bool fRet = false;
-    try {
-        fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc);
-        if (interruptMsgProc)
-            return false;
-        if (!pfrom->vRecvGetData.empty())
-            fMoreWork = true;
-    } catch (const std::ios_base::failure& e) {
-        connman.PushMessage(pfrom, CNetMsgMaker(INIT_PROTO_VERSION).Make(NetMsgType::REJECT, strCommand, REJECT_MALFORMED, std::string("error parsing message")));
-        if (strstr(e.what(), "end of data")) {
-            // Allow exceptions from under-length message on vRecv
-            LogPrintf("%s(%s, %u bytes): Exception '%s' caught, normally caused by a message being shorter than its stated length\n", __func__, SanitizeString(strCommand), nMessageSize, e.what());
-        } else if (strstr(e.what(), "size too large")) {
-            // Allow exceptions from over-long size
-            LogPrintf("%s(%s, %u bytes): Exception '%s' caught\n", __func__, SanitizeString(strCommand), nMessageSize, e.what());
-        } else if (strstr(e.what(), "non-canonical ReadCompactSize()")) {
-            // Allow exceptions from non-canonical encoding
-            LogPrintf("%s(%s, %u bytes): Exception '%s' caught\n", __func__, SanitizeString(strCommand), nMessageSize, e.what());
-        } else {
-            PrintExceptionContinue(&e, "ProcessMessages()");
-        }
-    } catch (const std::exception& e) {
-        PrintExceptionContinue(&e, "ProcessMessages()");
-    } catch (...) {
-        PrintExceptionContinue(NULL, "ProcessMessages()");
+    if (connman.IsMessageHandlerSharded() && !IsLightweightMessage(strCommand)) {
+        if (!PreValidateMessage(pfrom, strCommand, vRecv))
+            return fMoreWork;
+        // Everything else runs on the single validation thread. Handlers take
+        // cs_main themselves as on the single message handler thread, so that
+        // block connection callbacks run without it. SendMessages() skips the
+        // peer until the task is done.
+        CConnman* pconnman = &connman;
+        const std::atomic<bool>* pinterruptMsgProc = &interruptMsgProc;
+        connman.PushValidationTask(pfrom, [pfrom, pmsgs, pconnman, pinterruptMsgProc]() {
+            ProcessMessageCatchingExceptions(pfrom, pmsgs->front(), Params(), *pconnman, *pinterruptMsgProc);
+            LOCK(cs_main);
+            SendRejectsAndCheckIfBanned(pfrom, *pconnman);
+        });
+        return false;
     }
 
-    if (!fRet)
-        LogPrintf("%s(%s, %u bytes) FAILED peer=%d\n", __func__, SanitizeString(strCommand), nMessageSize, pfrom->id);
+    // Process message
+    ProcessMessageCatchingExceptions(pfrom, msg, chainparams, connman, interruptMsgProc);
+    if (interruptMsgProc)
+        return false;
+    if (!pfrom->vRecvGetData.empty())
+        fMoreWork = true;
 
-    LOCK(cs_main);
-    SendRejectsAndCheckIfBanned(pfrom, connman);
+    if (connman.IsMessageHandlerSharded()) {
+        // Don't wait behind the validation thread, SendMessages() retries
+        TRY_LOCK(cs_main, lockMain);
+        if (lockMain)
+            SendRejectsAndCheckIfBanned(pfrom, connman);
+    } else {
+        LOCK(cs_main);
+        SendRejectsAndCheckIfBanned(pfrom, connman);
+    }
 
     return fMoreWork;
 }
@@ -11,9 +11,73 @@
 #include "tinyformat.h"
 #include "utilstrencodings.h"
 
+#include <assert.h>
+#include <atomic>
+#include <string.h>
+
+static std::atomic<uint64_t> nHashComputations(0);
+
+CBlockHeaderHashCache& CBlockHeaderHashCache::operator=(const CBlockHeaderHashCache& other)
+{
+    if (this == &other)
+        return *this;
+    unsigned char vchHeaderCopy[BLOCK_HEADER_HASHED_SIZE];
+    uint256 hashCopy;
+    bool fValidCopy;
+    {
+        std::lock_guard<std::mutex> lock(other.mutex);
+        fValidCopy = other.fValid;
+        if (fValidCopy) {
+            memcpy(vchHeaderCopy, other.vchHeader, BLOCK_HEADER_HASHED_SIZE);
+            hashCopy = other.hash;
+        }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    fValid = fValidCopy;
+    if (fValid) {
+        memcpy(vchHeader, vchHeaderCopy, BLOCK_HEADER_HASHED_SIZE);
+        hash = hashCopy;
+    }
+    return *this;
+}
+
+bool CBlockHeaderHashCache::Get(const char* pheader, uint256& hashRet) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!fValid || memcmp(vchHeader, pheader, BLOCK_HEADER_HASHED_SIZE) != 0)
+        return false;
+    hashRet = hash;
+    return true;
+}
+
+void CBlockHeaderHashCache::Set(const char* pheader, const uint256& hashIn)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    memcpy(vchHeader, pheader, BLOCK_HEADER_HASHED_SIZE);
+    hash = hashIn;
+    fValid = true;
+}
+
 uint256 CBlockHeader::GetHash() const
 {
-    return hash_Argon2d(BEGIN(nVersion), END(nNonce), 1);
+    assert(END(nNonce) - BEGIN(nVersion) == (std::ptrdiff_t)BLOCK_HEADER_HASHED_SIZE);
+    uint256 hash;
+    if (hashCache.Get(BEGIN(nVersion), hash))
+        return hash;
+    hash = hash_Argon2d(BEGIN(nVersion), END(nNonce), 1);
+    nHashComputations++;
+    hashCache.Set(BEGIN(nVersion), hash);
+    return hash;
+}
+
+void CBlockHeader::SetKnownHash(const uint256& hash) const
+{
+    hashCache.Set(BEGIN(nVersion), hash);
+}
+
+uint64_t CBlockHeader::GetHashComputationCount()
+{
+    return nHashComputations;
 }
 
 std::string CBlock::ToString() const
@@ -12,6 +12,35 @@
 #include "uint256.h"
 #include "utilstrencodings.h"
 
+#include <mutex>
+
+/** Size of the hashed part of a block header (nVersion up to and including nNonce) */
+static const size_t BLOCK_HEADER_HASHED_SIZE = 80;
+
+/**
+ * Memoizes the Argon2d hash of a block header. The hash is kept together
+ * with the header bytes it was computed from and only returned while they
+ * still match, so writes to the public header fields (a miner bumping
+ * nNonce, IncrementExtraNonce() replacing hashMerkleRoot) invalidate it
+ * without going through setters.
+ */
+class CBlockHeaderHashCache
+{
+private:
+    mutable std::mutex mutex;
+    unsigned char vchHeader[BLOCK_HEADER_HASHED_SIZE];
+    uint256 hash;
+    bool fValid;
+
+public:
+    CBlockHeaderHashCache() : fValid(false) {}
+    CBlockHeaderHashCache(const CBlockHeaderHashCache& other) : fValid(false) { *this = other; }
+    CBlockHeaderHashCache& operator=(const CBlockHeaderHashCache& other);
+
+    bool Get(const char* pheader, uint256& hashRet) const;
+    void Set(const char* pheader, const uint256& hashIn);
+};
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -30,6 +59,9 @@ public:
     uint32_t nBits;
     uint32_t nNonce;
 
+    // memory only
+    mutable CBlockHeaderHashCache hashCache;
+
     CBlockHeader()
     {
         SetNull();
@@ -65,6 +97,15 @@ public:
 
     uint256 GetHash() const;
 
+    /**
+     * Seed the hash cache with a hash the caller already knows to belong to
+     * the current header fields (e.g. the block index entry it was built from).
+     */
+    void SetKnownHash(const uint256& hash) const;
+
+    /** Number of Argon2d header hashes computed by this process (for tests and stats) */
+    static uint64_t GetHashComputationCount();
+
     int64_t GetBlockTime() const
     {
         return (int64_t)nTime;
@@ -114,14 +155,8 @@ public:
 
     CBlockHeader GetBlockHeader() const
     {
-        CBlockHeader block;
-        block.nVersion = nVersion;
-        block.hashPrevBlock = hashPrevBlock;
-        block.hashMerkleRoot = hashMerkleRoot;
-        block.nTime = nTime;
-        block.nBits = nBits;
-        block.nNonce = nNonce;
-        return block;
+        // copies the header fields together with the cached hash
+        return CBlockHeader(*this);
     }
 
     std::string ToString() const;
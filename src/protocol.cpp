@@ -67,6 +67,8 @@ const char* DNGOVERNANCESYNC = "govsync";
 const char* DNGOVERNANCEOBJECT = "govobj";
 const char* DNGOVERNANCEOBJECTVOTE = "govobjvote";
 const char* DNVERIFY = "dnv";
+const char* GETDNLIST = "getdnlist";
+const char* DNLIST = "dnlist";
 }; // namespace NetMsgType
 
 static const char* ppszTypeName[] =
@@ -147,6 +149,8 @@ const static std::string allNetMessageTypes[] = {
     NetMsgType::DNGOVERNANCEOBJECT,
     NetMsgType::DNGOVERNANCEOBJECTVOTE,
     NetMsgType::DNVERIFY,
+    NetMsgType::GETDNLIST,
+    NetMsgType::DNLIST,
 };
 const static std::vector<std::string> allNetMessageTypesVec(allNetMessageTypes, allNetMessageTypes + ARRAYLEN(allNetMessageTypes));
 
@@ -268,6 +268,8 @@ extern const char* DNGOVERNANCESYNC;
 extern const char* DNGOVERNANCEOBJECT;
 extern const char* DNGOVERNANCEOBJECTVOTE;
 extern const char* DNVERIFY;
+extern const char* GETDNLIST;
+extern const char* DNLIST;
 }; // namespace NetMsgType
 
 /* Get a vector of all valid message types (see above) */
@@ -290,6 +292,9 @@ enum ServiceFlags : uint64_t {
     // NODE_XTHIN means the node supports Xtreme Thinblocks
     // If this is turned off then the node will not service nor make xthin requests
     NODE_XTHIN = (1 << 3),
+    // NODE_DNLIST means the node can serve and request the Dynode list with
+    // "getdnlist"/"dnlist" snapshots and diffs instead of one DNANNOUNCE per entry.
+    NODE_DNLIST = (1 << 4),
 
     // Bits 24-31 are reserved for temporary experiments. Just pick a bit that
     // isn't getting used, or one not being used much, and notify the
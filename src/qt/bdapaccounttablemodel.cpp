@@ -3,158 +3,169 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "bdapaccounttablemodel.h"
+
 #include "bdappage.h"
 #include "guiconstants.h"
 #include "guiutil.h"
-#include "sync.h"
-#include "validation.h" // for cs_main
-#include "rpcregister.h"
-#include "rpcserver.h"
-#include "rpcclient.h"
+
+#include "bdap/domainentry.h"
+#include "bdap/domainentrydb.h"
+#include "bdap/utils.h"
+#include "utiltime.h"
+#include "validationinterface.h"
+#ifdef ENABLE_WALLET
+#include "wallet/wallet.h"
+#endif
 
 #include <QDebug>
 #include <QList>
-#include <QTimer>
-#include <QTableWidget>
+
+#include <set>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/bind.hpp>
+
+bool CAccountFilter::Match(const CAccountStats& stats) const
+{
+    if (searchCommon.empty() && searchPath.empty())
+        return true;
+
+    return boost::algorithm::icontains(stats.commonName, searchCommon) && boost::algorithm::icontains(stats.objectFullPath, searchPath);
+}
+
+bool AccountLessThan::operator()(const CAccountStats& left, const CAccountStats& right) const
+{
+    const CAccountStats* pLeft = &left;
+    const CAccountStats* pRight = &right;
+
+    if (order == Qt::DescendingOrder)
+        std::swap(pLeft, pRight);
+
+    switch (column) {
+    case BdapAccountTableModel::CommonName:
+        return pLeft->commonName.compare(pRight->commonName) < 0;
+    case BdapAccountTableModel::ObjectFullPath:
+        return pLeft->objectFullPath.compare(pRight->objectFullPath) < 0;
+    case BdapAccountTableModel::ExpirationDate:
+        return pLeft->nExpireTime < pRight->nExpireTime;
+    }
+
+    return false;
+}
+
+static CAccountStats AccountStatsFromEntry(const CDomainEntry& entry)
+{
+    CAccountStats stats;
+    stats.commonName = stringFromVch(entry.CommonName);
+    stats.objectFullPath = entry.GetFullObjectPath();
+    stats.nExpireTime = entry.nExpireTime;
+    return stats;
+}
+
+static std::set<CharString> GetMyDHTPubKeys()
+{
+    std::set<CharString> setDHTPubKeys;
+#ifdef ENABLE_WALLET
+    std::vector<std::vector<unsigned char> > vvchDHTPubKeys;
+    if (pwalletMain && pwalletMain->GetDHTPubKeys(vvchDHTPubKeys))
+        setDHTPubKeys.insert(vvchDHTPubKeys.begin(), vvchDHTPubKeys.end());
+#endif
+    return setDHTPubKeys;
+}
+
+void BdapAccountTableWorker::fetchPage(quint64 nGeneration, const CAccountFilter& filter, const QString& afterPath)
+{
+    QList<CAccountStats> accounts;
+    if (!pDomainEntryDB) {
+        Q_EMIT pageFetched(nGeneration, accounts, afterPath, false);
+        return;
+    }
+
+    unsigned int nObjectType = GetObjectTypeInt(filter.accountType);
+    if (filter.fMyAccounts) {
+        // The wallet only holds a handful of accounts, return them all at once
+        for (const CharString& vchPubKey : GetMyDHTPubKeys()) {
+            CDomainEntry entry;
+            if (!pDomainEntryDB->ReadDomainEntryPubKey(vchPubKey, entry) || entry.nObjectType != nObjectType)
+                continue;
+            CAccountStats stats = AccountStatsFromEntry(entry);
+            if (filter.Match(stats))
+                accounts.append(stats);
+        }
+        Q_EMIT pageFetched(nGeneration, accounts, QString(), false);
+        return;
+    }
+
+    // Keep reading until a page of accounts passes the search filter or the directory ends
+    CharString vchAfterPath = vchFromString(afterPath.toStdString());
+    bool fMore = true;
+    while (fMore && accounts.size() < BDAP_ACCOUNT_PAGE_SIZE) {
+        std::vector<CDomainEntry> vEntries;
+        if (!pDomainEntryDB->ListDirectoriesAfter(CharString(), vchAfterPath, BDAP_ACCOUNT_PAGE_SIZE, vEntries, filter.accountType))
+            fMore = false;
+        else
+            fMore = vEntries.size() == (size_t)BDAP_ACCOUNT_PAGE_SIZE;
+
+        for (const CDomainEntry& entry : vEntries) {
+            CAccountStats stats = AccountStatsFromEntry(entry);
+            if (filter.Match(stats))
+                accounts.append(stats);
+        }
+        if (!vEntries.empty())
+            vchAfterPath = vEntries.back().vchFullObjectPath();
+    }
+    Q_EMIT pageFetched(nGeneration, accounts, QString::fromStdString(stringFromVch(vchAfterPath)), fMore);
+}
+
+void BdapAccountTableWorker::fetchAccount(quint64 nGeneration, const CAccountFilter& filter, const QString& path)
+{
+    CAccountStats stats;
+    CDomainEntry entry;
+    bool fFound = pDomainEntryDB && pDomainEntryDB->ReadDomainEntry(vchFromString(path.toStdString()), entry) &&
+                  entry.nObjectType == GetObjectTypeInt(filter.accountType);
+    if (fFound) {
+        stats = AccountStatsFromEntry(entry);
+        fFound = filter.Match(stats) && (!filter.fMyAccounts || GetMyDHTPubKeys().count(entry.DHTPublicKey));
+    }
+    Q_EMIT accountFetched(nGeneration, path, stats, fFound);
+}
 
 // private implementation
 class BdapAccountTablePriv
 {
 public:
-    /** Local cache of peer information */
+    /** Local cache of the accounts fetched so far */
     QList<CAccountStats> cachedAccountStats;
-    /** Column to sort nodes by */
+    /** Full paths of the cached accounts, so pages never duplicate rows inserted by updates */
+    std::set<std::string> setAccountPaths;
+    /** Column to sort accounts by */
     int sortColumn;
-    /** Order (ascending or descending) to sort nodes by */
+    /** Order (ascending or descending) to sort accounts by */
     Qt::SortOrder sortOrder;
-
-    /** Populate tableWidget_Users via RPC call */
-    void refreshAccounts(QTableWidget* inputtable, QLabel* statusDisplay, bool filterOn = false, std::string searchCommon = "", std::string searchPath = "")
+    /** Accounts shown by the model */
+    CAccountFilter filter;
+    /** Bumped on every reload so replies to outdated requests are dropped */
+    quint64 nGeneration;
+    /** Full path of the last account read from the database, the next page starts after it */
+    QString lastPath;
+    bool fMore;
+    bool fFetching;
+
+    void sortAccounts()
     {
+        if (sortColumn >= 0)
+            // use stable sort to prevent rows jumping around unnecessarily
+            qStableSort(cachedAccountStats.begin(), cachedAccountStats.end(), AccountLessThan(sortColumn, sortOrder));
+    }
 
-        JSONRPCRequest jreq;
-        std::vector<std::string> params;
-        int nNewRow = 0;
-        int recordsFound = 0;
-    
-        std::string keyName {""};
-        std::string getName {""};
-        std::string getPath {""};
-        std::string getExpirationDate {""};
-        std::string tableWidgetName {""};
-        std::string outputmessage = "";
-
-        bool hasValues = false;
-
-    
-        if (!inputtable->objectName().isEmpty()) tableWidgetName = inputtable->objectName().toStdString();
-
-        //check if table has been previously sorted
-        if (!inputtable->objectName().isEmpty()){
-            if (inputtable->rowCount() > 0) {
-                hasValues = true;
-                sortColumn = inputtable->horizontalHeader()->sortIndicatorSection();
-                sortOrder = inputtable->horizontalHeader()->sortIndicatorOrder();
-            } //if rowcount
-        } //if not isempty
-
-
-        //Execute proper RPC call 
-        if (tableWidgetName == "tableWidget_Groups") {
-            if (filterOn) {
-                params.push_back("groups");
-                jreq.params = RPCConvertValues("mybdapaccounts", params);
-                jreq.strMethod = "mybdapaccounts";
-            } else {
-                jreq.params = RPCConvertValues("getgroups", params);
-                jreq.strMethod = "getgroups";
-            } //(filterOn Groups)
-        } else { 
-            if (filterOn) {
-                params.push_back("users");
-                jreq.params = RPCConvertValues("mybdapaccounts", params);
-                jreq.strMethod = "mybdapaccounts";
-            } else {
-                jreq.params = RPCConvertValues("getusers", params);
-                jreq.strMethod = "getusers";
-            } //(filterOn Users)
-        }
-        
-        UniValue result = UniValue(UniValue::VOBJ);
-
-        //Handle RPC errors
-        try {
-            result = tableRPC.execute(jreq);
-        } catch (const UniValue& objError) {
-            std::string message = find_value(objError, "message").get_str();
-            outputmessage = message;
-            QMessageBox::critical(0, "BDAP Error", QString::fromStdString(outputmessage));
-            return;
-        } catch (const std::exception& e) {
-            outputmessage = e.what();
-            QMessageBox::critical(0, "BDAP Error", QString::fromStdString(outputmessage));
-            return;
-        }
-
-        inputtable->clearContents();
-        inputtable->setRowCount(0);
-        inputtable->setColumnCount(0);
-        inputtable->setSortingEnabled(true);
-        inputtable->setColumnCount(3);
-        inputtable->setColumnWidth(0, COMMONNAME_COLWIDTH); //Common Name (fixed)
-        inputtable->setColumnWidth(1, FULLPATH_COLWIDTH); //Object Full Path (fixed)
-        //inputtable->setColumnWidth(2, 175);
-
-        inputtable->setHorizontalHeaderItem(0, new QTableWidgetItem(QString::fromStdString("Common Name")));
-        inputtable->setHorizontalHeaderItem(1, new QTableWidgetItem(QString::fromStdString("Object Full Path")));
-        inputtable->setHorizontalHeaderItem(2, new QTableWidgetItem(QString::fromStdString("Expiration Date")));
-
-        //Parse results and populate QWidgetTable
-        for (size_t i {0} ; i < result.size() ; ++i) {
-            getName = "";
-            getPath = "";
-            getExpirationDate = "";
-
-
-            for (size_t j {0} ; j < result[i].size() ; ++j) {
-                keyName = "";
-                keyName = result[i].getKeys()[j];
-
-                // "common_name", "object_full_path"
-                if (keyName == "common_name") getName = result[i].getValues()[j].get_str();
-                if (keyName == "object_full_path") getPath = result[i].getValues()[j].get_str();
-                //if (keyName == "expires_on") getExpirationDate = std::to_string(result[i].getValues()[j].get_int64());
-                if (keyName == "expires_on") getExpirationDate = DateTimeStrFormat("%Y-%m-%d", result[i].getValues()[j].get_int64());
-
-            }
-
-            //add row if all criteria have been met
-            if ( ((searchCommon == "") && (searchPath == "")) || (((boost::algorithm::to_lower_copy(getName)).find(boost::algorithm::to_lower_copy(searchCommon)) != std::string::npos) && ((boost::algorithm::to_lower_copy(getPath)).find(boost::algorithm::to_lower_copy(searchPath)) != std::string::npos)) ) {
-                nNewRow = inputtable->rowCount();
-                inputtable->insertRow(nNewRow);
-                QTableWidgetItem* commonNameItem = new QTableWidgetItem(QString::fromStdString(getName));
-                QTableWidgetItem* fullPathItem = new QTableWidgetItem(QString::fromStdString(getPath));
-                QTableWidgetItem* expirationDateItem = new QTableWidgetItem(QString::fromStdString(getExpirationDate));
-                inputtable->setItem(nNewRow, 0, commonNameItem);
-                inputtable->setItem(nNewRow, 1, fullPathItem);
-                inputtable->setItem(nNewRow, 2, expirationDateItem);
-                recordsFound++;
-
-            } //if searchcommon
-
-
-        }; //for loop
-
-        //if we saved the previous state, apply to current results
-        if (hasValues) {
-            inputtable->horizontalHeader()->setSortIndicator(sortColumn, sortOrder);
+    int find(const std::string& path) const
+    {
+        for (int i = 0; i < cachedAccountStats.size(); i++) {
+            if (cachedAccountStats[i].objectFullPath == path)
+                return i;
         }
-
-        statusDisplay->setText(QString::fromStdString(("Records found: " + std::to_string(recordsFound))));
-
-    } //refreshAccounts
+        return -1;
+    }
 
     int size() const
     {
@@ -168,47 +179,58 @@ public:
 
         return 0;
     }
+};
 
-}; //BdapAccountTablePriv
-
-BdapAccountTableModel::BdapAccountTableModel(BdapPage* parent) : QAbstractTableModel(parent),
-                                                      bdapPage(parent),
-                                                      timer(0)
+BdapAccountTableModel::BdapAccountTableModel(BdapPage* parent, BDAP::ObjectType accountType) : QAbstractTableModel(parent)
 {
-    
-    currentIndex = bdapPage->getCurrentIndex();
-    userTable = bdapPage->getUserTable();
-    groupTable = bdapPage->getGroupTable();
-    userStatus = bdapPage->getUserStatus();
-    groupStatus = bdapPage->getGroupStatus();
-
-        
+    qRegisterMetaType<CAccountStats>("CAccountStats");
+    qRegisterMetaType<CAccountFilter>("CAccountFilter");
+    qRegisterMetaType<QList<CAccountStats> >("QList<CAccountStats>");
+
     columns << tr("Common Name") << tr("Object Full Path") << tr("Expiration Date");
     priv.reset(new BdapAccountTablePriv());
     // default to unsorted
     priv->sortColumn = -1;
-
-    //refresh();
-    timer = new QTimer(this);
-    connect(timer, SIGNAL(timeout()), SLOT(refresh()));
-    timer->setInterval(60000); //MODEL_UPDATE_DELAY originally
-    startAutoRefresh();
-
+    priv->sortOrder = Qt::AscendingOrder;
+    priv->filter.accountType = accountType;
+    priv->filter.fMyAccounts = false;
+    priv->nGeneration = 0;
+    priv->fMore = true;
+    priv->fFetching = false;
+
+    BdapAccountTableWorker* worker = new BdapAccountTableWorker();
+    worker->moveToThread(&thread);
+
+    // Requests from this object go to the worker, replies come back here
+    connect(this, SIGNAL(requestPage(quint64, CAccountFilter, QString)), worker, SLOT(fetchPage(quint64, CAccountFilter, QString)));
+    connect(this, SIGNAL(requestAccount(quint64, CAccountFilter, QString)), worker, SLOT(fetchAccount(quint64, CAccountFilter, QString)));
+    connect(worker, SIGNAL(pageFetched(quint64, QList<CAccountStats>, QString, bool)), this, SLOT(pageFetched(quint64, QList<CAccountStats>, QString, bool)));
+    connect(worker, SIGNAL(accountFetched(quint64, QString, CAccountStats, bool)), this, SLOT(accountFetched(quint64, QString, CAccountStats, bool)));
+    // Delete the worker in its own thread once the thread's event loop quits
+    connect(&thread, SIGNAL(finished()), worker, SLOT(deleteLater()));
+    thread.start();
+
+    subscribeToCoreSignals();
 }
 
 BdapAccountTableModel::~BdapAccountTableModel()
 {
-    // Intentionally left empty
+    unsubscribeFromCoreSignals();
+    thread.quit();
+    thread.wait();
 }
 
-void BdapAccountTableModel::startAutoRefresh()
+const CAccountStats* BdapAccountTableModel::getAccountStats(int idx) const
 {
-    timer->start();
+    return priv->index(idx);
 }
 
-void BdapAccountTableModel::stopAutoRefresh()
+void BdapAccountTableModel::setFilter(bool fMyAccounts, const std::string& searchCommon, const std::string& searchPath)
 {
-    timer->stop();
+    priv->filter.fMyAccounts = fMyAccounts;
+    priv->filter.searchCommon = searchCommon;
+    priv->filter.searchPath = searchPath;
+    refresh();
 }
 
 int BdapAccountTableModel::rowCount(const QModelIndex& parent) const
@@ -228,6 +250,20 @@ QVariant BdapAccountTableModel::data(const QModelIndex& index, int role) const
     if (!index.isValid())
         return QVariant();
 
+    const CAccountStats* rec = priv->index(index.row());
+    if (!rec)
+        return QVariant();
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case CommonName:
+            return QString::fromStdString(rec->commonName);
+        case ObjectFullPath:
+            return QString::fromStdString(rec->objectFullPath);
+        case ExpirationDate:
+            return QString::fromStdString(DateTimeStrFormat("%Y-%m-%d", rec->nExpireTime));
+        }
+    }
     return QVariant();
 }
 
@@ -260,37 +296,130 @@ QModelIndex BdapAccountTableModel::index(int row, int column, const QModelIndex&
     return QModelIndex();
 }
 
+bool BdapAccountTableModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && priv->fMore;
+}
+
+void BdapAccountTableModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid() || !priv->fMore || priv->fFetching)
+        return;
+
+    priv->fFetching = true;
+    Q_EMIT requestPage(priv->nGeneration, priv->filter, priv->lastPath);
+}
+
 void BdapAccountTableModel::refresh()
 {
-    refreshUsers();
-    refreshGroups();
+    beginResetModel();
+    priv->cachedAccountStats.clear();
+    priv->setAccountPaths.clear();
+    priv->nGeneration++;
+    priv->lastPath.clear();
+    priv->fMore = true;
+    priv->fFetching = false;
+    endResetModel();
+    Q_EMIT accountCountChanged(0);
+
+    fetchMore(QModelIndex());
 }
 
-void BdapAccountTableModel::refreshUsers()
+void BdapAccountTableModel::pageFetched(quint64 nGeneration, const QList<CAccountStats>& accounts, const QString& lastPath, bool fMore)
 {
-    myUsersChecked = bdapPage->getMyUserCheckBoxChecked();
-    searchUserCommon = bdapPage->getCommonUserSearch();
-    searchUserPath = bdapPage->getPathUserSearch();
+    if (nGeneration != priv->nGeneration)
+        return;
 
-    Q_EMIT layoutAboutToBeChanged();
-    priv->refreshAccounts(userTable,userStatus,myUsersChecked,searchUserCommon,searchUserPath);
-    Q_EMIT layoutChanged();
+    priv->fFetching = false;
+    priv->lastPath = lastPath;
+    priv->fMore = fMore;
+
+    QList<CAccountStats> newAccounts;
+    Q_FOREACH (const CAccountStats& stats, accounts) {
+        if (priv->setAccountPaths.insert(stats.objectFullPath).second)
+            newAccounts.append(stats);
+    }
+
+    if (!newAccounts.isEmpty()) {
+        beginInsertRows(QModelIndex(), priv->size(), priv->size() + newAccounts.size() - 1);
+        priv->cachedAccountStats.append(newAccounts);
+        endInsertRows();
+
+        if (priv->sortColumn >= 0) {
+            Q_EMIT layoutAboutToBeChanged();
+            priv->sortAccounts();
+            Q_EMIT layoutChanged();
+        }
+    }
+    Q_EMIT accountCountChanged(priv->size());
 }
 
-void BdapAccountTableModel::refreshGroups()
+void BdapAccountTableModel::updateAccount(const QString& path, const QString& action)
 {
-    myGroupsChecked = bdapPage->getMyGroupCheckBoxChecked();
-    searchGroupCommon = bdapPage->getCommonGroupSearch();
-    searchGroupPath = bdapPage->getPathGroupSearch();
+    if (action == "bdap_delete" || action == "bdap_revoke") {
+        accountFetched(priv->nGeneration, path, CAccountStats(), false);
+        return;
+    }
+    Q_EMIT requestAccount(priv->nGeneration, priv->filter, path);
+}
 
-    Q_EMIT layoutAboutToBeChanged();
-    priv->refreshAccounts(groupTable,groupStatus,myGroupsChecked,searchGroupCommon,searchGroupPath);
-    Q_EMIT layoutChanged();
+void BdapAccountTableModel::accountFetched(quint64 nGeneration, const QString& path, const CAccountStats& stats, bool fFound)
+{
+    if (nGeneration != priv->nGeneration)
+        return;
+
+    int row = priv->find(path.toStdString());
+    if (fFound && row >= 0) {
+        priv->cachedAccountStats[row] = stats;
+        Q_EMIT dataChanged(index(row, 0, QModelIndex()), index(row, columns.length() - 1, QModelIndex()));
+    } else if (fFound) {
+        beginInsertRows(QModelIndex(), priv->size(), priv->size());
+        priv->cachedAccountStats.append(stats);
+        priv->setAccountPaths.insert(stats.objectFullPath);
+        endInsertRows();
+    } else if (row >= 0) {
+        beginRemoveRows(QModelIndex(), row, row);
+        priv->cachedAccountStats.removeAt(row);
+        priv->setAccountPaths.erase(path.toStdString());
+        endRemoveRows();
+    } else {
+        return;
+    }
+
+    if (priv->sortColumn >= 0) {
+        Q_EMIT layoutAboutToBeChanged();
+        priv->sortAccounts();
+        Q_EMIT layoutChanged();
+    }
+    Q_EMIT accountCountChanged(priv->size());
 }
 
 void BdapAccountTableModel::sort(int column, Qt::SortOrder order)
 {
     priv->sortColumn = column;
     priv->sortOrder = order;
-    refresh();
+
+    Q_EMIT layoutAboutToBeChanged();
+    priv->sortAccounts();
+    Q_EMIT layoutChanged();
+}
+
+// Handlers for core signals
+static void NotifyBDAPEntry(BdapAccountTableModel* model, const CDomainEntry& entry, const std::string& strOperation)
+{
+    QMetaObject::invokeMethod(model, "updateAccount", Qt::QueuedConnection,
+        Q_ARG(QString, QString::fromStdString(entry.GetFullObjectPath())),
+        Q_ARG(QString, QString::fromStdString(strOperation)));
+}
+
+void BdapAccountTableModel::subscribeToCoreSignals()
+{
+    // Connect signals to model
+    GetMainSignals().NotifyBDAPEntry.connect(boost::bind(NotifyBDAPEntry, this, _1, _2));
+}
+
+void BdapAccountTableModel::unsubscribeFromCoreSignals()
+{
+    // Disconnect signals from model
+    GetMainSignals().NotifyBDAPEntry.disconnect(boost::bind(NotifyBDAPEntry, this, _1, _2));
 }
@@ -5,39 +5,89 @@
 #ifndef DYNAMIC_QT_BDAPACCOUNTTABLEMODEL_H
 #define DYNAMIC_QT_BDAPACCOUNTTABLEMODEL_H
 
+#include "bdap/bdap.h"
+
 #include <QAbstractTableModel>
+#include <QList>
+#include <QMetaType>
 #include <QStringList>
-#include <QTableWidget>
-#include <QLabel>
+#include <QThread>
 
 #include <memory>
+#include <string>
 
 class BdapPage;
 class BdapAccountTablePriv;
 
-QT_BEGIN_NAMESPACE
-class QTimer;
-QT_END_NAMESPACE
+/** Number of accounts fetched from the BDAP database per page */
+static const int BDAP_ACCOUNT_PAGE_SIZE = 200;
 
 struct CAccountStats {
-    unsigned int count;
+    std::string commonName;
+    std::string objectFullPath;
+    int64_t nExpireTime;
+};
+
+/** Filter applied to the accounts shown by a BdapAccountTableModel */
+struct CAccountFilter {
+    BDAP::ObjectType accountType;
+    bool fMyAccounts;
+    std::string searchCommon;
+    std::string searchPath;
+
+    bool Match(const CAccountStats& stats) const;
+};
+
+Q_DECLARE_METATYPE(CAccountStats)
+Q_DECLARE_METATYPE(CAccountFilter)
+Q_DECLARE_METATYPE(QList<CAccountStats>)
+
+class AccountLessThan
+{
+public:
+    AccountLessThan(int nColumn, Qt::SortOrder fOrder) : column(nColumn), order(fOrder) {}
+    bool operator()(const CAccountStats& left, const CAccountStats& right) const;
+
+private:
+    int column;
+    Qt::SortOrder order;
+};
+
+/**
+   Reads BDAP accounts from the BDAP database on the model's worker thread,
+   so that walking a large directory never blocks the GUI.
+ */
+class BdapAccountTableWorker : public QObject
+{
+    Q_OBJECT
+
+public Q_SLOTS:
+    /** Fetch the next page of accounts after the given full path (empty for the first page) */
+    void fetchPage(quint64 nGeneration, const CAccountFilter& filter, const QString& afterPath);
+    /** Re-read a single account after a BDAP update notification */
+    void fetchAccount(quint64 nGeneration, const CAccountFilter& filter, const QString& path);
+
+Q_SIGNALS:
+    void pageFetched(quint64 nGeneration, const QList<CAccountStats>& accounts, const QString& lastPath, bool fMore);
+    void accountFetched(quint64 nGeneration, const QString& path, const CAccountStats& stats, bool fFound);
 };
 
 /**
-   Qt model providing information about BDAP users and groups.
+   Qt model providing information about BDAP users or groups. Accounts are
+   fetched lazily page by page as the view scrolls, and single rows are
+   updated as BDAP entries are added, updated or deleted on chain.
  */
 class BdapAccountTableModel : public QAbstractTableModel
 {
     Q_OBJECT
 
 public:
-    explicit BdapAccountTableModel(BdapPage* parent = 0);
+    explicit BdapAccountTableModel(BdapPage* parent, BDAP::ObjectType accountType);
     ~BdapAccountTableModel();
 
-    void startAutoRefresh();
-    void stopAutoRefresh();
-    void refreshUsers();
-    void refreshGroups();
+    const CAccountStats* getAccountStats(int idx) const;
+    /** Apply a new "my accounts"/search filter and reload from the first page */
+    void setFilter(bool fMyAccounts, const std::string& searchCommon, const std::string& searchPath);
 
     enum ColumnIndex {
         CommonName = 0,
@@ -54,28 +104,33 @@ public:
     QModelIndex index(int row, int column, const QModelIndex& parent) const;
     Qt::ItemFlags flags(const QModelIndex& index) const;
     void sort(int column, Qt::SortOrder order);
+    bool canFetchMore(const QModelIndex& parent) const;
+    void fetchMore(const QModelIndex& parent);
     /*@}*/
 
 public Q_SLOTS:
     void refresh();
+    /** Called through the core NotifyBDAPEntry signal */
+    void updateAccount(const QString& path, const QString& action);
+
+Q_SIGNALS:
+    void accountCountChanged(int nCount);
+
+    // requests to the worker thread
+    void requestPage(quint64 nGeneration, const CAccountFilter& filter, const QString& afterPath);
+    void requestAccount(quint64 nGeneration, const CAccountFilter& filter, const QString& path);
+
+private Q_SLOTS:
+    void pageFetched(quint64 nGeneration, const QList<CAccountStats>& accounts, const QString& lastPath, bool fMore);
+    void accountFetched(quint64 nGeneration, const QString& path, const CAccountStats& stats, bool fFound);
 
 private:
-    BdapPage* bdapPage;
     QStringList columns;
     std::unique_ptr<BdapAccountTablePriv> priv;
-    QTimer* timer;
-    int currentIndex;
-    QTableWidget* userTable;
-    QTableWidget* groupTable;
-    QLabel* userStatus;
-    QLabel* groupStatus;
-    bool myUsersChecked;
-    bool myGroupsChecked;
-    std::string searchUserCommon;
-    std::string searchUserPath;
-    std::string searchGroupCommon;
-    std::string searchGroupPath;
-    
+    QThread thread;
+
+    void subscribeToCoreSignals();
+    void unsubscribeFromCoreSignals();
 };
 
-#endif // DYNAMIC_QT_BDAPACCOUNTTABLEMODEL_H
\ No newline at end of file
+#endif // DYNAMIC_QT_BDAPACCOUNTTABLEMODEL_H
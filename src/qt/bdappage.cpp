@@ -14,22 +14,30 @@
 #include "rpcregister.h"
 #include "rpcserver.h"
 #include "rpcclient.h"
+#include "utiltime.h"
 
 #include <stdio.h>
 
 #include <boost/algorithm/string.hpp>
 
-#include <QTableWidget>
+#include <QHeaderView>
+#include <QTableView>
 
 BdapPage::BdapPage(const PlatformStyle* platformStyle, QWidget* parent) : QWidget(parent),
                                                                             ui(new Ui::BdapPage),
-                                                                            bdapAccountTableModel(0)
+                                                                            bdapUserTableModel(0),
+                                                                            bdapGroupTableModel(0)
 {
     ui->setupUi(this);
     
     evaluateTransactionButtons();
 
-    bdapAccountTableModel = new BdapAccountTableModel(this);
+    bdapUserTableModel = new BdapAccountTableModel(this, BDAP::ObjectType::BDAP_USER);
+    bdapGroupTableModel = new BdapAccountTableModel(this, BDAP::ObjectType::BDAP_GROUP);
+    setupAccountTable(ui->tableView_Users, bdapUserTableModel);
+    setupAccountTable(ui->tableView_Groups, bdapGroupTableModel);
+    connect(bdapUserTableModel, SIGNAL(accountCountChanged(int)), this, SLOT(updateUserStatus(int)));
+    connect(bdapGroupTableModel, SIGNAL(accountCountChanged(int)), this, SLOT(updateGroupStatus(int)));
 
     ui->lineEditUserCommonNameSearch->setFixedWidth(COMMONNAME_COLWIDTH);
     ui->lineEditUserFullPathSearch->setFixedWidth(FULLPATH_COLWIDTH);
@@ -51,7 +59,7 @@ BdapPage::BdapPage(const PlatformStyle* platformStyle, QWidget* parent) : QWidge
     connect(ui->lineEditUserCommonNameSearch, SIGNAL(textChanged(const QString &)), this, SLOT(listAllUsers()));
     connect(ui->lineEditUserFullPathSearch, SIGNAL(textChanged(const QString &)), this, SLOT(listAllUsers()));
 
-    connect(ui->tableWidget_Users, SIGNAL(cellDoubleClicked(int,int)), this, SLOT(getUserDetails(int,int)));
+    connect(ui->tableView_Users, SIGNAL(doubleClicked(QModelIndex)), this, SLOT(getUserDetails(QModelIndex)));
 
 
     //Groups tab
@@ -65,7 +73,7 @@ BdapPage::BdapPage(const PlatformStyle* platformStyle, QWidget* parent) : QWidge
     connect(ui->lineEditGroupFullPathSearch, SIGNAL(textChanged(const QString &)), this, SLOT(listAllGroups()));
 
 
-    connect(ui->tableWidget_Groups, SIGNAL(cellDoubleClicked(int,int)), this, SLOT(getGroupDetails(int,int)));
+    connect(ui->tableView_Groups, SIGNAL(doubleClicked(QModelIndex)), this, SLOT(getGroupDetails(QModelIndex)));
 
 }
 
@@ -79,6 +87,25 @@ void BdapPage::setModel(WalletModel* model)
     this->model = model;
 }
 
+void BdapPage::setupAccountTable(QTableView* view, BdapAccountTableModel* tableModel)
+{
+    view->setModel(tableModel);
+    view->setSortingEnabled(true);
+    view->setColumnWidth(BdapAccountTableModel::CommonName, COMMONNAME_COLWIDTH);
+    view->setColumnWidth(BdapAccountTableModel::ObjectFullPath, FULLPATH_COLWIDTH);
+    // start unsorted, in database order
+    view->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+}
+
+const CAccountStats* BdapPage::getSelectedAccount(QTableView* view, BdapAccountTableModel* tableModel)
+{
+    QModelIndexList selected = view->selectionModel()->selectedRows();
+    if (selected.isEmpty())
+        return nullptr;
+
+    return tableModel->getAccountStats(selected.at(0).row());
+}
+
 void BdapPage::evaluateTransactionButtons()
 {
     int currentIndex = ui->tabWidget->currentIndex();
@@ -106,7 +133,7 @@ void BdapPage::listAllGroups()
 {
     evaluateTransactionButtons();
 
-    bdapAccountTableModel->refreshGroups();
+    bdapGroupTableModel->setFilter(getMyGroupCheckBoxChecked(), getCommonGroupSearch(), getPathGroupSearch());
 } //listAllGroups
 
 
@@ -124,13 +151,11 @@ void BdapPage::deleteGroup()
     std::string account = "";
     std::string displayedMessage = "";
 
-    QItemSelectionModel* selectionModel = ui->tableWidget_Groups->selectionModel();
-    QModelIndexList selected = selectionModel->selectedRows();
-    int nSelectedRow = selected.count() ? selected.at(0).row() : -1;
+    const CAccountStats* stats = getSelectedAccount(ui->tableView_Groups, bdapGroupTableModel);
 
-    if (nSelectedRow == -1) return; //do nothing if no rows are selected
+    if (!stats) return; //do nothing if no rows are selected
 
-    account = ui->tableWidget_Groups->item(nSelectedRow,1)->text().toStdString();
+    account = stats->objectFullPath;
     displayedMessage = "Are you sure you want to delete \"" + account + "\""; //std::to_string(nSelectedRow);
 
     reply = QMessageBox::question(this, "Confirm Delete Account", QString::fromStdString(displayedMessage), QMessageBox::Yes|QMessageBox::No);
@@ -147,15 +172,13 @@ void BdapPage::updateGroup()
     std::string commonName = "";
     std::string expirationDate = "";
     
-    QItemSelectionModel* selectionModel = ui->tableWidget_Groups->selectionModel();
-    QModelIndexList selected = selectionModel->selectedRows();
-    int nSelectedRow = selected.count() ? selected.at(0).row() : -1;
+    const CAccountStats* stats = getSelectedAccount(ui->tableView_Groups, bdapGroupTableModel);
 
-    if (nSelectedRow == -1) return; //do nothing if no rows are selected
+    if (!stats) return; //do nothing if no rows are selected
 
-    account = ui->tableWidget_Groups->item(nSelectedRow,1)->text().toStdString();
-    commonName = ui->tableWidget_Groups->item(nSelectedRow,0)->text().toStdString();
-    expirationDate = ui->tableWidget_Groups->item(nSelectedRow,2)->text().toStdString();
+    account = stats->objectFullPath;
+    commonName = stats->commonName;
+    expirationDate = DateTimeStrFormat("%Y-%m-%d", stats->nExpireTime);
 
     BdapUpdateAccountDialog dlg(this,BDAP::ObjectType::BDAP_GROUP,account,commonName,expirationDate);
     dlg.setWindowTitle(QString::fromStdString("Update BDAP Group"));
@@ -165,13 +188,21 @@ void BdapPage::updateGroup()
 } //updateGroup
 
 
-void BdapPage::getGroupDetails(int row, int column)
+void BdapPage::getGroupDetails(const QModelIndex& index)
 {
-    BdapUserDetailDialog dlg(this,BDAP::ObjectType::BDAP_GROUP,ui->tableWidget_Groups->item(row,1)->text().toStdString());
+    const CAccountStats* stats = bdapGroupTableModel->getAccountStats(index.row());
+    if (!stats) return;
+
+    BdapUserDetailDialog dlg(this,BDAP::ObjectType::BDAP_GROUP,stats->objectFullPath);
     dlg.setWindowTitle(QString::fromStdString("BDAP Group Detail"));
     dlg.exec();
 } //getGroupDetails
 
+void BdapPage::updateGroupStatus(int nCount)
+{
+    ui->labelGroupStatus->setText(QString::fromStdString(("Records found: " + std::to_string(nCount))));
+} //updateGroupStatus
+
 
 
 //Users tab =========================================================================
@@ -179,7 +210,7 @@ void BdapPage::listAllUsers()
 {
     evaluateTransactionButtons();
 
-    bdapAccountTableModel->refreshUsers();
+    bdapUserTableModel->setFilter(getMyUserCheckBoxChecked(), getCommonUserSearch(), getPathUserSearch());
 
 } //listAllUsers
 
@@ -193,13 +224,21 @@ void BdapPage::addUser()
 
 
 
-void BdapPage::getUserDetails(int row, int column)
+void BdapPage::getUserDetails(const QModelIndex& index)
 {
-    BdapUserDetailDialog dlg(this,BDAP::ObjectType::BDAP_USER,ui->tableWidget_Users->item(row,1)->text().toStdString());
+    const CAccountStats* stats = bdapUserTableModel->getAccountStats(index.row());
+    if (!stats) return;
+
+    BdapUserDetailDialog dlg(this,BDAP::ObjectType::BDAP_USER,stats->objectFullPath);
     dlg.setWindowTitle(QString::fromStdString("BDAP User Detail"));
     dlg.exec();
 } //getUserDetails
 
+void BdapPage::updateUserStatus(int nCount)
+{
+    ui->labelUserStatus->setText(QString::fromStdString(("Records found: " + std::to_string(nCount))));
+} //updateUserStatus
+
 
 
 void BdapPage::deleteUser()
@@ -208,13 +247,11 @@ void BdapPage::deleteUser()
     std::string account = "";
     std::string displayedMessage = "";
 
-    QItemSelectionModel* selectionModel = ui->tableWidget_Users->selectionModel();
-    QModelIndexList selected = selectionModel->selectedRows();
-    int nSelectedRow = selected.count() ? selected.at(0).row() : -1;
+    const CAccountStats* stats = getSelectedAccount(ui->tableView_Users, bdapUserTableModel);
 
-    if (nSelectedRow == -1) return; //do nothing if no rows are selected
+    if (!stats) return; //do nothing if no rows are selected
 
-    account = ui->tableWidget_Users->item(nSelectedRow,1)->text().toStdString();
+    account = stats->objectFullPath;
     displayedMessage = "Are you sure you want to delete \"" + account + "\""; //std::to_string(nSelectedRow);
 
     reply = QMessageBox::question(this, "Confirm Delete Account", QString::fromStdString(displayedMessage), QMessageBox::Yes|QMessageBox::No);
@@ -232,15 +269,13 @@ void BdapPage::updateUser()
     std::string commonName = "";
     std::string expirationDate = "";
     
-    QItemSelectionModel* selectionModel = ui->tableWidget_Users->selectionModel();
-    QModelIndexList selected = selectionModel->selectedRows();
-    int nSelectedRow = selected.count() ? selected.at(0).row() : -1;
+    const CAccountStats* stats = getSelectedAccount(ui->tableView_Users, bdapUserTableModel);
 
-    if (nSelectedRow == -1) return; //do nothing if no rows are selected
+    if (!stats) return; //do nothing if no rows are selected
 
-    account = ui->tableWidget_Users->item(nSelectedRow,1)->text().toStdString();
-    commonName = ui->tableWidget_Users->item(nSelectedRow,0)->text().toStdString();
-    expirationDate = ui->tableWidget_Users->item(nSelectedRow,2)->text().toStdString();
+    account = stats->objectFullPath;
+    commonName = stats->commonName;
+    expirationDate = DateTimeStrFormat("%Y-%m-%d", stats->nExpireTime);
 
     BdapUpdateAccountDialog dlg(this,BDAP::ObjectType::BDAP_USER,account,commonName,expirationDate);
     dlg.setWindowTitle(QString::fromStdString("Update BDAP User"));
@@ -308,31 +343,14 @@ void BdapPage::executeDeleteAccount(std::string account, BDAP::ObjectType accoun
 } //executeDeleteAccount
 
 
-BdapAccountTableModel* BdapPage::getBdapAccountTableModel()
-{
-    return bdapAccountTableModel;
-}
-
-
-QTableWidget* BdapPage::getUserTable() 
-{ 
-    return ui->tableWidget_Users; 
-}
-
-
-QTableWidget* BdapPage::getGroupTable() 
-{ 
-    return ui->tableWidget_Groups; 
-}
-
-QLabel* BdapPage::getUserStatus()
+BdapAccountTableModel* BdapPage::getUserTableModel()
 {
-    return ui->labelUserStatus;
+    return bdapUserTableModel;
 }
 
-QLabel* BdapPage::getGroupStatus()
+BdapAccountTableModel* BdapPage::getGroupTableModel()
 {
-    return ui->labelGroupStatus;
+    return bdapGroupTableModel;
 }
 
 
@@ -16,8 +16,9 @@
 
 
 class BdapAccountTableModel;
-class QTableWidget;
-class QLabel;
+struct CAccountStats;
+class QModelIndex;
+class QTableView;
 
 const int COMMONNAME_COLWIDTH = 450;
 const int FULLPATH_COLWIDTH = 350;
@@ -37,11 +38,8 @@ public:
     ~BdapPage();
 
     void setModel(WalletModel* model);
-    BdapAccountTableModel* getBdapAccountTableModel();
-    QTableWidget* getUserTable();
-    QTableWidget* getGroupTable();
-    QLabel* getUserStatus();
-    QLabel* getGroupStatus();
+    BdapAccountTableModel* getUserTableModel();
+    BdapAccountTableModel* getGroupTableModel();
     bool getMyUserCheckBoxChecked();
     bool getMyGroupCheckBoxChecked();
     int getCurrentIndex();
@@ -58,7 +56,10 @@ private:
     Ui::BdapPage* ui;
     WalletModel* model;
     std::unique_ptr<WalletModel::UnlockContext> unlockContext;
-    BdapAccountTableModel* bdapAccountTableModel;
+    BdapAccountTableModel* bdapUserTableModel;
+    BdapAccountTableModel* bdapGroupTableModel;
+    void setupAccountTable(QTableView* view, BdapAccountTableModel* tableModel);
+    const CAccountStats* getSelectedAccount(QTableView* view, BdapAccountTableModel* tableModel);
     void executeDeleteAccount(std::string account, BDAP::ObjectType accountType);
 
 
@@ -69,13 +70,15 @@ private Q_SLOTS:
     void addUser();
     void deleteUser();
     void updateUser();
-    void getUserDetails(int row, int column);
+    void getUserDetails(const QModelIndex& index);
+    void updateUserStatus(int nCount);
 
     void listAllGroups();
     void addGroup();
     void deleteGroup();
     void updateGroup();
-    void getGroupDetails(int row, int column);
+    void getGroupDetails(const QModelIndex& index);
+    void updateGroupStatus(int nCount);
 
 };
 
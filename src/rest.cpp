@@ -5,8 +5,14 @@
 // Distributed under the MIT/X11 software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "bdap/domainentry.h"
+#include "bdap/domainentrydb.h"
+#include "bdap/utils.h"
 #include "chain.h"
 #include "chainparams.h"
+#include "dht/mutable.h"
+#include "dht/mutabledb.h"
+#include "hash.h"
 #include "httpserver.h"
 #include "primitives/block.h"
 #include "primitives/transaction.h"
@@ -20,10 +26,15 @@
 
 #include <univalue.h>
 
+#include <libtorrent/hex.hpp> // for to_hex and from_hex
+#include <libtorrent/kademlia/item.hpp> // for item_target_id
+#include <libtorrent/kademlia/types.hpp>
+
 #include <boost/algorithm/string.hpp>
 #include <boost/dynamic_bitset.hpp>
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
+static const long MAX_REST_BDAP_USERS_PER_PAGE = 1000; //allow a max of 1000 BDAP accounts per page
 
 enum RetFormat {
     RF_UNDEF,
@@ -120,6 +131,35 @@ static bool ParseHashStr(const std::string& strReq, uint256& v)
     return true;
 }
 
+/**
+ * Sets the ETag header and, when the client already holds the same version
+ * (If-None-Match), answers with 304 Not Modified. Returns true if the request
+ * has been fully answered.
+ */
+static bool RESTNotModified(HTTPRequest* req, const std::string& strETag)
+{
+    req->WriteHeader("ETag", strETag);
+    std::pair<bool, std::string> ifNoneMatch = req->GetHeader("If-None-Match");
+    if (!ifNoneMatch.first)
+        return false;
+
+    std::vector<std::string> vTags;
+    boost::split(vTags, ifNoneMatch.second, boost::is_any_of(","));
+    for (std::string& strTag : vTags) {
+        boost::trim(strTag);
+        if (strTag == strETag || strTag == "*") {
+            req->WriteReply(HTTP_NOT_MODIFIED);
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::string DomainEntryETag(const CDomainEntry& entry)
+{
+    return strprintf("\"%s-%u\"", entry.txHash.GetHex(), entry.nHeight);
+}
+
 static bool CheckWarmup(HTTPRequest* req)
 {
     std::string statusmessage;
@@ -585,6 +625,224 @@ static bool rest_getutxos(HTTPRequest* req, const std::string& strURIPart)
     return true; // continue to process further HTTP reqs on this cxn
 }
 
+static bool rest_bdap_entry(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string strFullObjectPath;
+    const RetFormat rf = ParseDataFormat(strFullObjectPath, strURIPart);
+
+    CharString vchFullObjectPath = vchFromString(strFullObjectPath);
+    ToLowerCase(vchFullObjectPath);
+    if (vchFullObjectPath.empty() || vchFullObjectPath.size() > MAX_OBJECT_FULL_PATH_LENGTH)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid BDAP object path: " + strFullObjectPath);
+
+    if (!CheckDomainEntryDB())
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "BDAP database not available");
+
+    CDomainEntry entry;
+    {
+        LOCK(cs_main);
+        if (!GetDomainEntry(vchFullObjectPath, entry))
+            return RESTERR(req, HTTP_NOT_FOUND, strFullObjectPath + " not found");
+    }
+
+    if (rf == RF_UNDEF)
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+
+    if (RESTNotModified(req, DomainEntryETag(entry)))
+        return true;
+
+    CDataStream ssEntry(SER_NETWORK, PROTOCOL_VERSION);
+    ssEntry << entry;
+
+    switch (rf) {
+    case RF_BINARY: {
+        std::string binaryEntry = ssEntry.str();
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, binaryEntry);
+        return true;
+    }
+
+    case RF_HEX: {
+        std::string strHex = HexStr(ssEntry.begin(), ssEntry.end()) + "\n";
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, strHex);
+        return true;
+    }
+
+    case RF_JSON: {
+        UniValue oEntry(UniValue::VOBJ);
+        BuildBDAPJson(entry, oEntry, false);
+        std::string strJSON = oEntry.write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+
+    // not reached
+    return true; // continue to process further HTTP reqs on this cxn
+}
+
+static bool rest_bdap_users(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    if (rf == RF_UNDEF)
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+
+    std::vector<std::string> path;
+    boost::split(path, param, boost::is_any_of("/"));
+
+    if (path.size() != 2)
+        return RESTERR(req, HTTP_BAD_REQUEST, "No page specified. Use /rest/bdap/users/<count>/<page>.<ext>.");
+
+    int64_t nRecordsPerPage;
+    if (!ParseInt64(path[0], &nRecordsPerPage) || nRecordsPerPage < 1 || nRecordsPerPage > MAX_REST_BDAP_USERS_PER_PAGE)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Record count out of range: " + path[0]);
+
+    int64_t nPage;
+    if (!ParseInt64(path[1], &nPage) || nPage < 1)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Page out of range: " + path[1]);
+
+    if (!CheckDomainEntryDB())
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "BDAP database not available");
+
+    // only return entries from the default public domain OU, like getusers
+    std::string strObjectLocation = DEFAULT_PUBLIC_OU + "." + DEFAULT_PUBLIC_DOMAIN;
+    CharString vchObjectLocation(strObjectLocation.begin(), strObjectLocation.end());
+
+    std::vector<CDomainEntry> vEntries;
+    if (!pDomainEntryDB->ListDirectories(vchObjectLocation, nRecordsPerPage, nPage, vEntries, BDAP::ObjectType::BDAP_USER))
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Error reading BDAP database");
+
+    // The page changes whenever any entry on it is replaced by a newer transaction
+    CHashWriter ssETag(SER_GETHASH, 0);
+    ssETag << nRecordsPerPage << nPage;
+    for (const CDomainEntry& entry : vEntries)
+        ssETag << entry.txHash << entry.nHeight;
+    if (RESTNotModified(req, "\"" + ssETag.GetHash().GetHex() + "\""))
+        return true;
+
+    CDataStream ssEntries(SER_NETWORK, PROTOCOL_VERSION);
+    ssEntries << vEntries;
+
+    switch (rf) {
+    case RF_BINARY: {
+        std::string binaryEntries = ssEntries.str();
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, binaryEntries);
+        return true;
+    }
+
+    case RF_HEX: {
+        std::string strHex = HexStr(ssEntries.begin(), ssEntries.end()) + "\n";
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, strHex);
+        return true;
+    }
+
+    case RF_JSON: {
+        UniValue oEntries(UniValue::VARR);
+        for (const CDomainEntry& entry : vEntries) {
+            UniValue oEntry(UniValue::VOBJ);
+            BuildBDAPJson(entry, oEntry, false);
+            oEntries.push_back(oEntry);
+        }
+        std::string strJSON = oEntries.write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+
+    // not reached
+    return true; // continue to process further HTTP reqs on this cxn
+}
+
+static bool rest_dht_mutable(HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RetFormat rf = ParseDataFormat(param, strURIPart);
+    std::vector<std::string> path;
+    boost::split(path, param, boost::is_any_of("/"));
+
+    if (path.size() != 2)
+        return RESTERR(req, HTTP_BAD_REQUEST, "No salt specified. Use /rest/dht/<pubkey>/<salt>.<ext>.");
+
+    const std::string& strPubKey = path[0];
+    const std::string& strSalt = path[1];
+    if (!IsHex(strPubKey) || strPubKey.size() != 64)
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid DHT public key: " + strPubKey);
+
+    if (rf == RF_UNDEF)
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+
+    // Only serve what this node already stores; never block an HTTP worker on a DHT lookup.
+    libtorrent::dht::public_key pk;
+    libtorrent::aux::from_hex(strPubKey, pk.bytes.data());
+    const libtorrent::sha1_hash infoHash = libtorrent::dht::item_target_id(strSalt, pk);
+    CMutableData mutableData;
+    if (!GetLocalMutableData(vchFromString(libtorrent::aux::to_hex(infoHash.to_string())), mutableData))
+        return RESTERR(req, HTTP_NOT_FOUND, strPubKey + "/" + strSalt + " not found");
+
+    if (RESTNotModified(req, strprintf("\"%s-%d\"", mutableData.InfoHash(), mutableData.SequenceNumber)))
+        return true;
+
+    CDataStream ssData(SER_NETWORK, PROTOCOL_VERSION);
+    ssData << mutableData;
+
+    switch (rf) {
+    case RF_BINARY: {
+        std::string binaryData = ssData.str();
+        req->WriteHeader("Content-Type", "application/octet-stream");
+        req->WriteReply(HTTP_OK, binaryData);
+        return true;
+    }
+
+    case RF_HEX: {
+        std::string strHex = HexStr(ssData.begin(), ssData.end()) + "\n";
+        req->WriteHeader("Content-Type", "text/plain");
+        req->WriteReply(HTTP_OK, strHex);
+        return true;
+    }
+
+    case RF_JSON: {
+        UniValue oMutableData(UniValue::VOBJ);
+        oMutableData.push_back(Pair("info_hash", mutableData.InfoHash()));
+        oMutableData.push_back(Pair("public_key", mutableData.PublicKey()));
+        oMutableData.push_back(Pair("signature", mutableData.Signature()));
+        oMutableData.push_back(Pair("seq_num", mutableData.SequenceNumber));
+        oMutableData.push_back(Pair("salt", mutableData.Salt()));
+        oMutableData.push_back(Pair("value", mutableData.Value()));
+        std::string strJSON = oMutableData.write() + "\n";
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, strJSON);
+        return true;
+    }
+
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
+    }
+    }
+
+    // not reached
+    return true; // continue to process further HTTP reqs on this cxn
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(HTTPRequest* req, const std::string& strReq);
@@ -597,6 +855,9 @@ static const struct {
     {"/rest/mempool/contents", rest_mempool_contents},
     {"/rest/headers/", rest_headers},
     {"/rest/getutxos", rest_getutxos},
+    {"/rest/bdap/entry/", rest_bdap_entry},
+    {"/rest/bdap/users/", rest_bdap_users},
+    {"/rest/dht/", rest_dht_mutable},
 };
 
 bool StartREST()
@@ -391,6 +391,37 @@ UniValue getgpuhashespersec(const JSONRPCRequest& request)
     return GetGPUHashRate();
 }
 
+UniValue getminerstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getminerstats\n"
+            "\nReturns hash rate and block template statistics of the internal miner, in total and per miner thread.\n"
+            "Hash rates are averaged over the last minute. Counters cover all threads since the miner was started.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"hashespersec\": n         (numeric) The recent hashes per second of all threads\n"
+            "  \"hashes\": n               (numeric) The number of hashes done\n"
+            "  \"templates\": n            (numeric) The number of block templates mined on until they were replaced\n"
+            "  \"staletemplates\": n       (numeric) The number of those templates replaced because the chain tip changed\n"
+            "  \"blocksaccepted\": n       (numeric) The number of found blocks that were accepted\n"
+            "  \"blocksrejected\": n       (numeric) The number of found blocks that were rejected (e.g. stale)\n"
+            "  \"refreshlatencyavg\": n    (numeric) Average milliseconds a miner kept working on a replaced template\n"
+            "  \"refreshlatencymax\": n    (numeric) Maximum milliseconds a miner kept working on a replaced template\n"
+            "  \"threads\": [              (array) The same statistics for every running miner thread\n"
+            "    {\n"
+            "      \"device\": \"xxxx\",     (string) The miner device, like CPU#0 or GPU#1\n"
+            "      \"thread\": n,            (numeric) The thread number within the CPU or GPU miners\n"
+            "      ...\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getminerstats", "") + HelpExampleRpc("getminerstats", ""));
+
+    return GetMinerStats();
+}
+
 UniValue getmininginfo(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() != 0)
@@ -1108,6 +1139,7 @@ static const CRPCCommand commands[] =
         {"generating", "gethashespersec", &gethashespersec, true, {}},
         {"generating", "getcpuhashespersec", &getcpuhashespersec, true, {}},
         {"generating", "getgpuhashespersec", &getgpuhashespersec, true, {}},
+        {"generating", "getminerstats", &getminerstats, true, {}},
 
         {"util", "estimatefee", &estimatefee, true, {"nblocks"}},
         {"util", "estimatepriority", &estimatepriority, true, {"nblocks"}},
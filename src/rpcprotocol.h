@@ -20,6 +20,7 @@
 //! HTTP status codes
 enum HTTPStatusCode {
     HTTP_OK = 200,
+    HTTP_NOT_MODIFIED = 304,
     HTTP_BAD_REQUEST = 400,
     HTTP_UNAUTHORIZED = 401,
     HTTP_FORBIDDEN = 403,
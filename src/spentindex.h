@@ -417,5 +417,48 @@ struct CAddressIndexIteratorHeightKey {
         blockHeight = 0;
     }
 };
+struct CAddressBalanceValue {
+    CAmount balance;
+    CAmount received;
+    int64_t txCount;
+    int lastHeight;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(balance);
+        READWRITE(received);
+        READWRITE(txCount);
+        READWRITE(lastHeight);
+    }
+
+    CAddressBalanceValue(CAmount nBalance, CAmount nReceived, int64_t nTxCount, int height)
+    {
+        balance = nBalance;
+        received = nReceived;
+        txCount = nTxCount;
+        lastHeight = height;
+    }
+
+    CAddressBalanceValue()
+    {
+        SetNull();
+    }
+
+    void SetNull()
+    {
+        balance = 0;
+        received = 0;
+        txCount = 0;
+        lastHeight = 0;
+    }
+
+    bool IsNull() const
+    {
+        return (txCount == 0);
+    }
+};
 
 #endif // DYNAMIC_SPENTINDEX_H
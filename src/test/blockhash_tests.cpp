@@ -0,0 +1,82 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chainparams.h"
+#include "consensus/validation.h"
+#include "miner/miner.h"
+#include "pow.h"
+#include "primitives/block.h"
+#include "script/standard.h"
+#include "streams.h"
+#include "validation.h"
+
+#include "test/test_dynamic.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockhash_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(blockhash_memoized)
+{
+    CBlockHeader header;
+    header.nVersion = 4;
+    header.nTime = 1500000000;
+    header.nBits = 0x207fffff;
+
+    uint64_t nStart = CBlockHeader::GetHashComputationCount();
+    uint256 hash = header.GetHash();
+    BOOST_CHECK(header.GetHash() == hash);
+    BOOST_CHECK_EQUAL(CBlockHeader::GetHashComputationCount() - nStart, 1U);
+
+    // Copies carry the cached hash along
+    CBlock block(header);
+    CBlockHeader header2 = block.GetBlockHeader();
+    BOOST_CHECK(block.GetHash() == hash);
+    BOOST_CHECK(header2.GetHash() == hash);
+    BOOST_CHECK_EQUAL(CBlockHeader::GetHashComputationCount() - nStart, 1U);
+
+    // Writing any hashed field invalidates the cache
+    header.nNonce++;
+    uint256 hashNonce = header.GetHash();
+    BOOST_CHECK(hashNonce != hash);
+    BOOST_CHECK_EQUAL(CBlockHeader::GetHashComputationCount() - nStart, 2U);
+    header.nNonce--;
+    BOOST_CHECK(header.GetHash() == hash);
+    BOOST_CHECK_EQUAL(CBlockHeader::GetHashComputationCount() - nStart, 3U);
+
+    // Deserializing over a cached header must not return the stale hash
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    CBlockHeader header3 = header;
+    header3.nNonce++;
+    ss << header3;
+    ss >> header;
+    BOOST_CHECK(header.GetHash() == hashNonce);
+}
+
+BOOST_FIXTURE_TEST_CASE(blockhash_computed_once_per_accepted_block, TestChain100Setup)
+{
+    const CChainParams& chainparams = Params();
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+    std::unique_ptr<CBlockTemplate> pblocktemplate = CreateNewBlock(chainparams, scriptPubKey);
+    CBlock& block = pblocktemplate->block;
+    block.vtx.resize(1);
+    unsigned int extraNonce = 0;
+    IncrementExtraNonce(block, chainActive.Tip(), extraNonce);
+    while (!CheckProofOfWork(block.GetHash(), block.nBits, chainparams.GetConsensus()))
+        ++block.nNonce;
+
+    // Round-trip through the wire format so the block arrives without a cached hash
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << block;
+    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+    ss >> *pblock;
+
+    uint64_t nStart = CBlockHeader::GetHashComputationCount();
+    BOOST_CHECK(ProcessNewBlock(chainparams, pblock, true, NULL));
+    BOOST_CHECK(chainActive.Tip()->GetBlockHash() == block.GetHash());
+    BOOST_CHECK_EQUAL(CBlockHeader::GetHashComputationCount() - nStart, 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,67 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dht/eventstore.h"
+
+#include "test/test_dynamic.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(dht_eventstore_tests, BasicTestingSetup)
+
+static uint160 InfoHash(unsigned char n)
+{
+    uint160 hash;
+    *hash.begin() = n;
+    return hash;
+}
+
+BOOST_AUTO_TEST_CASE(dht_eventstore_test)
+{
+    CDHTEventStore<uint160, int> store(3);
+    BOOST_CHECK(store.Find(InfoHash(1)) == nullptr);
+
+    store.Add(InfoHash(1), 10, 100);
+    store.Add(InfoHash(2), 20, 200);
+    BOOST_CHECK_EQUAL(store.size(), 2U);
+    BOOST_REQUIRE(store.Find(InfoHash(1)) != nullptr);
+    BOOST_CHECK_EQUAL(*store.Find(InfoHash(1)), 10);
+
+    // The latest event of a key replaces the previous one and moves to the back
+    store.Add(InfoHash(1), 11, 300);
+    BOOST_CHECK_EQUAL(store.size(), 2U);
+    BOOST_CHECK_EQUAL(*store.Find(InfoHash(1)), 11);
+    std::vector<int> vEvents;
+    store.GetAll(vEvents);
+    BOOST_REQUIRE_EQUAL(vEvents.size(), 2U);
+    BOOST_CHECK_EQUAL(vEvents[0], 20);
+    BOOST_CHECK_EQUAL(vEvents[1], 11);
+
+    // Dropping the replaced queue entry makes room without dropping an event
+    store.Add(InfoHash(3), 30, 400);
+    BOOST_CHECK_EQUAL(store.size(), 3U);
+    BOOST_CHECK_EQUAL(*store.Find(InfoHash(1)), 11);
+
+    // Full, the oldest events go first
+    store.Add(InfoHash(4), 40, 500);
+    BOOST_CHECK_EQUAL(store.size(), 3U);
+    BOOST_CHECK(store.Find(InfoHash(2)) == nullptr);
+    store.Add(InfoHash(5), 50, 600);
+    BOOST_CHECK_EQUAL(store.size(), 3U);
+    BOOST_CHECK(store.Find(InfoHash(1)) == nullptr);
+    BOOST_CHECK_EQUAL(*store.Find(InfoHash(3)), 30);
+
+    // Expiry drops events added before the given time
+    store.Expire(500);
+    BOOST_CHECK_EQUAL(store.size(), 2U);
+    BOOST_CHECK(store.Find(InfoHash(3)) == nullptr);
+    BOOST_CHECK_EQUAL(*store.Find(InfoHash(4)), 40);
+    store.Expire(1000);
+    BOOST_CHECK_EQUAL(store.size(), 0U);
+    vEvents.clear();
+    store.GetAll(vEvents);
+    BOOST_CHECK(vEvents.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+// Copyright (c) 2016-2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "arith_uint256.h"
+#include "dynodeman.h"
+#include "netbase.h"
+#include "streams.h"
+#include "version.h"
+
+#include "test/test_dynamic.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(dynodeman_tests, BasicTestingSetup)
+
+static CDynodeBroadcast MakeDynodeBroadcast(int n, int64_t nPingTime)
+{
+    CDynodeBroadcast dnb(LookupNumeric(strprintf("1.2.3.%d", n).c_str(), 33300), COutPoint(ArithToUint256(arith_uint256(n)), 0), CPubKey(), CPubKey(), PROTOCOL_VERSION);
+    dnb.sigTime = 1000 + n;
+    dnb.lastPing = CDynodePing(dnb.outpoint);
+    dnb.lastPing.sigTime = nPingTime;
+    return dnb;
+}
+
+static CDynodeMan::dnlist_entries_t MakeDnList(const std::vector<CDynodeBroadcast>& vecDnb)
+{
+    CDynodeMan::dnlist_entries_t mapEntries;
+    for (const auto& dnb : vecDnb) {
+        mapEntries[dnb.outpoint] = CDynodeMan::GetDnListEntryHash(dnb);
+    }
+    return mapEntries;
+}
+
+// Build the "dnlist" message SyncList would send, push it through the wire
+// format and apply it the way ProcessListDiff does.
+static CDynodeMan::dnlist_entries_t SendAndApply(const CDynodeMan::dnlist_entries_t& mapBase, const std::vector<CDynodeBroadcast>& vecDnb, CDynodeListDiff& diffRet)
+{
+    CDynodeMan::dnlist_entries_t mapEntries = MakeDnList(vecDnb);
+    std::vector<COutPoint> vecUpdated;
+    CDynodeListDiff diff;
+    CDynodeMan::GetDnListDiff(mapBase, mapEntries, vecUpdated, diff.vecRemoved);
+    diff.hashList = CDynodeMan::GetDnListHash(mapEntries);
+    for (const auto& dnb : vecDnb) {
+        if (std::find(vecUpdated.begin(), vecUpdated.end(), dnb.outpoint) != vecUpdated.end())
+            diff.vecUpdated.push_back(dnb);
+    }
+
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << diff;
+    ss >> diffRet;
+
+    CDynodeMan::dnlist_entries_t mapUpdated;
+    for (const auto& dnb : diffRet.vecUpdated) {
+        mapUpdated[dnb.outpoint] = CDynodeMan::GetDnListEntryHash(dnb);
+    }
+    CDynodeMan::dnlist_entries_t mapResult = mapBase;
+    CDynodeMan::ApplyDnListDiff(mapResult, mapUpdated, diffRet.vecRemoved);
+    return mapResult;
+}
+
+BOOST_AUTO_TEST_CASE(dnlist_snapshot_roundtrip)
+{
+    std::vector<CDynodeBroadcast> vecDnb;
+    for (int i = 1; i <= 10; i++) {
+        vecDnb.push_back(MakeDynodeBroadcast(i, 5000));
+    }
+
+    // a full snapshot is a diff against an empty list
+    CDynodeListDiff diff;
+    CDynodeMan::dnlist_entries_t mapList = SendAndApply(CDynodeMan::dnlist_entries_t(), vecDnb, diff);
+    BOOST_CHECK_EQUAL(diff.vecUpdated.size(), 10U);
+    BOOST_CHECK(diff.vecRemoved.empty());
+    BOOST_CHECK(mapList == MakeDnList(vecDnb));
+    BOOST_CHECK(CDynodeMan::GetDnListHash(mapList) == diff.hashList);
+
+    // the list hash does not depend on the order the entries were seen in
+    std::vector<CDynodeBroadcast> vecReversed(vecDnb.rbegin(), vecDnb.rend());
+    BOOST_CHECK(CDynodeMan::GetDnListHash(MakeDnList(vecReversed)) == diff.hashList);
+
+    // a snapshot against itself is empty and keeps the hash
+    CDynodeListDiff diffSame;
+    BOOST_CHECK(SendAndApply(mapList, vecDnb, diffSame) == mapList);
+    BOOST_CHECK(diffSame.vecUpdated.empty());
+    BOOST_CHECK(diffSame.vecRemoved.empty());
+    BOOST_CHECK(diffSame.hashList == diff.hashList);
+}
+
+BOOST_AUTO_TEST_CASE(dnlist_diff_roundtrip)
+{
+    std::vector<CDynodeBroadcast> vecDnb;
+    for (int i = 1; i <= 10; i++) {
+        vecDnb.push_back(MakeDynodeBroadcast(i, 5000));
+    }
+    CDynodeMan::dnlist_entries_t mapBase = MakeDnList(vecDnb);
+    uint256 hashBase = CDynodeMan::GetDnListHash(mapBase);
+
+    // a newer ping changes the entry hash even though CDynodeBroadcast::GetHash() does not cover it
+    CDynodeBroadcast dnbPinged = vecDnb[2];
+    dnbPinged.lastPing.sigTime = 6000;
+    BOOST_CHECK(dnbPinged.GetHash() == vecDnb[2].GetHash());
+    BOOST_CHECK(CDynodeMan::GetDnListEntryHash(dnbPinged) != CDynodeMan::GetDnListEntryHash(vecDnb[2]));
+
+    // one entry pinged, one dropped, one new
+    std::vector<CDynodeBroadcast> vecNext = vecDnb;
+    vecNext[2] = dnbPinged;
+    COutPoint outpointRemoved = vecNext[5].outpoint;
+    vecNext.erase(vecNext.begin() + 5);
+    vecNext.push_back(MakeDynodeBroadcast(11, 5000));
+
+    CDynodeListDiff diff;
+    CDynodeMan::dnlist_entries_t mapNext = SendAndApply(mapBase, vecNext, diff);
+    BOOST_CHECK_EQUAL(diff.vecUpdated.size(), 2U);
+    BOOST_CHECK(diff.vecUpdated[0].outpoint == dnbPinged.outpoint);
+    BOOST_CHECK(diff.vecUpdated[1].outpoint == vecNext.back().outpoint);
+    BOOST_CHECK_EQUAL(diff.vecRemoved.size(), 1U);
+    BOOST_CHECK(diff.vecRemoved[0] == outpointRemoved);
+
+    BOOST_CHECK(mapNext == MakeDnList(vecNext));
+    BOOST_CHECK(CDynodeMan::GetDnListHash(mapNext) == diff.hashList);
+    BOOST_CHECK(diff.hashList != hashBase);
+
+    // a diff applied to the wrong base does not reproduce the list hash
+    CDynodeMan::dnlist_entries_t mapWrongBase = mapBase;
+    mapWrongBase.erase(vecDnb[0].outpoint);
+    CDynodeMan::dnlist_entries_t mapUpdated;
+    for (const auto& dnb : diff.vecUpdated) {
+        mapUpdated[dnb.outpoint] = CDynodeMan::GetDnListEntryHash(dnb);
+    }
+    CDynodeMan::ApplyDnListDiff(mapWrongBase, mapUpdated, diff.vecRemoved);
+    BOOST_CHECK(CDynodeMan::GetDnListHash(mapWrongBase) != diff.hashList);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+// Copyright (c) 2019 Duality Blockchain Solutions Developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "core_io.h"
+#include "fluid/fluid.h"
+#include "fluid/fluidinstruction.h"
+#include "hash.h"
+#include "key.h"
+#include "utilstrencodings.h"
+#include "validation.h"
+
+#include "test/test_dynamic.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(fluid_tests, BasicTestingSetup)
+
+static std::string SignFluidMessage(const CKey& key, const std::string& strMessage)
+{
+    CHashWriter ss(SER_GETHASH, 0);
+    ss << strMessageMagic;
+    ss << strMessage;
+    std::vector<unsigned char> vchSig;
+    BOOST_CHECK(key.SignCompact(ss.GetHash(), vchSig));
+    return EncodeBase64(&vchSig[0], vchSig.size());
+}
+
+BOOST_AUTO_TEST_CASE(fluid_instruction_decode)
+{
+    std::string strMessage = "1000.00000000$1547678461$DHr6bNtg2YtSH6RL4oyLSLkVmCqYBDwXrb";
+    std::vector<CKey> vKeys(3);
+    std::string strToken = strMessage;
+    for (CKey& key : vKeys) {
+        key.MakeNewKey(true);
+        strToken += "@" + SignFluidMessage(key, strMessage);
+    }
+    CScript script = CScript() << OP_MINT << std::vector<unsigned char>(strToken.begin(), strToken.end());
+
+    CFluidInstructionRef instruction = GetFluidInstruction(script);
+    BOOST_CHECK_EQUAL(instruction->strMessage, strMessage);
+    BOOST_CHECK_EQUAL(instruction->vMessageFields.size(), 3U);
+    BOOST_CHECK(instruction->fAmount);
+    BOOST_CHECK_EQUAL(instruction->nAmount, 1000 * COIN);
+    BOOST_CHECK(instruction->fTimeStamp);
+    BOOST_CHECK_EQUAL(instruction->nTimeStamp, 1547678461);
+    BOOST_CHECK_EQUAL(instruction->GetDestination(), "DHr6bNtg2YtSH6RL4oyLSLkVmCqYBDwXrb");
+    BOOST_CHECK_EQUAL(instruction->vSignatures.size(), 3U);
+    BOOST_REQUIRE_EQUAL(instruction->vSigners.size(), 3U);
+    std::vector<std::string> vSovereigns;
+    for (size_t i = 0; i < vKeys.size(); i++) {
+        BOOST_CHECK(instruction->vSigners[i] == CDynamicAddress(vKeys[i].GetPubKey().GetID()));
+        vSovereigns.push_back(CDynamicAddress(vKeys[i].GetPubKey().GetID()).ToString());
+    }
+
+    // Decoded once, the script and its assembly share the cached instruction
+    BOOST_CHECK(GetFluidInstruction(script) == instruction);
+    BOOST_CHECK(GetFluidInstruction(ScriptToAsmStr(script)) == instruction);
+
+    BOOST_CHECK(instruction->CheckQuorum(vSovereigns));
+    BOOST_CHECK(instruction->CheckTimestamp(1547678461 + CFluidParameters::MAX_FLUID_TIME_DISTORT));
+    BOOST_CHECK(!instruction->CheckTimestamp(1547678461 + CFluidParameters::MAX_FLUID_TIME_DISTORT + 1));
+
+    // Two sovereign signatures are not a quorum
+    vSovereigns.pop_back();
+    BOOST_CHECK(!instruction->CheckQuorum(vSovereigns));
+    BOOST_CHECK(instruction->CheckQuorum(vSovereigns, true));
+
+    // A script without operand decodes to a null instruction
+    BOOST_CHECK(GetFluidInstruction(CScript() << OP_MINT)->IsNull());
+}
+
+BOOST_AUTO_TEST_CASE(fluid_instruction_scrubbed_amount)
+{
+    // CheckFluidOperationScript parses the amount field as it is, the override
+    // and mint lookups parse it without spaces
+    std::string strToken = "2 000 000 000.00000000$1547678461$DHr6bNtg2YtSH6RL4oyLSLkVmCqYBDwXrb@sig";
+    CScript script = CScript() << OP_MINT << std::vector<unsigned char>(strToken.begin(), strToken.end());
+    CFluidInstructionRef instruction = GetFluidInstruction(script);
+    BOOST_CHECK(!instruction->fAmount);
+    BOOST_CHECK(instruction->fScrubbedAmount);
+    BOOST_CHECK_EQUAL(instruction->nScrubbedAmount, 2000000000 * COIN);
+    BOOST_CHECK(instruction->fTimeStamp && instruction->fScrubbedTimeStamp);
+
+    std::string strError;
+    BOOST_CHECK(fluid.CheckFluidOperationScript(script, 1547678461, strError, true));
+
+    strToken = "2000000000.00000000$1547678461$DHr6bNtg2YtSH6RL4oyLSLkVmCqYBDwXrb@sig";
+    script = CScript() << OP_MINT << std::vector<unsigned char>(strToken.begin(), strToken.end());
+    BOOST_CHECK(GetFluidInstruction(script)->fAmount);
+    BOOST_CHECK(!fluid.CheckFluidOperationScript(script, 1547678461, strError, true));
+    BOOST_CHECK(strError.find("exceeds maximum") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,8 +4,13 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "chainparams.h"
+#include "consensus/validation.h"
 #include "validation.h"
 #include "net.h"
+#include "script/standard.h"
+#include "streams.h"
+#include "txdb.h"
+#include "util.h"
 
 #include "test/test_dynamic.h"
 
@@ -30,4 +35,129 @@ BOOST_AUTO_TEST_CASE(test_combiner_all)
     Test.disconnect(&ReturnTrue);
     BOOST_CHECK(Test());
 }
+
+static void WriteExternalBlockRecord(FILE* file, const CMessageHeader::MessageStartChars& pchMessageStart, unsigned int nSize)
+{
+    CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
+    fileout << FLATDATA(pchMessageStart) << nSize;
+    std::vector<char> vchBlock(nSize, 0);
+    fileout.write(vchBlock.data(), vchBlock.size());
+    fileout.release();
+}
+
+BOOST_AUTO_TEST_CASE(external_block_batch_resync_at_end)
+{
+    FILE* file = tmpfile();
+    BOOST_REQUIRE(file != NULL);
+    for (int i = 0; i < 3; i++)
+        WriteExternalBlockRecord(file, Params().MessageStart(), 100);
+    rewind(file);
+
+    CBufferedFile blkdat(file, 4000, 2000, SER_DISK, CLIENT_VERSION);
+    uint64_t nRewind = blkdat.GetPos();
+    std::vector<CExternalBlock> vBlocks;
+    BOOST_CHECK(!ReadExternalBlockBatch(blkdat, Params(), nRewind, vBlocks));
+    BOOST_REQUIRE_EQUAL(vBlocks.size(), 3U);
+    BOOST_CHECK_EQUAL(vBlocks[0].nBlockPos, 8U);
+    BOOST_CHECK_EQUAL(vBlocks[2].nBlockPos, 224U);
+    BOOST_CHECK(blkdat.eof());
+
+    // The first block used only part of its bytes, scanning resumes behind it
+    // although the whole file has been read already
+    nRewind = vBlocks[0].nBlockPos + 80;
+    std::vector<CExternalBlock> vResync;
+    BOOST_CHECK(!ReadExternalBlockBatch(blkdat, Params(), nRewind, vResync));
+    BOOST_REQUIRE_EQUAL(vResync.size(), 2U);
+    BOOST_CHECK_EQUAL(vResync[0].nBlockPos, 116U);
+    BOOST_CHECK_EQUAL(vResync[1].nBlockPos, 224U);
+    BOOST_CHECK_EQUAL(vResync[1].nSize, 100U);
+
+    // Nothing is left behind the last block
+    std::vector<CExternalBlock> vEnd;
+    BOOST_CHECK(!ReadExternalBlockBatch(blkdat, Params(), nRewind, vEnd));
+    BOOST_CHECK(vEnd.empty());
+}
+
+extern bool fAddressIndex;
+extern bool fAddressBalanceIndex;
+
+// -addressindex is read when the block index is created, before the chain is mined
+struct AddressIndexArgs {
+    AddressIndexArgs() { ForceSetArg("-addressindex", "1"); }
+    ~AddressIndexArgs()
+    {
+        ForceSetArg("-addressindex", "0");
+        fAddressIndex = false;
+        fAddressBalanceIndex = false;
+    }
+};
+
+struct AddressIndexTestingSetup : public AddressIndexArgs, public TestChain100Setup {
+};
+
+static CAddressBalanceValue GetAddressBalance(const CKeyID& keyID)
+{
+    std::vector<std::pair<uint160, int> > addresses(1, std::make_pair(uint160(keyID), 1));
+    std::vector<std::pair<CAddressIndexIteratorKey, CAddressBalanceValue> > balances;
+    BOOST_CHECK(GetAddressBalances(addresses, balances));
+    BOOST_REQUIRE_EQUAL(balances.size(), 1U);
+    return balances[0].second;
+}
+
+static bool operator==(const CAddressBalanceValue& a, const CAddressBalanceValue& b)
+{
+    return a.balance == b.balance && a.received == b.received && a.txCount == b.txCount && a.lastHeight == b.lastHeight;
+}
+
+BOOST_FIXTURE_TEST_CASE(address_balance_index_verifydb_and_reorg, AddressIndexTestingSetup)
+{
+    BOOST_REQUIRE(fAddressIndex && fAddressBalanceIndex);
+    const CKeyID keyID = coinbaseKey.GetPubKey().GetID();
+    const CScript scriptPubKey = GetScriptForDestination(keyID);
+    for (int i = 0; i < 3; i++)
+        CreateAndProcessBlock(std::vector<CMutableTransaction>(), scriptPubKey);
+
+    CAddressBalanceValue value = GetAddressBalance(keyID);
+    BOOST_CHECK(value.balance > 0);
+    BOOST_CHECK_EQUAL(value.txCount, 3);
+    BOOST_CHECK_EQUAL(value.lastHeight, chainActive.Height());
+
+    // VerifyDB disconnects and reconnects the tip blocks on a scratch view only
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(CVerifyDB().VerifyDB(Params(), pcoinsTip, 3, 6));
+        BOOST_CHECK(GetAddressBalance(keyID) == value);
+        BOOST_CHECK(CVerifyDB().VerifyDB(Params(), pcoinsTip, 4, 6));
+        BOOST_CHECK(GetAddressBalance(keyID) == value);
+    }
+
+    // A block that was already applied, as replayed after a crash, is skipped
+    CBlockIndex* pindexTip = chainActive.Tip();
+    std::vector<std::pair<CAddressIndexKey, CAmount> > vReplay(1, std::make_pair(CAddressIndexKey(1, uint160(keyID), pindexTip->nHeight, 0, GetRandHash(), 0, false), value.balance));
+    BOOST_CHECK(pblocktree->UpdateAddressBalanceIndex(vReplay, pindexTip, false));
+    BOOST_CHECK(pblocktree->UpdateAddressBalanceIndex(vReplay, pindexTip->pprev, true));
+    BOOST_CHECK(GetAddressBalance(keyID) == value);
+
+    // Disconnecting the tip takes its coinbase out, reconnecting it restores the balance
+    CValidationState state;
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(InvalidateBlock(state, Params(), pindexTip));
+    }
+    BOOST_CHECK(ActivateBestChain(state, Params()));
+    BOOST_CHECK(chainActive.Tip() == pindexTip->pprev);
+    CAddressBalanceValue valueDisconnected = GetAddressBalance(keyID);
+    BOOST_CHECK(valueDisconnected.balance < value.balance);
+    BOOST_CHECK_EQUAL(valueDisconnected.txCount, 2);
+    BOOST_CHECK_EQUAL(valueDisconnected.lastHeight, pindexTip->nHeight - 1);
+
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(ResetBlockFailureFlags(pindexTip));
+    }
+    BOOST_CHECK(ActivateBestChain(state, Params()));
+    BOOST_CHECK(chainActive.Tip() == pindexTip);
+    BOOST_CHECK(GetAddressBalance(keyID) == value);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,9 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "bdap/domainentry.h"
+#include "bdap/utils.h"
+#include "fluid/fluid.h"
 #include "txmempool.h"
 #include "util.h"
 
@@ -583,4 +586,113 @@ BOOST_AUTO_TEST_CASE(MempoolSizeLimitTest)
     SetMockTime(0);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolFluidIndexTest)
+{
+    CTxMemPool pool(CFeeRate(0));
+    TestMemPoolEntryHelper entry;
+
+    std::vector<unsigned char> vchInstruction = ParseHex("3130303030303030303030303a3a313534373637383436313a3a");
+    CMutableTransaction tx1 = CMutableTransaction();
+    tx1.vin.resize(1);
+    tx1.vin[0].scriptSig = CScript() << OP_1;
+    tx1.vout.resize(2);
+    tx1.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+    tx1.vout[0].nValue = 10 * COIN;
+    tx1.vout[1].scriptPubKey = CScript() << OP_MINT << vchInstruction;
+    tx1.vout[1].nValue = 0;
+
+    uint256 hashInstruction, txid;
+    BOOST_CHECK(GetFluidInstructionHash(tx1.vout[1].scriptPubKey, hashInstruction));
+    BOOST_CHECK(!pool.existsFluidInstruction(hashInstruction, txid));
+
+    pool.addUnchecked(tx1.GetHash(), entry.FromTx(tx1));
+    BOOST_CHECK(pool.existsFluidInstruction(hashInstruction, txid));
+    BOOST_CHECK(txid == tx1.GetHash());
+
+    // The same instruction under another fluid opcode is a duplicate too
+    std::string strErrorMessage;
+    BOOST_CHECK(fluid.CheckIfExistsInMemPool(pool, CScript() << OP_REWARD_DYNODE << vchInstruction, strErrorMessage));
+    std::vector<unsigned char> vchOther(vchInstruction);
+    vchOther[0]++;
+    BOOST_CHECK(!fluid.CheckIfExistsInMemPool(pool, CScript() << OP_MINT << vchOther, strErrorMessage));
+
+    pool.removeRecursive(tx1);
+    BOOST_CHECK(!pool.existsFluidInstruction(hashInstruction, txid));
+
+    pool.addUnchecked(tx1.GetHash(), entry.FromTx(tx1));
+    pool.clear();
+    BOOST_CHECK(!pool.existsFluidInstruction(hashInstruction, txid));
+}
+
+BOOST_AUTO_TEST_CASE(MempoolBDAPIndexTest)
+{
+    CTxMemPool pool(CFeeRate(0));
+    TestMemPoolEntryHelper entry;
+
+    CDomainEntry domainEntry;
+    domainEntry.DomainComponent = vchFromString("bdap.io");
+    domainEntry.OrganizationalUnit = vchFromString("public");
+    domainEntry.ObjectID = vchFromString("mempooltest");
+    std::vector<unsigned char> vchData;
+    domainEntry.Serialize(vchData);
+
+    CMutableTransaction txEntry = CMutableTransaction();
+    txEntry.vin.resize(1);
+    txEntry.vin[0].scriptSig = CScript() << OP_11;
+    txEntry.vin[0].prevout = COutPoint(GetRandHash(), 0);
+    txEntry.vout.resize(2);
+    txEntry.vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+    txEntry.vout[0].nValue = 10 * COIN;
+    txEntry.vout[1].scriptPubKey = CScript() << OP_RETURN << vchData;
+    txEntry.vout[1].nValue = 0;
+
+    std::vector<unsigned char> vchLinkPubKey = ParseHex("a1b2c3d4e5f60718293a4b5c6d7e8f90a1b2c3d4e5f60718293a4b5c6d7e8f90");
+    std::vector<unsigned char> vchSharedPubKey = ParseHex("0f1e2d3c4b5a69788796a5b4c3d2e1f00f1e2d3c4b5a69788796a5b4c3d2e1f0");
+    CMutableTransaction txLink = CMutableTransaction();
+    txLink.vin.resize(1);
+    txLink.vin[0].scriptSig = CScript() << OP_11;
+    txLink.vin[0].prevout = COutPoint(GetRandHash(), 0);
+    txLink.vout.resize(1);
+    txLink.vout[0].scriptPubKey = CScript() << CScript::EncodeOP_N(OP_BDAP_NEW) << CScript::EncodeOP_N(OP_BDAP_LINK_REQUEST)
+                                            << vchLinkPubKey << vchSharedPubKey << 1000 << OP_2DROP << OP_2DROP << OP_DROP
+                                            << OP_11 << OP_EQUAL;
+    txLink.vout[0].nValue = 10 * COIN;
+
+    const std::string strObjectPath = domainEntry.GetFullObjectPath();
+    BOOST_CHECK(!pool.existsBDAPObjectPath(strObjectPath));
+    BOOST_CHECK(!pool.existsBDAPLinkPubKey(vchLinkPubKey, "bdap_new_link_request"));
+
+    pool.addUnchecked(txEntry.GetHash(), entry.FromTx(txEntry));
+    pool.addUnchecked(txLink.GetHash(), entry.FromTx(txLink));
+    BOOST_CHECK(pool.existsBDAPObjectPath(strObjectPath));
+    BOOST_CHECK(!pool.existsBDAPObjectPath("other@public.bdap.io"));
+    BOOST_CHECK(pool.existsBDAPLinkPubKey(vchLinkPubKey, "bdap_new_link_request"));
+    BOOST_CHECK(!pool.existsBDAPLinkPubKey(vchLinkPubKey, "bdap_new_link_accept"));
+    BOOST_CHECK(!pool.existsBDAPLinkPubKey(vchSharedPubKey, "bdap_new_link_request"));
+
+    // Removed once a block confirms them
+    pool.removeForBlock(std::vector<CTransactionRef>{MakeTransactionRef(txEntry), MakeTransactionRef(txLink)}, 1);
+    BOOST_CHECK(!pool.existsBDAPObjectPath(strObjectPath));
+    BOOST_CHECK(!pool.existsBDAPLinkPubKey(vchLinkPubKey, "bdap_new_link_request"));
+
+    // Removed when a block spends their inputs in another transaction
+    pool.addUnchecked(txEntry.GetHash(), entry.FromTx(txEntry));
+    pool.addUnchecked(txLink.GetHash(), entry.FromTx(txLink));
+    BOOST_CHECK(pool.existsBDAPObjectPath(strObjectPath));
+    BOOST_CHECK(pool.existsBDAPLinkPubKey(vchLinkPubKey, "bdap_new_link_request"));
+    CMutableTransaction txConflict = CMutableTransaction();
+    txConflict.vin.resize(2);
+    txConflict.vin[0].scriptSig = CScript() << OP_12;
+    txConflict.vin[0].prevout = txEntry.vin[0].prevout;
+    txConflict.vin[1].scriptSig = CScript() << OP_12;
+    txConflict.vin[1].prevout = txLink.vin[0].prevout;
+    txConflict.vout.resize(1);
+    txConflict.vout[0].scriptPubKey = CScript() << OP_12 << OP_EQUAL;
+    txConflict.vout[0].nValue = 10 * COIN;
+    pool.removeForBlock(std::vector<CTransactionRef>{MakeTransactionRef(txConflict)}, 2);
+    BOOST_CHECK_EQUAL(pool.size(), 0U);
+    BOOST_CHECK(!pool.existsBDAPObjectPath(strObjectPath));
+    BOOST_CHECK(!pool.existsBDAPLinkPubKey(vchLinkPubKey, "bdap_new_link_request"));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -10,7 +10,10 @@
 #include "validation.h"
 #include "dynode-payments.h"
 #include "miner/miner.h"
+#include "miner/template-assembler.h"
+#include "policy/policy.h"
 #include "pubkey.h"
+#include "random.h"
 #include "script/standard.h"
 #include "txmempool.h"
 #include "uint256.h"
@@ -18,6 +21,8 @@
 #include "utilstrencodings.h"
 
 #include "miner/impl/miner-gpu.h"
+#include "miner/internal/hash-rate-counter.h"
+#include "miner/internal/miner-context.h"
 
 #include "test/test_dynamic.h"
 
@@ -218,6 +223,10 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
         tx.vin[0].prevout.hash = hash;
     }
     BOOST_CHECK(pblocktemplate = CreateNewBlock(chainparams, scriptPubKey));
+    BOOST_CHECK(pblocktemplate->block.vtx.size() > 1);
+    // the template miners switch to on a new tip leaves the mempool out
+    BOOST_CHECK(pblocktemplate = CreateNewBlock(chainparams, &scriptPubKey, false));
+    BOOST_CHECK_EQUAL(pblocktemplate->block.vtx.size(), 1U);
     mempool.clear();
 
     // orphan in mempool, template creation fails
@@ -418,4 +427,188 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     fCheckpointsEnabled = true;
 }
 
+static CMutableTransaction SpendingTransaction(const COutPoint& prevout, unsigned int nOutputs)
+{
+    CMutableTransaction tx;
+    tx.vin.resize(1);
+    tx.vin[0].scriptSig = CScript() << OP_1;
+    tx.vin[0].prevout = prevout;
+    tx.vout.resize(nOutputs);
+    for (CTxOut& txout : tx.vout) {
+        txout.scriptPubKey = CScript() << OP_1;
+        txout.nValue = COIN;
+    }
+    return tx;
+}
+
+BOOST_AUTO_TEST_CASE(CBlockTemplateAssembler_events)
+{
+    CTxMemPool pool(CFeeRate(0));
+    CBlockTemplateAssembler assembler(pool);
+    TestMemPoolEntryHelper entry;
+    LOCK(pool.cs);
+
+    uint256 hashTip = GetRandHash(), hashNext = GetRandHash(), hashFork = GetRandHash();
+    CBlockIndex indexTip, indexNext, indexFork;
+    indexTip.phashBlock = &hashTip;
+    indexTip.nHeight = 100;
+    indexNext.phashBlock = &hashNext;
+    indexNext.nHeight = 101;
+    indexNext.pprev = &indexTip;
+    indexFork.phashBlock = &hashFork;
+    indexFork.nHeight = 100;
+
+    CMutableTransaction txParent = SpendingTransaction(COutPoint(GetRandHash(), 0), 2);
+    CMutableTransaction txChild = SpendingTransaction(COutPoint(txParent.GetHash(), 0), 1);
+    pool.addUnchecked(txParent.GetHash(), entry.Fee(10000).FromTx(txParent));
+    pool.addUnchecked(txChild.GetHash(), entry.Fee(10000).FromTx(txChild));
+
+    std::vector<CTxMemPool::txiter> vSelected = assembler.Update(&indexTip, 0, DEFAULT_BLOCK_MAX_SIZE, 0);
+    BOOST_REQUIRE_EQUAL(vSelected.size(), 2U);
+    BOOST_CHECK(vSelected[0]->GetTx().GetHash() == txParent.GetHash());
+    BOOST_CHECK(vSelected[1]->GetTx().GetHash() == txChild.GetHash());
+
+    // Selected as soon as it enters the mempool
+    CMutableTransaction txChild2 = SpendingTransaction(COutPoint(txParent.GetHash(), 1), 1);
+    pool.addUnchecked(txChild2.GetHash(), entry.Fee(10000).FromTx(txChild2));
+    vSelected = assembler.Update(&indexTip, 0, DEFAULT_BLOCK_MAX_SIZE, 0);
+    BOOST_REQUIRE_EQUAL(vSelected.size(), 3U);
+    BOOST_CHECK(vSelected[2]->GetTx().GetHash() == txChild2.GetHash());
+
+    // Children of a transaction confirmed by the next block stay selected
+    pool.removeForBlock(std::vector<CTransactionRef>{MakeTransactionRef(txParent)}, 101);
+    vSelected = assembler.Update(&indexNext, 0, DEFAULT_BLOCK_MAX_SIZE, 0);
+    BOOST_REQUIRE_EQUAL(vSelected.size(), 2U);
+    BOOST_CHECK(vSelected[0]->GetTx().GetHash() == txChild.GetHash());
+    BOOST_CHECK(vSelected[1]->GetTx().GetHash() == txChild2.GetHash());
+
+    pool.removeRecursive(txChild2);
+    vSelected = assembler.Update(&indexNext, 0, DEFAULT_BLOCK_MAX_SIZE, 0);
+    BOOST_REQUIRE_EQUAL(vSelected.size(), 1U);
+    BOOST_CHECK(vSelected[0]->GetTx().GetHash() == txChild.GetHash());
+
+    // After a reorg the selection starts over from the mempool
+    CMutableTransaction txOther = SpendingTransaction(COutPoint(GetRandHash(), 0), 1);
+    pool.addUnchecked(txOther.GetHash(), entry.Fee(20000).FromTx(txOther));
+    vSelected = assembler.Update(&indexFork, 0, DEFAULT_BLOCK_MAX_SIZE, 0);
+    BOOST_REQUIRE_EQUAL(vSelected.size(), 2U);
+    BOOST_CHECK(vSelected[0]->GetTx().GetHash() == txOther.GetHash());
+    BOOST_CHECK(vSelected[1]->GetTx().GetHash() == txChild.GetHash());
+
+    // A cleared mempool does not notify, the selection notices anyway
+    pool.clear();
+    BOOST_CHECK(assembler.Update(&indexFork, 0, DEFAULT_BLOCK_MAX_SIZE, 0).empty());
+
+    // A better paying transaction that does not fit replaces the selection
+    CMutableTransaction txLow = SpendingTransaction(COutPoint(GetRandHash(), 0), 1);
+    CMutableTransaction txHigh = SpendingTransaction(COutPoint(GetRandHash(), 0), 1);
+    unsigned int nBlockMaxSize = 1000 + ::GetSerializeSize(txLow, SER_NETWORK, PROTOCOL_VERSION) + 1;
+    pool.addUnchecked(txLow.GetHash(), entry.Fee(10000).FromTx(txLow));
+    vSelected = assembler.Update(&indexFork, 0, nBlockMaxSize, 0);
+    BOOST_REQUIRE_EQUAL(vSelected.size(), 1U);
+    BOOST_CHECK(vSelected[0]->GetTx().GetHash() == txLow.GetHash());
+    pool.addUnchecked(txHigh.GetHash(), entry.Fee(20000).FromTx(txHigh));
+    vSelected = assembler.Update(&indexFork, 0, nBlockMaxSize, 0);
+    BOOST_REQUIRE_EQUAL(vSelected.size(), 1U);
+    BOOST_CHECK(vSelected[0]->GetTx().GetHash() == txHigh.GetHash());
+}
+
+// Exposes the template swap to the test
+struct TestMinerSharedContext : public MinerSharedContext {
+    TestMinerSharedContext(const CChainParams& chainparams_, CConnman& connman_)
+        : MinerSharedContext(chainparams_, connman_){};
+
+    using MinerSharedContext::PublishBlock;
+    using MinerSharedContext::RecreateBlock;
+};
+
+BOOST_FIXTURE_TEST_CASE(MinerSharedContext_tip_change, TestChain100Setup)
+{
+    TestMinerSharedContext shared(Params(), *connman);
+    CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+
+    shared.RecreateBlock();
+    BOOST_CHECK(shared.tip() == chainActive.Tip());
+    BOOST_CHECK_EQUAL(shared.tip_generation(), 0);
+
+    // A full build starts on the current tip
+    int64_t generation = shared.tip_generation();
+    CBlockIndex* build_tip = chainActive.Tip();
+    std::shared_ptr<CBlockTemplate> build_template;
+    {
+        LOCK(cs_main);
+        build_template = CreateNewBlock(Params(), nullptr, true);
+    }
+
+    // The tip changes meanwhile and the coinbase-only template is published at once
+    CreateAndProcessBlock(std::vector<CMutableTransaction>(), scriptPubKey);
+    shared.RecreateBlock(true);
+    CBlockIndex* next_tip = chainActive.Tip();
+    BOOST_CHECK(next_tip != build_tip);
+    BOOST_CHECK(shared.tip() == next_tip);
+    BOOST_CHECK_EQUAL(shared.tip_generation(), generation + 1);
+    BOOST_CHECK(shared.block_template()->block.hashPrevBlock == next_tip->GetBlockHash());
+
+    // The build for the old tip finishes and is dropped
+    int64_t block_time = shared.block_time();
+    BOOST_CHECK(!shared.PublishBlock(build_tip, build_template, 0, false, generation));
+    BOOST_CHECK(shared.tip() == next_tip);
+    BOOST_CHECK_EQUAL(shared.block_time(), block_time);
+    BOOST_CHECK(shared.block_template()->block.hashPrevBlock == next_tip->GetBlockHash());
+
+    // A build started after the switch replaces the empty template
+    shared.RecreateBlock();
+    BOOST_CHECK_EQUAL(shared.block_time(), block_time + 1);
+    BOOST_CHECK(shared.tip() == next_tip);
+
+    // Publishing the same tip again does not start a new generation
+    shared.RecreateBlock(true);
+    BOOST_CHECK_EQUAL(shared.tip_generation(), generation + 1);
+    BOOST_CHECK_EQUAL(shared.block_time(), block_time + 1);
+}
+
+BOOST_AUTO_TEST_CASE(HashRateCounter_stats)
+{
+    HashRateCounterRef root = std::make_shared<HashRateCounter>();
+    HashRateCounterRef group = root->MakeChild();
+    HashRateCounterRef thread0 = group->MakeChild();
+    HashRateCounterRef thread1 = group->MakeChild();
+    thread0->SetDevice("CPU#0");
+    thread1->SetDevice("CPU#0");
+
+    thread0->Increment(100);
+    thread1->Increment(50);
+    thread0->AddTemplate(10, false);
+    thread1->AddTemplate(30, true);
+    thread1->AddBlock(true);
+    thread1->AddBlock(false);
+
+    HashRateStats stats = root->GetStats();
+    BOOST_CHECK(stats.device.empty());
+    BOOST_CHECK_EQUAL(stats.hashes, 150);
+    BOOST_CHECK_EQUAL(stats.templates, 2);
+    BOOST_CHECK_EQUAL(stats.stale_templates, 1);
+    BOOST_CHECK_EQUAL(stats.blocks_accepted, 1);
+    BOOST_CHECK_EQUAL(stats.blocks_rejected, 1);
+    BOOST_CHECK_EQUAL(stats.refresh_latency_total, 40);
+    BOOST_CHECK_EQUAL(stats.refresh_latency_max, 30);
+
+    std::vector<HashRateStats> threads;
+    root->GetThreadStats(threads);
+    BOOST_CHECK_EQUAL(threads.size(), 2);
+    BOOST_CHECK_EQUAL(threads[0].thread, 0);
+    BOOST_CHECK_EQUAL(threads[0].hashes, 100);
+    BOOST_CHECK_EQUAL(threads[1].thread, 1);
+    BOOST_CHECK_EQUAL(threads[1].hashes, 50);
+
+    // totals of finished threads stay in the group
+    thread1.reset();
+    threads.clear();
+    root->GetThreadStats(threads);
+    BOOST_CHECK_EQUAL(threads.size(), 1);
+    stats = root->GetStats();
+    BOOST_CHECK_EQUAL(stats.hashes, 150);
+    BOOST_CHECK_EQUAL(stats.blocks_accepted, 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -16,6 +16,8 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+
 #include <boost/thread.hpp>
 
 static const char DB_COIN = 'C';
@@ -24,6 +26,8 @@ static const char DB_BLOCK_FILES = 'f';
 static const char DB_TXINDEX = 't';
 static const char DB_ADDRESSINDEX = 'a';
 static const char DB_ADDRESSUNSPENTINDEX = 'u';
+static const char DB_ADDRESSBALANCEINDEX = 'A';
+static const char DB_ADDRESSBALANCEBEST = 'G';
 static const char DB_TIMESTAMPINDEX = 's';
 static const char DB_SPENTINDEX = 'p';
 static const char DB_BLOCK_INDEX = 'b';
@@ -324,6 +328,109 @@ bool CBlockTreeDB::ReadAddressIndex(uint160 addressHash, int type, std::vector<s
     return true;
 }
 
+/** Height of the last address index entry for an address below nHeight, or 0 if there is none */
+static int GetPrevAddressIndexHeight(CDBWrapper& db, unsigned int type, const uint160& addressHash, int nHeight)
+{
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    pcursor->Seek(std::make_pair(DB_ADDRESSINDEX, CAddressIndexIteratorHeightKey(type, addressHash, nHeight)));
+    if (pcursor->Valid())
+        pcursor->Prev();
+    else
+        pcursor->SeekToLast();
+
+    std::pair<char, CAddressIndexKey> key;
+    if (pcursor->Valid() && pcursor->GetKey(key) && key.first == DB_ADDRESSINDEX && key.second.type == type && key.second.hashBytes == addressHash)
+        return key.second.blockHeight;
+
+    return 0;
+}
+
+bool CBlockTreeDB::UpdateAddressBalanceIndex(const std::vector<std::pair<CAddressIndexKey, CAmount> >& vect, const CBlockIndex* pindex, bool fDisconnect)
+{
+    // The balances are running totals, so each block must be applied exactly once. The last block
+    // applied is written in the same batch, blocks replayed after a crash find it ahead and are skipped.
+    const int nHeight = pindex->nHeight;
+    const uint256 hashBlock = pindex->GetBlockHash();
+    const uint256 hashPrev = pindex->pprev ? pindex->pprev->GetBlockHash() : uint256();
+    uint256 hashBest;
+    if (Read(DB_ADDRESSBALANCEBEST, hashBest) && hashBest != (fDisconnect ? hashBlock : hashPrev)) {
+        LogPrint("db", "%s: skipping %s of block %s, balances are at %s\n", __func__,
+            fDisconnect ? "disconnect" : "connect", hashBlock.ToString(), hashBest.ToString());
+        return true;
+    }
+
+    // Fold the block's deltas per address first so each aggregate is read and written once.
+    // Entries of one transaction are always adjacent, so counting txhash changes counts transactions.
+    std::map<std::pair<unsigned int, uint160>, std::pair<CAddressBalanceValue, uint256> > mapDeltas;
+    for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator it = vect.begin(); it != vect.end(); it++) {
+        std::pair<CAddressBalanceValue, uint256>& delta = mapDeltas[std::make_pair(it->first.type, it->first.hashBytes)];
+        delta.first.balance += it->second;
+        if (it->second > 0)
+            delta.first.received += it->second;
+        if (delta.second != it->first.txhash) {
+            delta.first.txCount++;
+            delta.second = it->first.txhash;
+        }
+    }
+
+    CDBBatch batch(*this);
+    for (std::map<std::pair<unsigned int, uint160>, std::pair<CAddressBalanceValue, uint256> >::const_iterator it = mapDeltas.begin(); it != mapDeltas.end(); it++) {
+        const CAddressIndexIteratorKey key(it->first.first, it->first.second);
+        const CAddressBalanceValue& delta = it->second.first;
+        CAddressBalanceValue value;
+        if (!Read(std::make_pair(DB_ADDRESSBALANCEINDEX, key), value))
+            value.SetNull();
+
+        if (fDisconnect) {
+            value.balance -= delta.balance;
+            value.received -= delta.received;
+            value.txCount -= delta.txCount;
+            if (value.lastHeight >= nHeight)
+                value.lastHeight = GetPrevAddressIndexHeight(*this, key.type, key.hashBytes, nHeight);
+        } else {
+            value.balance += delta.balance;
+            value.received += delta.received;
+            value.txCount += delta.txCount;
+            value.lastHeight = nHeight;
+        }
+
+        if (value.txCount <= 0) {
+            batch.Erase(std::make_pair(DB_ADDRESSBALANCEINDEX, key));
+        } else {
+            batch.Write(std::make_pair(DB_ADDRESSBALANCEINDEX, key), value);
+        }
+    }
+    batch.Write(DB_ADDRESSBALANCEBEST, fDisconnect ? hashPrev : hashBlock);
+    return WriteBatch(batch);
+}
+
+bool CBlockTreeDB::ReadAddressBalanceIndex(std::vector<std::pair<uint160, int> > addresses, std::vector<std::pair<CAddressIndexIteratorKey, CAddressBalanceValue> >& balances)
+{
+    // Sort into key order so all lookups share one forward pass of a single cursor
+    std::vector<std::pair<unsigned int, uint160> > keys;
+    keys.reserve(addresses.size());
+    for (std::vector<std::pair<uint160, int> >::const_iterator it = addresses.begin(); it != addresses.end(); it++)
+        keys.push_back(std::make_pair((unsigned int)it->second, it->first));
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    for (std::vector<std::pair<unsigned int, uint160> >::const_iterator it = keys.begin(); it != keys.end(); it++) {
+        boost::this_thread::interruption_point();
+        const CAddressIndexIteratorKey searchKey(it->first, it->second);
+        CAddressBalanceValue value;
+        pcursor->Seek(std::make_pair(DB_ADDRESSBALANCEINDEX, searchKey));
+        std::pair<char, CAddressIndexIteratorKey> key;
+        if (pcursor->Valid() && pcursor->GetKey(key) && key.first == DB_ADDRESSBALANCEINDEX && key.second.type == searchKey.type && key.second.hashBytes == searchKey.hashBytes) {
+            if (!pcursor->GetValue(value))
+                return error("failed to get address balance index value");
+        }
+        balances.push_back(std::make_pair(searchKey, value));
+    }
+
+    return true;
+}
+
 bool CBlockTreeDB::WriteTimestampIndex(const CTimestampIndexKey& timestampIndex)
 {
     CDBBatch batch(*this);
@@ -137,6 +137,8 @@ public:
     bool WriteAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount> >& vect);
     bool EraseAddressIndex(const std::vector<std::pair<CAddressIndexKey, CAmount> >& vect);
     bool ReadAddressIndex(uint160 addressHash, int type, std::vector<std::pair<CAddressIndexKey, CAmount> >& addressIndex, int start = 0, int end = 0);
+    bool UpdateAddressBalanceIndex(const std::vector<std::pair<CAddressIndexKey, CAmount> >& vect, const CBlockIndex* pindex, bool fDisconnect);
+    bool ReadAddressBalanceIndex(std::vector<std::pair<uint160, int> > addresses, std::vector<std::pair<CAddressIndexIteratorKey, CAddressBalanceValue> >& balances);
     bool WriteTimestampIndex(const CTimestampIndexKey& timestampIndex);
     bool ReadTimestampIndex(const unsigned int& high, const unsigned int& low, std::vector<uint256>& vect);
     bool WriteFlag(const std::string& name, bool fValue);
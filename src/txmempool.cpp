@@ -7,9 +7,12 @@
 
 #include "txmempool.h"
 
+#include "bdap/domainentry.h"
+#include "bdap/utils.h"
 #include "clientversion.h"
 #include "consensus/consensus.h"
 #include "consensus/validation.h"
+#include "fluid/fluid.h"
 #include "instantsend.h"
 #include "policy/fees.h"
 #include "policy/policy.h"
@@ -434,6 +437,8 @@ bool CTxMemPool::addUnchecked(const uint256& hash, const CTxMemPoolEntry& entry,
     vTxHashes.emplace_back(hash, newit);
     newit->vTxHashesIdx = vTxHashes.size() - 1;
 
+    addBDAPFluidIndex(hash, newit->GetSharedTx());
+
     return true;
 }
 
@@ -672,6 +677,95 @@ bool CTxMemPool::removeSpentIndex(const uint256 txhash)
     return true;
 }
 
+void CTxMemPool::addBDAPFluidIndex(const uint256& txhash, const CTransactionRef& tx)
+{
+    AssertLockHeld(cs);
+    BDAPFluidKeys keys;
+    bool fDomainEntry = false;
+    for (const CTxOut& txOut : tx->vout) {
+        if (IsBDAPDataOutput(txOut)) {
+            if (!fDomainEntry) {
+                CDomainEntry domainEntry(tx);
+                keys.vObjectPaths.push_back(domainEntry.GetFullObjectPath());
+                fDomainEntry = true;
+            }
+        }
+        else if (IsBDAPOperationOutput(txOut)) {
+            // The link pubkey is the first parameter of the operation script, as AcceptToMemoryPoolWorker reads it
+            std::vector<unsigned char> vchPubKey;
+            std::string strOpType;
+            if (ExtractOpTypeValue(txOut.scriptPubKey, strOpType, vchPubKey))
+                keys.vLinkPubKeys.push_back(std::make_pair(vchPubKey, strOpType));
+        }
+        else if (IsTransactionFluid(txOut.scriptPubKey)) {
+            uint256 hashInstruction;
+            if (GetFluidInstructionHash(txOut.scriptPubKey, hashInstruction))
+                keys.vFluidInstructions.push_back(hashInstruction);
+        }
+    }
+    if (keys.vObjectPaths.empty() && keys.vLinkPubKeys.empty() && keys.vFluidInstructions.empty())
+        return;
+
+    for (const std::string& strObjectPath : keys.vObjectPaths)
+        mapBDAPObjectPath.insert(std::make_pair(strObjectPath, txhash));
+    for (const bdapLinkKey& linkKey : keys.vLinkPubKeys)
+        mapBDAPLinkPubKey.insert(std::make_pair(linkKey, txhash));
+    for (const uint256& hashInstruction : keys.vFluidInstructions)
+        mapFluidInstruction.insert(std::make_pair(hashInstruction, txhash));
+    mapBDAPFluidKeys.insert(std::make_pair(txhash, std::move(keys)));
+}
+
+template <typename K>
+static void EraseIndexEntry(std::multimap<K, uint256>& index, const K& key, const uint256& txhash)
+{
+    auto range = index.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == txhash) {
+            index.erase(it);
+            return;
+        }
+    }
+}
+
+void CTxMemPool::removeBDAPFluidIndex(const uint256& txhash)
+{
+    AssertLockHeld(cs);
+    mapBDAPFluidInserted::iterator it = mapBDAPFluidKeys.find(txhash);
+    if (it == mapBDAPFluidKeys.end())
+        return;
+
+    const BDAPFluidKeys& keys = it->second;
+    for (const std::string& strObjectPath : keys.vObjectPaths)
+        EraseIndexEntry(mapBDAPObjectPath, strObjectPath, txhash);
+    for (const bdapLinkKey& linkKey : keys.vLinkPubKeys)
+        EraseIndexEntry(mapBDAPLinkPubKey, linkKey, txhash);
+    for (const uint256& hashInstruction : keys.vFluidInstructions)
+        EraseIndexEntry(mapFluidInstruction, hashInstruction, txhash);
+    mapBDAPFluidKeys.erase(it);
+}
+
+bool CTxMemPool::existsBDAPObjectPath(const std::string& strObjectPath) const
+{
+    LOCK(cs);
+    return mapBDAPObjectPath.count(strObjectPath) != 0;
+}
+
+bool CTxMemPool::existsBDAPLinkPubKey(const std::vector<unsigned char>& vchPubKey, const std::string& strOpType) const
+{
+    LOCK(cs);
+    return mapBDAPLinkPubKey.count(std::make_pair(vchPubKey, strOpType)) != 0;
+}
+
+bool CTxMemPool::existsFluidInstruction(const uint256& hashInstruction, uint256& txid) const
+{
+    LOCK(cs);
+    std::multimap<uint256, uint256>::const_iterator it = mapFluidInstruction.find(hashInstruction);
+    if (it == mapFluidInstruction.end())
+        return false;
+    txid = it->second;
+    return true;
+}
+
 void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
 {
     NotifyEntryRemoved(it->GetSharedTx(), reason);
@@ -697,6 +791,7 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
     minerPolicyEstimator->removeTx(hash);
     removeAddressIndex(hash);
     removeSpentIndex(hash);
+    removeBDAPFluidIndex(hash);
 }
 
 
@@ -850,6 +945,10 @@ void CTxMemPool::_clear()
     mapLinks.clear();
     mapTx.clear();
     mapNextTx.clear();
+    mapBDAPObjectPath.clear();
+    mapBDAPLinkPubKey.clear();
+    mapFluidInstruction.clear();
+    mapBDAPFluidKeys.clear();
     totalTxSize = 0;
     cachedInnerUsage = 0;
     lastRollingFeeUpdate = GetTime();
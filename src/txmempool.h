@@ -531,6 +531,24 @@ private:
     typedef std::map<uint256, std::vector<CSpentIndexKey> > mapSpentIndexInserted;
     mapSpentIndexInserted mapSpentInserted;
 
+    // BDAP object paths, BDAP link (pubkey, op type) and fluid instruction hashes of the
+    // transactions in the pool, so that admission checks don't have to scan mapTx
+    typedef std::pair<std::vector<unsigned char>, std::string> bdapLinkKey;
+    std::multimap<std::string, uint256> mapBDAPObjectPath;
+    std::multimap<bdapLinkKey, uint256> mapBDAPLinkPubKey;
+    std::multimap<uint256, uint256> mapFluidInstruction;
+
+    struct BDAPFluidKeys {
+        std::vector<std::string> vObjectPaths;
+        std::vector<bdapLinkKey> vLinkPubKeys;
+        std::vector<uint256> vFluidInstructions;
+    };
+    typedef std::map<uint256, BDAPFluidKeys> mapBDAPFluidInserted;
+    mapBDAPFluidInserted mapBDAPFluidKeys;
+
+    void addBDAPFluidIndex(const uint256& txhash, const CTransactionRef& tx);
+    void removeBDAPFluidIndex(const uint256& txhash);
+
     void UpdateParent(txiter entry, txiter parent, bool add);
     void UpdateChild(txiter entry, txiter child, bool add);
 
@@ -570,6 +588,10 @@ public:
     bool getSpentIndex(CSpentIndexKey& key, CSpentIndexValue& value);
     bool removeSpentIndex(const uint256 txhash);
 
+    bool existsBDAPObjectPath(const std::string& strObjectPath) const;
+    bool existsBDAPLinkPubKey(const std::vector<unsigned char>& vchPubKey, const std::string& strOpType) const;
+    bool existsFluidInstruction(const uint256& hashInstruction, uint256& txid) const;
+
     void removeRecursive(const CTransaction& tx, MemPoolRemovalReason reason = MemPoolRemovalReason::UNKNOWN);
     void removeForReorg(const CCoinsViewCache* pcoins, unsigned int nMemPoolHeight, int flags);
     void removeConflicts(const CTransaction& tx);
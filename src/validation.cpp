@@ -58,6 +58,7 @@
 
 #include <atomic>
 #include <sstream>
+#include <thread>
 
 #include <boost/algorithm/string/join.hpp>
 #include <boost/algorithm/string/replace.hpp>
@@ -87,6 +88,7 @@ std::atomic_bool fImporting(false);
 bool fReindex = false;
 bool fTxIndex = true;
 bool fAddressIndex = false;
+bool fAddressBalanceIndex = false;
 bool fTimestampIndex = false;
 bool fSpentIndex = false;
 bool fHavePruned = false;
@@ -745,7 +747,7 @@ bool AcceptToMemoryPoolWorker(CTxMemPool& pool, CValidationState& state, const C
                 // fluid transaction is already in the mempool.  Reject tx.
                 return state.DoS(100, false, REJECT_INVALID, strErrorMessage);
             }
-            if (!fluid.ExtractCheckTimestamp(ScriptToAsmStr(txout.scriptPubKey), GetTime())) {
+            if (!fluid.ExtractCheckTimestamp(txout.scriptPubKey, GetTime())) {
                 return state.DoS(100, false, REJECT_INVALID, "fluid-tx-timestamp-error");
             }
             if (!fluid.CheckFluidOperationScript(txout.scriptPubKey, GetTime(), strErrorMessage, true)) {
@@ -1365,6 +1367,41 @@ bool GetAddressIndex(uint160 addressHash, int type, std::vector<std::pair<CAddre
     return true;
 }
 
+bool GetAddressBalances(const std::vector<std::pair<uint160, int> >& addresses, std::vector<std::pair<CAddressIndexIteratorKey, CAddressBalanceValue> >& balances)
+{
+    if (!fAddressIndex)
+        return error("address index not enabled");
+
+    if (fAddressBalanceIndex) {
+        if (!pblocktree->ReadAddressBalanceIndex(addresses, balances))
+            return error("unable to get balance for address");
+        return true;
+    }
+
+    // Address index was built before balance aggregates existed (until -reindex); sum the history.
+    for (std::vector<std::pair<uint160, int> >::const_iterator it = addresses.begin(); it != addresses.end(); it++) {
+        std::vector<std::pair<CAddressIndexKey, CAmount> > addressIndex;
+        if (!pblocktree->ReadAddressIndex(it->first, it->second, addressIndex))
+            return error("unable to get txids for address");
+
+        CAddressBalanceValue value;
+        uint256 lastTxHash;
+        for (std::vector<std::pair<CAddressIndexKey, CAmount> >::const_iterator itIndex = addressIndex.begin(); itIndex != addressIndex.end(); itIndex++) {
+            value.balance += itIndex->second;
+            if (itIndex->second > 0)
+                value.received += itIndex->second;
+            if (itIndex->first.txhash != lastTxHash) {
+                value.txCount++;
+                lastTxHash = itIndex->first.txhash;
+            }
+            value.lastHeight = itIndex->first.blockHeight;
+        }
+        balances.push_back(std::make_pair(CAddressIndexIteratorKey(it->second, it->first), value));
+    }
+
+    return true;
+}
+
 bool GetAddressUnspent(uint160 addressHash, int type, std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >& unspentOutputs)
 {
     if (!fAddressIndex)
@@ -1484,6 +1521,33 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus:
     return true;
 }
 
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& vchBlock, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart)
+{
+    // Step back over the message start and size written by WriteBlockToDisk
+    CDiskBlockPos hpos = pos;
+    hpos.nPos -= CMessageHeader::MESSAGE_START_SIZE + sizeof(unsigned int);
+    CAutoFile filein(OpenBlockFile(hpos, true), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull())
+        return error("%s: OpenBlockFile failed for %s", __func__, pos.ToString());
+
+    try {
+        CMessageHeader::MessageStartChars blockStart;
+        unsigned int nBlockSize;
+        filein >> FLATDATA(blockStart) >> nBlockSize;
+        if (memcmp(blockStart, messageStart, CMessageHeader::MESSAGE_START_SIZE))
+            return error("%s: Block magic mismatch for %s", __func__, pos.ToString());
+        if (nBlockSize > MAX_SIZE)
+            return error("%s: Block data is larger than maximum deserialization size for %s", __func__, pos.ToString());
+
+        vchBlock.resize(nBlockSize);
+        filein.read((char*)vchBlock.data(), nBlockSize);
+    } catch (const std::exception& e) {
+        return error("%s: Read from block file failed: %s for %s", __func__, e.what(), pos.ToString());
+    }
+
+    return true;
+}
+
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
 {
     if (!ReadBlockFromDisk(block, pindex->GetBlockPos(), consensusParams))
@@ -1876,8 +1940,9 @@ int ApplyTxInUndo(Coin&& undo, CCoinsViewCache& view, const COutPoint& out)
 }
 
 /** Undo the effects of this block (with given index) on the UTXO set represented by coins.
- *  When UNCLEAN or FAILED is returned, view is left in an indeterminate state. */
-static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& state, const CBlockIndex* pindex, CCoinsViewCache& view)
+ *  When UNCLEAN or FAILED is returned, view is left in an indeterminate state.
+ *  With fJustCheck (a scratch view, as in VerifyDB) the block tree indexes are left untouched. */
+static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& state, const CBlockIndex* pindex, CCoinsViewCache& view, bool fJustCheck = false)
 {
     assert(pindex->GetBlockHash() == view.GetBestBlock());
 
@@ -2037,7 +2102,11 @@ static DisconnectResult DisconnectBlock(const CBlock& block, CValidationState& s
     // move best block pointer to prevout block
     view.SetBestBlock(pindex->pprev->GetBlockHash());
 
-    if (fAddressIndex) {
+    if (fAddressIndex && !fJustCheck) {
+        if (fAddressBalanceIndex && !pblocktree->UpdateAddressBalanceIndex(addressIndex, pindex, true)) {
+            AbortNode(state, "Failed to update address balance index");
+            return DISCONNECT_FAILED;
+        }
         if (!pblocktree->EraseAddressIndex(addressIndex)) {
             AbortNode(state, "Failed to delete address index");
             return DISCONNECT_FAILED;
@@ -2156,6 +2225,7 @@ public:
 // Protected by cs_main
 static ThresholdConditionCache warningcache[VERSIONBITS_NUM_BITS];
 
+static int64_t nTimeCheckBlock = 0;
 static int64_t nTimeCheck = 0;
 static int64_t nTimeForks = 0;
 static int64_t nTimeVerify = 0;
@@ -2533,6 +2603,10 @@ static bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockInd
             return AbortNode(state, "Failed to write address index");
         }
 
+        if (fAddressBalanceIndex && !pblocktree->UpdateAddressBalanceIndex(addressIndex, pindex, false)) {
+            return AbortNode(state, "Failed to write address balance index");
+        }
+
         if (!pblocktree->UpdateAddressUnspentIndex(addressUnspentIndex)) {
             return AbortNode(state, "Failed to write address unspent index");
         }
@@ -2877,6 +2951,26 @@ bool static ConnectTip(CValidationState& state, const CChainParams& chainparams,
     return true;
 }
 
+CBlockValidationTimings GetBlockValidationTimings()
+{
+    LOCK(cs_main);
+    CBlockValidationTimings timings;
+    timings.nCheckBlock = nTimeCheckBlock;
+    timings.nCheck = nTimeCheck;
+    timings.nForks = nTimeForks;
+    timings.nConnect = nTimeConnect;
+    timings.nVerify = nTimeVerify;
+    timings.nIndex = nTimeIndex;
+    timings.nCallbacks = nTimeCallbacks;
+    timings.nReadFromDisk = nTimeReadFromDisk;
+    timings.nConnectTotal = nTimeConnectTotal;
+    timings.nFlush = nTimeFlush;
+    timings.nChainState = nTimeChainState;
+    timings.nPostConnect = nTimePostConnect;
+    timings.nTotal = nTimeTotal;
+    return timings;
+}
+
 bool DisconnectBlocks(int blocks)
 {
     LOCK(cs_main);
@@ -3852,9 +3946,12 @@ bool ProcessNewBlock(const CChainParams& chainparams, const std::shared_ptr<cons
         CValidationState state;
         // Ensure that CheckBlock() passes before calling AcceptBlock, as
         // belt-and-suspenders.
+        int64_t nTimeStart = GetTimeMicros();
         bool ret = CheckBlock(*pblock, state, chainparams.GetConsensus());
+        int64_t nTimeChecked = GetTimeMicros();
 
         LOCK(cs_main);
+        nTimeCheckBlock += nTimeChecked - nTimeStart;
 
         if (ret) {
             // Store to disk
@@ -4199,6 +4296,8 @@ bool static LoadBlockIndexDB(const CChainParams& chainparams)
     // Check whether we have an address index
     pblocktree->ReadFlag("addressindex", fAddressIndex);
     LogPrintf("%s: address index %s\n", __func__, fAddressIndex ? "enabled" : "disabled");
+    pblocktree->ReadFlag("addressbalanceindex", fAddressBalanceIndex);
+    fAddressBalanceIndex &= fAddressIndex;
 
     // Check whether we have a timestamp index
     pblocktree->ReadFlag("timestampindex", fTimestampIndex);
@@ -4289,7 +4388,7 @@ bool CVerifyDB::VerifyDB(const CChainParams& chainparams, CCoinsView* coinsview,
         }
         // check level 3: check for inconsistencies during memory-only disconnect of tip blocks
         if (nCheckLevel >= 3 && pindex == pindexState && (coins.DynamicMemoryUsage() + pcoinsTip->DynamicMemoryUsage()) <= nCoinCacheUsage) {
-            DisconnectResult res = DisconnectBlock(block, state, pindex, coins);
+            DisconnectResult res = DisconnectBlock(block, state, pindex, coins, true);
             if (res == DISCONNECT_FAILED) {
                 return error("VerifyDB(): *** irrecoverable inconsistency in block data at %d, hash=%s", pindex->nHeight, pindex->GetBlockHash().ToString());
             }
@@ -4394,6 +4493,10 @@ bool InitBlockIndex(const CChainParams& chainparams)
     fAddressIndex = GetBoolArg("-addressindex", DEFAULT_ADDRESSINDEX);
     pblocktree->WriteFlag("addressindex", fAddressIndex);
 
+    // Balance aggregates are only complete when maintained from genesis
+    fAddressBalanceIndex = fAddressIndex;
+    pblocktree->WriteFlag("addressbalanceindex", fAddressBalanceIndex);
+
     // Use the provided setting for -timestampindex in the new database
     fTimestampIndex = GetBoolArg("-timestampindex", DEFAULT_TIMESTAMPINDEX);
     pblocktree->WriteFlag("timestampindex", fTimestampIndex);
@@ -4421,112 +4524,245 @@ bool InitBlockIndex(const CChainParams& chainparams)
     return true;
 }
 
+namespace
+{
+/** Upper bounds for the number of blocks and raw bytes read ahead per batch by LoadExternalBlockFile */
+static const size_t MAX_EXTERNAL_BLOCK_BATCH = 1024;
+static const uint64_t MAX_EXTERNAL_BLOCK_BATCH_SIZE = 8 * 1024 * 1024;
+
+void DeserializeExternalBlock(CExternalBlock& item)
+{
+    try {
+        CDataStream ss(item.vchBlock.data(), item.vchBlock.data() + item.vchBlock.size(), SER_DISK, CLIENT_VERSION);
+        std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+        ss >> *pblock;
+        // memoizes the Argon2d header hash for the in-order stage
+        pblock->GetHash();
+        item.nConsumed = item.vchBlock.size() - ss.size();
+        item.pblock = pblock;
+    } catch (const std::exception& e) {
+        item.strError = e.what();
+    }
+    std::vector<char>().swap(item.vchBlock);
+}
+
+/**
+ * A batch of blocks read from an external block file. Start() deserializes
+ * and hashes them on worker threads, while the caller hands the previous
+ * batch to AcceptBlock in file order.
+ */
+class CExternalBlockBatch
+{
+private:
+    std::atomic<size_t> nNext;
+    std::vector<std::thread> vThreads;
+
+    void Work()
+    {
+        size_t i;
+        while ((i = nNext++) < vBlocks.size())
+            DeserializeExternalBlock(vBlocks[i]);
+    }
+
+public:
+    std::vector<CExternalBlock> vBlocks;
+
+    CExternalBlockBatch() : nNext(0) {}
+    ~CExternalBlockBatch() { Join(); }
+
+    void Start(int nThreads)
+    {
+        nNext = 0;
+        for (int i = 0; i < std::min(nThreads, (int)vBlocks.size()); i++)
+            vThreads.emplace_back(&CExternalBlockBatch::Work, this);
+    }
+
+    void Join()
+    {
+        for (std::thread& thread : vThreads)
+            thread.join();
+        vThreads.clear();
+    }
+};
+
+} // namespace
+
+bool ReadExternalBlockBatch(CBufferedFile& blkdat, const CChainParams& chainparams, uint64_t& nRewind, std::vector<CExternalBlock>& vBlocks)
+{
+    uint64_t nBatchSize = 0;
+    while (vBlocks.size() < MAX_EXTERNAL_BLOCK_BATCH && nBatchSize < MAX_EXTERNAL_BLOCK_BATCH_SIZE) {
+        boost::this_thread::interruption_point();
+
+        // A resync may move back from the end of the file, so test for it after seeking
+        blkdat.SetPos(nRewind);
+        if (blkdat.eof())
+            break;
+        nRewind++;         // start one byte further next time, in case of failure
+        blkdat.SetLimit(); // remove former limit
+        unsigned int nSize = 0;
+        try {
+            // locate a header
+            unsigned char buf[CMessageHeader::MESSAGE_START_SIZE];
+            blkdat.FindByte(chainparams.MessageStart()[0]);
+            nRewind = blkdat.GetPos() + 1;
+            blkdat >> FLATDATA(buf);
+            if (memcmp(buf, chainparams.MessageStart(), CMessageHeader::MESSAGE_START_SIZE))
+                continue;
+            // read size
+            blkdat >> nSize;
+            if (nSize < 80 || nSize > MAX_BLOCK_SIZE)
+                continue;
+        } catch (const std::exception&) {
+            // no valid block header found; don't complain
+            return false;
+        }
+        try {
+            // read block
+            CExternalBlock item;
+            item.nResync = nRewind;
+            item.nBlockPos = blkdat.GetPos();
+            item.nSize = nSize;
+            item.nConsumed = 0;
+            blkdat.SetLimit(item.nBlockPos + nSize);
+            item.vchBlock.resize(nSize);
+            blkdat.read(item.vchBlock.data(), nSize);
+            nRewind = blkdat.GetPos();
+            nBatchSize += nSize;
+            vBlocks.push_back(std::move(item));
+        } catch (const std::exception& e) {
+            LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
+        }
+    }
+    return !blkdat.eof();
+}
+
 bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskBlockPos* dbp)
 {
     // Map of disk positions for blocks with unknown parent (only used for reindex)
     static std::multimap<uint256, CDiskBlockPos> mapBlocksUnknownParent;
     int64_t nStart = GetTimeMillis();
 
+    // Hashing a header is a full Argon2d evaluation, so blocks are deserialized
+    // and hashed on -par worker threads one batch ahead of the in-order stage.
+    int nThreads = std::max(nScriptCheckThreads, 1);
+
     int nLoaded = 0;
     try {
-        // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
-        CBufferedFile blkdat(fileIn, 2 * MAX_BLOCK_SIZE, MAX_BLOCK_SIZE + 8, SER_DISK, CLIENT_VERSION);
+        // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor.
+        // The rewind window covers the batch being accepted and the one being hashed,
+        // so scanning can resume right behind a block that fails to deserialize.
+        const uint64_t nRewindWindow = 2 * (MAX_EXTERNAL_BLOCK_BATCH_SIZE + MAX_BLOCK_SIZE + 8);
+        CBufferedFile blkdat(fileIn, nRewindWindow + 2 * MAX_BLOCK_SIZE, nRewindWindow, SER_DISK, CLIENT_VERSION);
         uint64_t nRewind = blkdat.GetPos();
-        while (!blkdat.eof()) {
-            boost::this_thread::interruption_point();
-
-            blkdat.SetPos(nRewind);
-            nRewind++;         // start one byte further next time, in case of failure
-            blkdat.SetLimit(); // remove former limit
-            unsigned int nSize = 0;
-            try {
-                // locate a header
-                unsigned char buf[CMessageHeader::MESSAGE_START_SIZE];
-                blkdat.FindByte(chainparams.MessageStart()[0]);
-                nRewind = blkdat.GetPos() + 1;
-                blkdat >> FLATDATA(buf);
-                if (memcmp(buf, chainparams.MessageStart(), CMessageHeader::MESSAGE_START_SIZE))
-                    continue;
-                // read size
-                blkdat >> nSize;
-                if (nSize < 80 || nSize > MAX_BLOCK_SIZE)
-                    continue;
-            } catch (const std::exception&) {
-                // no valid block header found; don't complain
-                break;
-            }
-            try {
-                // read block
-                uint64_t nBlockPos = blkdat.GetPos();
-                if (dbp)
-                    dbp->nPos = nBlockPos;
-                blkdat.SetLimit(nBlockPos + nSize);
-                blkdat.SetPos(nBlockPos);
-                std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-                CBlock& block = *pblock;
-                blkdat >> block;
-                nRewind = blkdat.GetPos();
-
-                // detect out of order blocks, and store them for later
-                uint256 hash = block.GetHash();
-                if (hash != chainparams.GetConsensus().hashGenesisBlock && mapBlockIndex.find(block.hashPrevBlock) == mapBlockIndex.end()) {
-                    LogPrint("reindex", "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
-                        block.hashPrevBlock.ToString());
-                    if (dbp)
-                        mapBlocksUnknownParent.insert(std::make_pair(block.hashPrevBlock, *dbp));
-                    continue;
-                }
-
-                // process in case the block isn't known yet
-                if (mapBlockIndex.count(hash) == 0 || (mapBlockIndex[hash]->nStatus & BLOCK_HAVE_DATA) == 0) {
-                    LOCK(cs_main);
-                    CValidationState state;
-                    if (AcceptBlock(pblock, state, chainparams, NULL, true, dbp, NULL))
-                        nLoaded++;
-                    if (state.IsError())
-                        break;
-                } else if (hash != chainparams.GetConsensus().hashGenesisBlock && mapBlockIndex[hash]->nHeight % 1000 == 0) {
-                    LogPrint("reindex", "Block Import: already had block %s at height %d\n", hash.ToString(), mapBlockIndex[hash]->nHeight);
-                }
 
-                // Activate the genesis block so normal node progress can continue
-                if (hash == chainparams.GetConsensus().hashGenesisBlock) {
-                    CValidationState state;
-                    if (!ActivateBestChain(state, chainparams)) {
-                        break;
-                    }
+        std::unique_ptr<CExternalBlockBatch> pbatch(new CExternalBlockBatch());
+        bool fMore = ReadExternalBlockBatch(blkdat, chainparams, nRewind, pbatch->vBlocks);
+        pbatch->Start(nThreads);
+        bool fAbort = false;
+        while (!pbatch->vBlocks.empty() && !fAbort) {
+            pbatch->Join();
+
+            // Read and start hashing the next batch while this one is accepted
+            std::unique_ptr<CExternalBlockBatch> pnext(new CExternalBlockBatch());
+            if (fMore)
+                fMore = ReadExternalBlockBatch(blkdat, chainparams, nRewind, pnext->vBlocks);
+            pnext->Start(nThreads);
+
+            bool fResync = false;
+            for (CExternalBlock& item : pbatch->vBlocks) {
+                boost::this_thread::interruption_point();
+
+                if (!item.pblock) {
+                    LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, item.strError);
+                    nRewind = item.nResync;
+                    fResync = true;
+                    break;
                 }
 
-                NotifyHeaderTip();
-
-                // Recursively process earlier encountered successors of this block
-                std::deque<uint256> queue;
-                queue.push_back(hash);
-                while (!queue.empty()) {
-                    uint256 head = queue.front();
-                    queue.pop_front();
-                    std::pair<std::multimap<uint256, CDiskBlockPos>::iterator, std::multimap<uint256, CDiskBlockPos>::iterator> range = mapBlocksUnknownParent.equal_range(head);
-                    while (range.first != range.second) {
-                        std::multimap<uint256, CDiskBlockPos>::iterator it = range.first;
-                        std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
-                        if (ReadBlockFromDisk(*pblockrecursive, it->second, chainparams.GetConsensus())) {
-                            LogPrint("reindex", "%s: Processing out of order child %s of %s\n", __func__, block.GetHash().ToString(),
-                                head.ToString());
+                try {
+                    std::shared_ptr<CBlock> pblock = item.pblock;
+                    CBlock& block = *pblock;
+                    if (dbp)
+                        dbp->nPos = item.nBlockPos;
+
+                    // detect out of order blocks, and store them for later
+                    uint256 hash = block.GetHash();
+                    if (hash != chainparams.GetConsensus().hashGenesisBlock && mapBlockIndex.find(block.hashPrevBlock) == mapBlockIndex.end()) {
+                        LogPrint("reindex", "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
+                            block.hashPrevBlock.ToString());
+                        if (dbp)
+                            mapBlocksUnknownParent.insert(std::make_pair(block.hashPrevBlock, *dbp));
+                    } else {
+                        // process in case the block isn't known yet
+                        if (mapBlockIndex.count(hash) == 0 || (mapBlockIndex[hash]->nStatus & BLOCK_HAVE_DATA) == 0) {
                             LOCK(cs_main);
-                            CValidationState dummy;
-                            if (AcceptBlock(pblockrecursive, dummy, chainparams, NULL, true, &it->second, NULL)) {
+                            CValidationState state;
+                            if (AcceptBlock(pblock, state, chainparams, NULL, true, dbp, NULL))
                                 nLoaded++;
-                                queue.push_back(pblockrecursive->GetHash());
+                            if (state.IsError()) {
+                                fAbort = true;
+                                break;
                             }
+                        } else if (hash != chainparams.GetConsensus().hashGenesisBlock && mapBlockIndex[hash]->nHeight % 1000 == 0) {
+                            LogPrint("reindex", "Block Import: already had block %s at height %d\n", hash.ToString(), mapBlockIndex[hash]->nHeight);
                         }
-                        range.first++;
-                        mapBlocksUnknownParent.erase(it);
+
+                        // Activate the genesis block so normal node progress can continue
+                        if (hash == chainparams.GetConsensus().hashGenesisBlock) {
+                            CValidationState state;
+                            if (!ActivateBestChain(state, chainparams)) {
+                                fAbort = true;
+                                break;
+                            }
+                        }
+
                         NotifyHeaderTip();
+
+                        // Recursively process earlier encountered successors of this block
+                        std::deque<uint256> queue;
+                        queue.push_back(hash);
+                        while (!queue.empty()) {
+                            uint256 head = queue.front();
+                            queue.pop_front();
+                            std::pair<std::multimap<uint256, CDiskBlockPos>::iterator, std::multimap<uint256, CDiskBlockPos>::iterator> range = mapBlocksUnknownParent.equal_range(head);
+                            while (range.first != range.second) {
+                                std::multimap<uint256, CDiskBlockPos>::iterator it = range.first;
+                                std::shared_ptr<CBlock> pblockrecursive = std::make_shared<CBlock>();
+                                if (ReadBlockFromDisk(*pblockrecursive, it->second, chainparams.GetConsensus())) {
+                                    LogPrint("reindex", "%s: Processing out of order child %s of %s\n", __func__, block.GetHash().ToString(),
+                                        head.ToString());
+                                    LOCK(cs_main);
+                                    CValidationState dummy;
+                                    if (AcceptBlock(pblockrecursive, dummy, chainparams, NULL, true, &it->second, NULL)) {
+                                        nLoaded++;
+                                        queue.push_back(pblockrecursive->GetHash());
+                                    }
+                                }
+                                range.first++;
+                                mapBlocksUnknownParent.erase(it);
+                                NotifyHeaderTip();
+                            }
+                        }
                     }
+                } catch (const std::exception& e) {
+                    LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
                 }
-            } catch (const std::exception& e) {
-                LogPrintf("%s: Deserialize or I/O error - %s\n", __func__, e.what());
+
+                // The block didn't use all announced bytes, continue scanning right behind it
+                if (item.nConsumed < item.nSize) {
+                    nRewind = item.nBlockPos + item.nConsumed;
+                    fResync = true;
+                    break;
+                }
+            }
+
+            if (fResync && !fAbort) {
+                // Everything read after the resync point is stale
+                pnext.reset(new CExternalBlockBatch());
+                fMore = ReadExternalBlockBatch(blkdat, chainparams, nRewind, pnext->vBlocks);
+                pnext->Start(nThreads);
             }
+            pbatch = std::move(pnext);
         }
     } catch (const std::runtime_error& e) {
         AbortNode(std::string("System error: ") + e.what());
@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <exception>
 #include <map>
+#include <memory>
 #include <set>
 #include <stdint.h>
 #include <string>
@@ -35,9 +36,11 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/unordered_map.hpp>
 
+class CBlock;
 class CBloomFilter;
 class CBlockIndex;
 class CBlockTreeDB;
+class CBufferedFile;
 class CChainParams;
 class CCoinsViewDB;
 class CInv;
@@ -259,6 +262,26 @@ bool ProcessNewBlock(const CChainParams& chainparams, const std::shared_ptr<cons
  */
 bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& block, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex = NULL);
 
+/** Cumulative time spent in each stage of block validation, in microseconds (the -debug=bench figures) */
+struct CBlockValidationTimings {
+    int64_t nCheckBlock;    //!< context free CheckBlock in ProcessNewBlock
+    int64_t nCheck;         //!< CheckBlock again in ConnectBlock
+    int64_t nForks;         //!< fork activation checks
+    int64_t nConnect;       //!< connecting transaction inputs, including BDAP and index record building
+    int64_t nVerify;        //!< connecting plus dynode/fluid payment checks and waiting for script checks
+    int64_t nIndex;         //!< writing undo data and the tx/address/spent/timestamp indexes
+    int64_t nCallbacks;
+    int64_t nReadFromDisk;
+    int64_t nConnectTotal;  //!< all of ConnectBlock
+    int64_t nFlush;         //!< flushing the block's coins view into pcoinsTip
+    int64_t nChainState;    //!< FlushStateToDisk
+    int64_t nPostConnect;
+    int64_t nTotal;         //!< all of ConnectTip
+};
+
+/** Get the validation timings accumulated since startup */
+CBlockValidationTimings GetBlockValidationTimings();
+
 /** Check whether enough disk space is available for an incoming block */
 bool CheckDiskSpace(uint64_t nAdditionalBytes = 0);
 /** Open a block file (blk?????.dat) */
@@ -269,6 +292,19 @@ FILE* OpenUndoFile(const CDiskBlockPos& pos, bool fReadOnly = false);
 boost::filesystem::path GetBlockPosFilename(const CDiskBlockPos& pos, const char* prefix);
 /** Import blocks from an external file */
 bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskBlockPos* dbp = NULL);
+
+/** A block found in an external block file, deserialized and hashed on a worker thread */
+struct CExternalBlock {
+    uint64_t nResync;    //!< file position to resume scanning from if the block can't be used
+    uint64_t nBlockPos;  //!< file position of the serialized block
+    uint64_t nSize;      //!< size announced in front of the block
+    uint64_t nConsumed;  //!< bytes actually used by the deserialized block
+    std::vector<char> vchBlock;
+    std::shared_ptr<CBlock> pblock; //!< null if the block could not be deserialized
+    std::string strError;
+};
+/** Scan for the next blocks of an external block file starting at nRewind, as many as fit in one batch. Returns false at the end of the file. */
+bool ReadExternalBlockBatch(CBufferedFile& blkdat, const CChainParams& chainparams, uint64_t& nRewind, std::vector<CExternalBlock>& vBlocks);
 /** Initialize a new block tree database + block data on disk */
 bool InitBlockIndex(const CChainParams& chainparams);
 /** Load the block tree and coins database from disk */
@@ -475,11 +511,15 @@ bool GetTimestampIndex(const unsigned int& high, const unsigned int& low, std::v
 bool GetSpentIndex(CSpentIndexKey& key, CSpentIndexValue& value);
 bool GetAddressIndex(uint160 addressHash, int type, std::vector<std::pair<CAddressIndexKey, CAmount> >& addressIndex, int start = 0, int end = 0);
 bool GetAddressUnspent(uint160 addressHash, int type, std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue> >& unspentOutputs);
+/** Balance, received total, tx count and last height per address, in key order, looked up in one sorted pass */
+bool GetAddressBalances(const std::vector<std::pair<uint160, int> >& addresses, std::vector<std::pair<CAddressIndexIteratorKey, CAddressBalanceValue> >& balances);
 
 /** Functions for disk access for blocks */
 bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart);
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams);
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
+/** Read the serialized block at pos exactly as stored, without deserializing or checking its proof of work */
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& vchBlock, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart);
 
 /** Functions for validating blocks and updating the block tree */
 
@@ -30,6 +30,9 @@ void RegisterValidationInterface(CValidationInterface* pwalletIn)
     g_signals.NotifyGovernanceObject.connect(boost::bind(&CValidationInterface::NotifyGovernanceObject, pwalletIn, _1));
     g_signals.NotifyGovernanceVote.connect(boost::bind(&CValidationInterface::NotifyGovernanceVote, pwalletIn, _1));
     g_signals.NotifyBDAPUpdate.connect(boost::bind(&CValidationInterface::NotifyBDAPUpdate, pwalletIn, _1, _2));
+    g_signals.NotifyBDAPEntry.connect(boost::bind(&CValidationInterface::NotifyBDAPEntry, pwalletIn, _1, _2));
+    g_signals.NotifyBDAPLink.connect(boost::bind(&CValidationInterface::NotifyBDAPLink, pwalletIn, _1, _2, _3, _4));
+    g_signals.NotifyMinerStats.connect(boost::bind(&CValidationInterface::NotifyMinerStats, pwalletIn, _1));
     g_signals.NotifyInstantSendDoubleSpendAttempt.connect(boost::bind(&CValidationInterface::NotifyInstantSendDoubleSpendAttempt, pwalletIn, _1, _2));
 }
 
@@ -51,6 +54,9 @@ void UnregisterValidationInterface(CValidationInterface* pwalletIn)
     g_signals.NotifyGovernanceObject.disconnect(boost::bind(&CValidationInterface::NotifyGovernanceObject, pwalletIn, _1));
     g_signals.NotifyGovernanceVote.disconnect(boost::bind(&CValidationInterface::NotifyGovernanceVote, pwalletIn, _1));
     g_signals.NotifyBDAPUpdate.disconnect(boost::bind(&CValidationInterface::NotifyBDAPUpdate, pwalletIn, _1, _2));
+    g_signals.NotifyBDAPEntry.disconnect(boost::bind(&CValidationInterface::NotifyBDAPEntry, pwalletIn, _1, _2));
+    g_signals.NotifyBDAPLink.disconnect(boost::bind(&CValidationInterface::NotifyBDAPLink, pwalletIn, _1, _2, _3, _4));
+    g_signals.NotifyMinerStats.disconnect(boost::bind(&CValidationInterface::NotifyMinerStats, pwalletIn, _1));
     g_signals.NotifyInstantSendDoubleSpendAttempt.disconnect(boost::bind(&CValidationInterface::NotifyInstantSendDoubleSpendAttempt, pwalletIn, _1, _2));
 }
 
@@ -72,5 +78,8 @@ void UnregisterAllValidationInterfaces()
     g_signals.NotifyGovernanceObject.disconnect_all_slots();
     g_signals.NotifyGovernanceVote.disconnect_all_slots();
     g_signals.NotifyBDAPUpdate.disconnect_all_slots();
+    g_signals.NotifyBDAPEntry.disconnect_all_slots();
+    g_signals.NotifyBDAPLink.disconnect_all_slots();
+    g_signals.NotifyMinerStats.disconnect_all_slots();
     g_signals.NotifyInstantSendDoubleSpendAttempt.disconnect_all_slots();
 }
\ No newline at end of file
@@ -10,14 +10,18 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/signals2/signal.hpp>
 #include <memory>
+#include <string>
+#include <vector>
 
 class CBlock;
 class CBlockIndex;
 struct CBlockLocator;
 class CConnman;
+class CDomainEntry;
 class CGovernanceVote;
 class CGovernanceObject;
 class CReserveScript;
+class CScript;
 class CTransaction;
 class CValidationInterface;
 class CValidationState;
@@ -53,6 +57,9 @@ protected:
     virtual void ResetRequestCount(const uint256& hash){};
     virtual void NewPoWValidBlock(const CBlockIndex* pindex, const std::shared_ptr<const CBlock>& block) {}
     virtual void NotifyBDAPUpdate(const char* value, const char* action) {}
+    virtual void NotifyBDAPEntry(const CDomainEntry& entry, const std::string& strOperation) {}
+    virtual void NotifyBDAPLink(const uint256& txid, const std::string& strOperation, const std::vector<std::vector<unsigned char> >& vvchOpParameters, const CScript& scriptData) {}
+    virtual void NotifyMinerStats(const std::string& stats) {}
     friend void ::RegisterValidationInterface(CValidationInterface*);
     friend void ::UnregisterValidationInterface(CValidationInterface*);
     friend void ::UnregisterAllValidationInterfaces();
@@ -102,8 +109,14 @@ struct CMainSignals {
      * Notifies listeners that a block which builds directly on our current tip
      * has been received and connected to the headers tree, though not validated yet */
     boost::signals2::signal<void(const CBlockIndex*, const std::shared_ptr<const CBlock>&)> NewPoWValidBlock;
-    /** Notifies listeners of an updated BDAP action */
+    /** Notifies listeners of BDAP JSON (bdap_history and bdap_record), only built when a JSON topic is subscribed */
     boost::signals2::signal<void(const char* value, const char* action)> NotifyBDAPUpdate;
+    /** Notifies listeners of an added, updated or deleted BDAP entry */
+    boost::signals2::signal<void(const CDomainEntry& entry, const std::string& strOperation)> NotifyBDAPEntry;
+    /** Notifies listeners of a connected BDAP link request or accept transaction */
+    boost::signals2::signal<void(const uint256& txid, const std::string& strOperation, const std::vector<std::vector<unsigned char> >& vvchOpParameters, const CScript& scriptData)> NotifyBDAPLink;
+    /** Notifies listeners of updated miner statistics (JSON) */
+    boost::signals2::signal<void(const std::string& stats)> NotifyMinerStats;
 };
 
 CMainSignals& GetMainSignals();
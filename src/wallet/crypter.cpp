@@ -674,6 +674,10 @@ bool CCryptoKeyStore::GetHDChain(CHDChain& hdChainRet) const
 
 bool CCryptoKeyStore::GetDHTPubKeys(std::vector<std::vector<unsigned char>>& vvchDHTPubKeys) const
 {
+    LOCK(cs_KeyStore);
+    // Encrypting the wallet moves the DHT keys to mapCryptedDHTKeys
+    for (const CryptedDHTKeyMap::value_type& key : mapCryptedDHTKeys)
+        vvchDHTPubKeys.push_back(key.second.first);
     for (const std::pair<CKeyID, CKeyEd25519>& key : mapDHTKeys) {
         vvchDHTPubKeys.push_back(key.second.GetPubKey());
         LogPrint("dht", "CCryptoKeyStore::GetDHTPubKeys -- pubkey = %s\n", key.second.GetPubKeyString());
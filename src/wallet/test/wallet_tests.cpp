@@ -4,6 +4,8 @@
 
 #include "wallet/wallet.h"
 
+#include "dht/ed25519.h"
+
 #include <set>
 #include <stdint.h>
 #include <utility>
@@ -352,4 +354,34 @@ BOOST_AUTO_TEST_CASE(ApproximateBestSubset)
     empty_wallet();
 }
 
+BOOST_AUTO_TEST_CASE(link_shared_seed)
+{
+    CWallet linkWallet;
+    LOCK(linkWallet.cs_wallet);
+
+    CKeyEd25519 myKey, senderKey, otherKey;
+    BOOST_CHECK(linkWallet.AddDHTKey(myKey, myKey.GetPubKey()));
+    BOOST_CHECK(linkWallet.IsLinkFromMe(myKey.GetPubKey()));
+    BOOST_CHECK(!linkWallet.IsLinkFromMe(senderKey.GetPubKey()));
+
+    // The sender derives the same shared key as the wallet
+    std::vector<unsigned char> vchSharedPubKey = GetLinkSharedPubKey(senderKey, myKey.GetPubKey());
+    std::array<char, 32> sharedSeed;
+    BOOST_CHECK(linkWallet.GetLinkSharedSeed(senderKey.GetPubKey(), vchSharedPubKey, sharedSeed));
+    BOOST_CHECK(sharedSeed == GetLinkSharedPrivateKey(senderKey, myKey.GetPubKey()));
+    BOOST_CHECK(!linkWallet.IsLinkForMe(otherKey.GetPubKey(), vchSharedPubKey));
+
+    // Links between other accounts, each from a fresh sender key like the link RPCs use
+    for (int i = 0; i < 3; i++) {
+        CKeyEd25519 freshSenderKey;
+        BOOST_CHECK(!linkWallet.IsLinkForMe(freshSenderKey.GetPubKey(), GetLinkSharedPubKey(freshSenderKey, otherKey.GetPubKey())));
+    }
+
+    // A DHT key added later matches senders checked before
+    std::vector<unsigned char> vchOtherSharedPubKey = GetLinkSharedPubKey(senderKey, otherKey.GetPubKey());
+    BOOST_CHECK(!linkWallet.IsLinkForMe(senderKey.GetPubKey(), vchOtherSharedPubKey));
+    BOOST_CHECK(linkWallet.AddDHTKey(otherKey, otherKey.GetPubKey()));
+    BOOST_CHECK(linkWallet.IsLinkForMe(senderKey.GetPubKey(), vchOtherSharedPubKey));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
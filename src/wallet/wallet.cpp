@@ -10,9 +10,9 @@
 #include "base58.h"
 #include "bdap/bdap.h"
 #include "bdap/domainentrydb.h"
+#include "bdap/linkencryption.h"
 #include "bdap/linkingdb.h"
 #include "bdap/utils.h"
-#include "bdap/vgp/include/encryption.h" // for VGP E2E encryption
 #include "chain.h"
 #include "checkpoints.h"
 #include "consensus/consensus.h"
@@ -350,6 +350,7 @@ bool CWallet::AddDHTKey(const CKeyEd25519& key, const std::vector<unsigned char>
     if (!CCryptoKeyStore::AddDHTKey(key, pubkey)) {
         return false;
     }
+    fLinkKeyCacheDirty = true;
 
     if (!fFileBacked)
         return true;
@@ -369,6 +370,7 @@ bool CWallet::AddCryptedDHTKey(const std::vector<unsigned char>& vchPubKey, cons
         LogPrint("dht", "CWallet::AddCryptedDHTKey AddCryptedDHTKey failed.\n");
         return false;
     }
+    fLinkKeyCacheDirty = true;
     if (!fFileBacked)
         return true;
     {
@@ -419,6 +421,7 @@ bool CWallet::LoadCryptedKey(const CPubKey& vchPubKey, const std::vector<unsigne
 
 bool CWallet::LoadCryptedDHTKey(const std::vector<unsigned char>& vchPubKey, const std::vector<unsigned char>& vchCryptedSecret)
 {
+    fLinkKeyCacheDirty = true;
     return CCryptoKeyStore::AddCryptedDHTKey(vchPubKey, vchCryptedSecret);
 }
 
@@ -1235,35 +1238,49 @@ bool CWallet::LoadToWallet(const CWalletTx& wtxIn)
     return true;
 }
 
-bool CWallet::IsLinkFromMe(const std::vector<unsigned char>& vchLinkPubKey)
+void CWallet::UpdateLinkKeyCache()
 {
-    CKeyID keyID(Hash160(vchLinkPubKey.begin(), vchLinkPubKey.end()));
-    CKeyEd25519 keyOut;
-    if (GetDHTKey(keyID, keyOut))
-        return true;
+    AssertLockHeld(cs_wallet);
+    if (!fLinkKeyCacheDirty)
+        return;
 
-    return false;
+    std::vector<std::vector<unsigned char>> vvchDHTPubKeys;
+    GetDHTPubKeys(vvchDHTPubKeys);
+    setLinkDHTPubKeys.clear();
+    setLinkDHTPubKeys.insert(vvchDHTPubKeys.begin(), vvchDHTPubKeys.end());
+    fLinkKeyCacheDirty = false;
 }
 
-bool CWallet::IsLinkForMe(const std::vector<unsigned char>& vchLinkPubKey, const std::vector<unsigned char>& vchSharedPubKey)
+bool CWallet::IsLinkFromMe(const std::vector<unsigned char>& vchLinkPubKey)
 {
-    std::vector<std::vector<unsigned char>> vvchMyDHTPubKeys;
-    if (!GetDHTPubKeys(vvchMyDHTPubKeys) )
-        return false;
+    LOCK(cs_wallet);
+    UpdateLinkKeyCache();
+    return setLinkDHTPubKeys.count(vchLinkPubKey) > 0;
+}
 
-    if (vvchMyDHTPubKeys.size() == 0)
-        return false;
+bool CWallet::IsLinkForMe(const std::vector<unsigned char>& vchLinkPubKey, const std::vector<unsigned char>& vchSharedPubKey)
+{
+    std::array<char, 32> sharedSeed;
+    return GetLinkSharedSeed(vchLinkPubKey, vchSharedPubKey, sharedSeed);
+}
 
-    for (const std::vector<unsigned char>& vchMyDHTPubKey : vvchMyDHTPubKeys) {
-        CKeyID keyID(Hash160(vchMyDHTPubKey.begin(), vchMyDHTPubKey.end()));
+bool CWallet::GetLinkSharedSeed(const std::vector<unsigned char>& vchSenderPubKey, const std::vector<unsigned char>& vchSharedPubKey, std::array<char, 32>& sharedSeed)
+{
+    LOCK(cs_wallet);
+    UpdateLinkKeyCache();
+    for (const std::vector<unsigned char>& vchDHTPubKey : setLinkDHTPubKeys) {
+        CKeyID keyID(Hash160(vchDHTPubKey.begin(), vchDHTPubKey.end()));
         CKeyEd25519 dhtKey;
-        if (GetDHTKey(keyID, dhtKey)) {
-            std::vector<unsigned char> vchGetSharedPubKey = GetLinkSharedPubKey(dhtKey, vchLinkPubKey);
-            if (vchGetSharedPubKey == vchSharedPubKey)
-                return true;
+        if (!GetDHTKey(keyID, dhtKey))
+            continue;
+
+        std::array<char, 32> seed = GetLinkSharedPrivateKey(dhtKey, vchSenderPubKey);
+        CKeyEd25519 sharedKey(seed);
+        if (sharedKey.GetPubKey() == vchSharedPubKey) {
+            sharedSeed = seed;
+            return true;
         }
     }
-
     return false;
 }
 
@@ -1367,24 +1384,15 @@ bool CWallet::AddToWalletIfInvolvingMe(const CTransaction& tx, const CBlockIndex
                                         CKeyEd25519 privDHTKey;
                                         CKeyID keyID(Hash160(vchLinkPubKey.begin(), vchLinkPubKey.end()));
                                         if (GetDHTKey(keyID, privDHTKey)) {
-                                            int nDataVersion;
                                             LogPrint("bdap", "%s --  Encrypted data size = %i\n", __func__, vchData.size());
-                                            vchData = RemoveVersionFromLinkData(vchData, nDataVersion);
-                                            if (nDataVersion == nVersion) {
-                                                std::string strMessage = "";
-                                                std::vector<unsigned char> dataDecrypted;
-                                                if (DecryptBDAPData(privDHTKey.GetPrivSeedBytes(), vchData, dataDecrypted, strMessage)) {
-                                                    std::vector<unsigned char> vchData, vchHash;
-                                                    CScript scriptData;
-                                                    scriptData << OP_RETURN << dataDecrypted;
-                                                    if (GetBDAPData(scriptData, vchData, vchHash)) {
-                                                        CLinkRequest link;
-                                                        link.UnserializeFromData(dataDecrypted, vchHash);
-                                                        pLinkRequestDB->AddMyLinkRequest(link);
-                                                        LogPrint("bdap", "%s -- DecryptBDAPData RequestorFQDN = %s, RecipientFQDN = %s, dataDecrypted size = %i\n", __func__, link.RequestorFQDN(), link.RecipientFQDN(), dataDecrypted.size());
-                                                        fDecrypted = true;
-                                                    }
-                                                }
+                                            std::string strMessage = "";
+                                            std::vector<unsigned char> dataDecrypted;
+                                            if (DecryptLinkData(privDHTKey.GetPrivSeedBytes(), vchData, dataDecrypted, vchHash, strMessage)) {
+                                                CLinkRequest link;
+                                                link.UnserializeFromData(dataDecrypted, vchHash);
+                                                pLinkRequestDB->AddMyLinkRequest(link);
+                                                LogPrint("bdap", "%s -- DecryptBDAPData RequestorFQDN = %s, RecipientFQDN = %s, dataDecrypted size = %i\n", __func__, link.RequestorFQDN(), link.RecipientFQDN(), dataDecrypted.size());
+                                                fDecrypted = true;
                                             }
                                         }
                                         if (!fDecrypted)
@@ -1396,7 +1404,8 @@ bool CWallet::AddToWalletIfInvolvingMe(const CTransaction& tx, const CBlockIndex
                         // Check to see if this link request is for one of my BDAP accounts.
                         {
                             std::vector<unsigned char> vchSharedPubKey = vvchOpParameters[1];
-                            bool fIsLinkRequestForMe = IsLinkForMe(vchLinkPubKey, vchSharedPubKey);
+                            std::array<char, 32> sharedSeed;
+                            bool fIsLinkRequestForMe = GetLinkSharedSeed(vchLinkPubKey, vchSharedPubKey, sharedSeed);
                             if (fIsLinkRequestForMe) {
                                 int nOut;
                                 std::vector<unsigned char> vchData, vchHash;
@@ -1419,30 +1428,16 @@ bool CWallet::AddToWalletIfInvolvingMe(const CTransaction& tx, const CBlockIndex
                                     else if (nVersion == 1) {
                                         bool fDecrypted = false;
                                         LogPrint("bdap", "%s -- Version 1 link request for me found! vchLinkPubKey = %s\n", __func__, stringFromVch(vchLinkPubKey));
-                                        CKeyEd25519 sharedDHTKey;
-                                        std::array<char, 32> sharedSeed;
-                                        std::string strErrorMessage;
-                                        if (GetLinkPrivateKey(vchLinkPubKey, vchSharedPubKey, sharedSeed, strErrorMessage)) {
-                                            CKeyEd25519 sharedKey(sharedSeed);
-                                            int nDataVersion;
-                                            LogPrint("bdap", "%s --  Encrypted data size = %i\n", __func__, vchData.size());
-                                            vchData = RemoveVersionFromLinkData(vchData, nDataVersion);
-                                            if (nDataVersion == nVersion) {
-                                                std::string strMessage = "";
-                                                std::vector<unsigned char> dataDecrypted;
-                                                if (DecryptBDAPData(sharedKey.GetPrivSeedBytes(), vchData, dataDecrypted, strMessage)) {
-                                                    std::vector<unsigned char> vchData, vchHash;
-                                                    CScript scriptData;
-                                                    scriptData << OP_RETURN << dataDecrypted;
-                                                    if (GetBDAPData(scriptData, vchData, vchHash)) {
-                                                        CLinkRequest link;
-                                                        link.UnserializeFromData(dataDecrypted, vchHash);
-                                                        pLinkRequestDB->AddMyLinkRequest(link);
-                                                        LogPrint("bdap", "%s -- DecryptBDAPData RequestorFQDN = %s, RecipientFQDN = %s, dataDecrypted size = %i\n", __func__, link.RequestorFQDN(), link.RecipientFQDN(), dataDecrypted.size());
-                                                        fDecrypted = true;
-                                                    }
-                                                }
-                                            }
+                                        CKeyEd25519 sharedKey(sharedSeed);
+                                        LogPrint("bdap", "%s --  Encrypted data size = %i\n", __func__, vchData.size());
+                                        std::string strMessage = "";
+                                        std::vector<unsigned char> dataDecrypted;
+                                        if (DecryptLinkData(sharedKey.GetPrivSeedBytes(), vchData, dataDecrypted, vchHash, strMessage)) {
+                                            CLinkRequest link;
+                                            link.UnserializeFromData(dataDecrypted, vchHash);
+                                            pLinkRequestDB->AddMyLinkRequest(link);
+                                            LogPrint("bdap", "%s -- DecryptBDAPData RequestorFQDN = %s, RecipientFQDN = %s, dataDecrypted size = %i\n", __func__, link.RequestorFQDN(), link.RecipientFQDN(), dataDecrypted.size());
+                                            fDecrypted = true;
                                         }
                                         if (!fDecrypted)
                                             LogPrint("bdap", "%s -- Link request DecryptBDAPData failed.\n", __func__);
@@ -1481,24 +1476,15 @@ bool CWallet::AddToWalletIfInvolvingMe(const CTransaction& tx, const CBlockIndex
                                         CKeyEd25519 privDHTKey;
                                         CKeyID keyID(Hash160(vchLinkPubKey.begin(), vchLinkPubKey.end()));
                                         if (GetDHTKey(keyID, privDHTKey)) {
-                                            int nDataVersion;
                                             LogPrint("bdap", "%s --  Encrypted data size = %i\n", __func__, vchData.size());
-                                            vchData = RemoveVersionFromLinkData(vchData, nDataVersion);
-                                            if (nDataVersion == nVersion) {
-                                                std::string strMessage = "";
-                                                std::vector<unsigned char> dataDecrypted;
-                                                if (DecryptBDAPData(privDHTKey.GetPrivSeedBytes(), vchData, dataDecrypted, strMessage)) {
-                                                    std::vector<unsigned char> vchData, vchHash;
-                                                    CScript scriptData;
-                                                    scriptData << OP_RETURN << dataDecrypted;
-                                                    if (GetBDAPData(scriptData, vchData, vchHash)) {
-                                                        CLinkAccept link;
-                                                        link.UnserializeFromData(dataDecrypted, vchHash);
-                                                        pLinkAcceptDB->AddMyLinkAccept(link);
-                                                        LogPrint("bdap", "%s -- DecryptBDAPData RequestorFQDN = %s, RecipientFQDN = %s, dataDecrypted size = %i\n", __func__, link.RequestorFQDN(), link.RecipientFQDN(), dataDecrypted.size());
-                                                        fDecrypted = true;
-                                                    }
-                                                }
+                                            std::string strMessage = "";
+                                            std::vector<unsigned char> dataDecrypted;
+                                            if (DecryptLinkData(privDHTKey.GetPrivSeedBytes(), vchData, dataDecrypted, vchHash, strMessage)) {
+                                                CLinkAccept link;
+                                                link.UnserializeFromData(dataDecrypted, vchHash);
+                                                pLinkAcceptDB->AddMyLinkAccept(link);
+                                                LogPrint("bdap", "%s -- DecryptBDAPData RequestorFQDN = %s, RecipientFQDN = %s, dataDecrypted size = %i\n", __func__, link.RequestorFQDN(), link.RecipientFQDN(), dataDecrypted.size());
+                                                fDecrypted = true;
                                             }
                                         }
                                         if (!fDecrypted)
@@ -1510,7 +1496,8 @@ bool CWallet::AddToWalletIfInvolvingMe(const CTransaction& tx, const CBlockIndex
                         // Check to see if this link accept is for one of my BDAP accounts.
                         {
                             std::vector<unsigned char> vchSharedPubKey = vvchOpParameters[1];
-                            bool fIsLinkAcceptForMe = IsLinkForMe(vchLinkPubKey, vchSharedPubKey);
+                            std::array<char, 32> sharedSeed;
+                            bool fIsLinkAcceptForMe = GetLinkSharedSeed(vchLinkPubKey, vchSharedPubKey, sharedSeed);
                             if (fIsLinkAcceptForMe) {
                                 int nOut;
                                 std::vector<unsigned char> vchData, vchHash;
@@ -1533,30 +1520,16 @@ bool CWallet::AddToWalletIfInvolvingMe(const CTransaction& tx, const CBlockIndex
                                     else if (nVersion == 1) {
                                         bool fDecrypted = false;
                                         LogPrint("bdap", "%s -- Version 1 link request for me found! vchLinkPubKey = %s\n", __func__, stringFromVch(vchLinkPubKey));
-                                        CKeyEd25519 sharedDHTKey;
-                                        std::array<char, 32> sharedSeed;
-                                        std::string strErrorMessage;
-                                        if (GetLinkPrivateKey(vchLinkPubKey, vchSharedPubKey, sharedSeed, strErrorMessage)) {
-                                            CKeyEd25519 sharedKey(sharedSeed);
-                                            int nDataVersion;
-                                            LogPrint("bdap", "%s --  Encrypted data size = %i\n", __func__, vchData.size());
-                                            vchData = RemoveVersionFromLinkData(vchData, nDataVersion);
-                                            if (nDataVersion == nVersion) {
-                                                std::string strMessage = "";
-                                                std::vector<unsigned char> dataDecrypted;
-                                                if (DecryptBDAPData(sharedKey.GetPrivSeedBytes(), vchData, dataDecrypted, strMessage)) {
-                                                     std::vector<unsigned char> vchData, vchHash;
-                                                    CScript scriptData;
-                                                    scriptData << OP_RETURN << dataDecrypted;
-                                                    if (GetBDAPData(scriptData, vchData, vchHash)) {
-                                                        CLinkAccept link;
-                                                        link.UnserializeFromData(dataDecrypted, vchHash);
-                                                        pLinkAcceptDB->AddMyLinkAccept(link);
-                                                        LogPrint("bdap", "%s -- DecryptBDAPData RequestorFQDN = %s, RecipientFQDN = %s, dataDecrypted size = %i\n", __func__, link.RequestorFQDN(), link.RecipientFQDN(), dataDecrypted.size());
-                                                        fDecrypted = true;
-                                                    }
-                                                }
-                                            }
+                                        CKeyEd25519 sharedKey(sharedSeed);
+                                        LogPrint("bdap", "%s --  Encrypted data size = %i\n", __func__, vchData.size());
+                                        std::string strMessage = "";
+                                        std::vector<unsigned char> dataDecrypted;
+                                        if (DecryptLinkData(sharedKey.GetPrivSeedBytes(), vchData, dataDecrypted, vchHash, strMessage)) {
+                                            CLinkAccept link;
+                                            link.UnserializeFromData(dataDecrypted, vchHash);
+                                            pLinkAcceptDB->AddMyLinkAccept(link);
+                                            LogPrint("bdap", "%s -- DecryptBDAPData RequestorFQDN = %s, RecipientFQDN = %s, dataDecrypted size = %i\n", __func__, link.RequestorFQDN(), link.RecipientFQDN(), dataDecrypted.size());
+                                            fDecrypted = true;
                                         }
                                         if (!fDecrypted)
                                             LogPrint("bdap", "%s -- Link request DecryptBDAPData failed.\n", __func__);
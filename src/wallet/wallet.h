@@ -25,6 +25,7 @@
 #include "privatesend.h"
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <map>
 #include <set>
@@ -685,6 +686,13 @@ private:
 
     int64_t nTimeFirstKey;
 
+    //! Set when DHT keys were added after setLinkDHTPubKeys was built
+    bool fLinkKeyCacheDirty;
+    //! Public keys of the wallet's DHT keys, so BDAP link checks don't decrypt keys to list them
+    std::set<std::vector<unsigned char>> setLinkDHTPubKeys;
+
+    void UpdateLinkKeyCache();
+
     /**
      * Private version of AddWatchOnly method which does not accept a
      * timestamp, and which will reset the wallet's nTimeFirstKey value to 1 if
@@ -761,6 +769,7 @@ public:
         nNextResend = 0;
         nLastResend = 0;
         nTimeFirstKey = 0;
+        fLinkKeyCacheDirty = true;
         fBroadcastTransactions = false;
         fAnonymizableTallyCached = false;
         fAnonymizableTallyCachedNonDenom = false;
@@ -869,7 +878,7 @@ public:
     //! Adds a key to the store, without saving it to disk (used by LoadWallet)
     bool LoadKey(const CKey& key, const CPubKey& pubkey) { return CCryptoKeyStore::AddKeyPubKey(key, pubkey); }
     //! Adds a key to the store, without saving it to disk (used by LoadWallet)
-    bool LoadDHTKey(const CKeyEd25519& key, const std::vector<unsigned char>& pubkey) { return CCryptoKeyStore::AddDHTKey(key, pubkey); }
+    bool LoadDHTKey(const CKeyEd25519& key, const std::vector<unsigned char>& pubkey) { fLinkKeyCacheDirty = true; return CCryptoKeyStore::AddDHTKey(key, pubkey); }
     //! Load metadata (used by LoadWallet)
     bool LoadKeyMetadata(const CTxDestination& pubKey, const CKeyMetadata& metadata);
 
@@ -1149,6 +1158,8 @@ public:
     bool IsLinkFromMe(const std::vector<unsigned char>& vchLinkPubKey);
     bool IsLinkForMe(const std::vector<unsigned char>& vchLinkPubKey, const std::vector<unsigned char>& vchSharedPubKey);
     bool GetLinkPrivateKey(const std::vector<unsigned char>& vchSenderPubKey, const std::vector<unsigned char>& vchSharedPubKey, std::array<char, 32>& sharedSeed, std::string& strErrorMessage);
+    //! Finds the shared link seed for a link from vchSenderPubKey, one key exchange per DHT key until one matches
+    bool GetLinkSharedSeed(const std::vector<unsigned char>& vchSenderPubKey, const std::vector<unsigned char>& vchSharedPubKey, std::array<char, 32>& sharedSeed);
 
 };
 
@@ -40,3 +40,23 @@ bool CZMQAbstractNotifier::NotifyInstantSendDoubleSpendAttempt(const CTransactio
 {
     return true;
 }
+
+bool CZMQAbstractNotifier::NotifyMinerStats(const std::string &/*stats*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyBDAPEntry(const CDomainEntry &/*entry*/, const std::string &/*operation*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyBDAPLink(const uint256 &/*txid*/, const std::string &/*operation*/, const std::vector<std::vector<unsigned char> > &/*opParameters*/, const CScript &/*scriptData*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyBDAPUpdate(const std::string &/*value*/, const std::string &/*action*/)
+{
+    return true;
+}
@@ -8,8 +8,10 @@
 #include "zmqconfig.h"
 
 class CBlockIndex;
+class CDomainEntry;
 class CGovernanceObject;
 class CGovernanceVote;
+class CScript;
 class CZMQAbstractNotifier;
 
 typedef CZMQAbstractNotifier* (*CZMQNotifierFactory)();
@@ -40,6 +42,10 @@ public:
     virtual bool NotifyGovernanceVote(const CGovernanceVote &vote);
     virtual bool NotifyGovernanceObject(const CGovernanceObject &object);
     virtual bool NotifyInstantSendDoubleSpendAttempt(const CTransaction &currentTx, const CTransaction &previousTx);
+    virtual bool NotifyMinerStats(const std::string &stats);
+    virtual bool NotifyBDAPEntry(const CDomainEntry &entry, const std::string &operation);
+    virtual bool NotifyBDAPLink(const uint256 &txid, const std::string &operation, const std::vector<std::vector<unsigned char> > &opParameters, const CScript &scriptData);
+    virtual bool NotifyBDAPUpdate(const std::string &value, const std::string &action);
 
 
 protected:
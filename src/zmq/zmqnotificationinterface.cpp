@@ -41,12 +41,19 @@ CZMQNotificationInterface* CZMQNotificationInterface::Create()
     factories["pubhashgovernancevote"] = CZMQAbstractNotifier::Create<CZMQPublishHashGovernanceVoteNotifier>;
     factories["pubhashgovernanceobject"] = CZMQAbstractNotifier::Create<CZMQPublishHashGovernanceObjectNotifier>;
     factories["pubhashinstantsenddoublespend"] = CZMQAbstractNotifier::Create<CZMQPublishHashInstantSendDoubleSpendNotifier>;
+    factories["pubminerstats"] = CZMQAbstractNotifier::Create<CZMQPublishMinerStatsNotifier>;
+    factories["pubhashbdapentry"] = CZMQAbstractNotifier::Create<CZMQPublishHashBDAPEntryNotifier>;
+    factories["pubhashbdaplink"] = CZMQAbstractNotifier::Create<CZMQPublishHashBDAPLinkNotifier>;
+    factories["pubbdaphistory"] = CZMQAbstractNotifier::Create<CZMQPublishBDAPHistoryNotifier>;
+    factories["pubbdaprecord"] = CZMQAbstractNotifier::Create<CZMQPublishBDAPRecordNotifier>;
     factories["pubrawblock"] = CZMQAbstractNotifier::Create<CZMQPublishRawBlockNotifier>;
     factories["pubrawtx"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionNotifier>;
     factories["pubrawtxlock"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionLockNotifier>;
     factories["pubrawgovernancevote"] = CZMQAbstractNotifier::Create<CZMQPublishRawGovernanceVoteNotifier>;
     factories["pubrawgovernanceobject"] = CZMQAbstractNotifier::Create<CZMQPublishRawGovernanceObjectNotifier>;
     factories["pubrawinstantsenddoublespend"] = CZMQAbstractNotifier::Create<CZMQPublishRawInstantSendDoubleSpendNotifier>;
+    factories["pubrawbdapentry"] = CZMQAbstractNotifier::Create<CZMQPublishRawBDAPEntryNotifier>;
+    factories["pubrawbdaplink"] = CZMQAbstractNotifier::Create<CZMQPublishRawBDAPLinkNotifier>;
 
     for (std::map<std::string, CZMQNotifierFactory>::const_iterator i=factories.begin(); i!=factories.end(); ++i)
     {
@@ -232,3 +239,71 @@ void CZMQNotificationInterface::NotifyGovernanceObject(const CGovernanceObject &
         }
     }
 }
+
+void CZMQNotificationInterface::NotifyMinerStats(const std::string &stats)
+{
+    for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i != notifiers.end(); )
+    {
+        CZMQAbstractNotifier *notifier = *i;
+        if (notifier->NotifyMinerStats(stats))
+        {
+            i++;
+        }
+        else
+        {
+            notifier->Shutdown();
+            i = notifiers.erase(i);
+        }
+    }
+}
+
+void CZMQNotificationInterface::NotifyBDAPUpdate(const char *value, const char *action)
+{
+    for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i != notifiers.end(); )
+    {
+        CZMQAbstractNotifier *notifier = *i;
+        if (notifier->NotifyBDAPUpdate(value, action))
+        {
+            i++;
+        }
+        else
+        {
+            notifier->Shutdown();
+            i = notifiers.erase(i);
+        }
+    }
+}
+
+void CZMQNotificationInterface::NotifyBDAPEntry(const CDomainEntry &entry, const std::string &operation)
+{
+    for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i != notifiers.end(); )
+    {
+        CZMQAbstractNotifier *notifier = *i;
+        if (notifier->NotifyBDAPEntry(entry, operation))
+        {
+            i++;
+        }
+        else
+        {
+            notifier->Shutdown();
+            i = notifiers.erase(i);
+        }
+    }
+}
+
+void CZMQNotificationInterface::NotifyBDAPLink(const uint256 &txid, const std::string &operation, const std::vector<std::vector<unsigned char> > &opParameters, const CScript &scriptData)
+{
+    for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i != notifiers.end(); )
+    {
+        CZMQAbstractNotifier *notifier = *i;
+        if (notifier->NotifyBDAPLink(txid, operation, opParameters, scriptData))
+        {
+            i++;
+        }
+        else
+        {
+            notifier->Shutdown();
+            i = notifiers.erase(i);
+        }
+    }
+}
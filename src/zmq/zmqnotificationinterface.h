@@ -30,6 +30,10 @@ protected:
     void NotifyGovernanceVote(const CGovernanceVote& vote) override;
     void NotifyGovernanceObject(const CGovernanceObject& object) override;
     void NotifyInstantSendDoubleSpendAttempt(const CTransaction &currentTx, const CTransaction &previousTx) override;
+    void NotifyMinerStats(const std::string &stats) override;
+    void NotifyBDAPUpdate(const char *value, const char *action) override;
+    void NotifyBDAPEntry(const CDomainEntry &entry, const std::string &operation) override;
+    void NotifyBDAPLink(const uint256 &txid, const std::string &operation, const std::vector<std::vector<unsigned char> > &opParameters, const CScript &scriptData) override;
 
 
 private:
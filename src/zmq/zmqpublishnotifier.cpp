@@ -8,6 +8,9 @@
 #include "validation.h"
 #include "util.h"
 
+#include "bdap/domainentry.h"
+#include "script/script.h"
+
 static std::multimap<std::string, CZMQAbstractPublishNotifier*> mapPublishNotifiers;
 
 static const char *MSG_HASHBLOCK  = "hashblock";
@@ -16,12 +19,19 @@ static const char *MSG_HASHTXLOCK = "hashtxlock";
 static const char *MSG_HASHGVOTE  = "hashgovernancevote";
 static const char *MSG_HASHGOBJ   = "hashgovernanceobject";
 static const char *MSG_HASHISCON  = "hashinstantsenddoublespend";
+static const char *MSG_HASHBDAPENTRY = "hashbdapentry";
+static const char *MSG_HASHBDAPLINK  = "hashbdaplink";
 static const char *MSG_RAWBLOCK   = "rawblock";
 static const char *MSG_RAWTX      = "rawtx";
 static const char *MSG_RAWTXLOCK  = "rawtxlock";
 static const char *MSG_RAWGVOTE   = "rawgovernancevote";
 static const char *MSG_RAWGOBJ    = "rawgovernanceobject";
 static const char *MSG_RAWISCON   = "rawinstantsenddoublespend";
+static const char *MSG_RAWBDAPENTRY = "rawbdapentry";
+static const char *MSG_RAWBDAPLINK  = "rawbdaplink";
+static const char *MSG_BDAPHISTORY  = "bdaphistory";
+static const char *MSG_BDAPRECORD   = "bdaprecord";
+static const char *MSG_MINERSTATS = "minerstats";
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -212,6 +222,49 @@ bool CZMQPublishHashInstantSendDoubleSpendNotifier::NotifyInstantSendDoubleSpend
         && SendMessage(MSG_HASHISCON, dataPreviousHash, 32);
 }
 
+bool CZMQPublishMinerStatsNotifier::NotifyMinerStats(const std::string &stats)
+{
+    LogPrint("zmq", "zmq: Publish minerstats\n");
+    return SendMessage(MSG_MINERSTATS, stats.data(), stats.size());
+}
+
+bool CZMQPublishHashBDAPEntryNotifier::NotifyBDAPEntry(const CDomainEntry &entry, const std::string &operation)
+{
+    uint256 hash = entry.txHash;
+    LogPrint("zmq", "zmq: Publish hashbdapentry %s %s\n", operation, hash.GetHex());
+    char data[32];
+    for (unsigned int i = 0; i < 32; i++)
+        data[31 - i] = hash.begin()[i];
+    return SendMessage(MSG_HASHBDAPENTRY, data, 32);
+}
+
+bool CZMQPublishHashBDAPLinkNotifier::NotifyBDAPLink(const uint256 &txid, const std::string &operation, const std::vector<std::vector<unsigned char> > &/*opParameters*/, const CScript &/*scriptData*/)
+{
+    LogPrint("zmq", "zmq: Publish hashbdaplink %s %s\n", operation, txid.GetHex());
+    char data[32];
+    for (unsigned int i = 0; i < 32; i++)
+        data[31 - i] = txid.begin()[i];
+    return SendMessage(MSG_HASHBDAPLINK, data, 32);
+}
+
+bool CZMQPublishBDAPHistoryNotifier::NotifyBDAPUpdate(const std::string &value, const std::string &action)
+{
+    if (action != "bdap_history")
+        return true;
+
+    LogPrint("zmq", "zmq: Publish bdaphistory\n");
+    return SendMessage(MSG_BDAPHISTORY, value.data(), value.size());
+}
+
+bool CZMQPublishBDAPRecordNotifier::NotifyBDAPUpdate(const std::string &value, const std::string &action)
+{
+    if (action != "bdap_record")
+        return true;
+
+    LogPrint("zmq", "zmq: Publish bdaprecord\n");
+    return SendMessage(MSG_BDAPRECORD, value.data(), value.size());
+}
+
 bool CZMQPublishRawBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
 {
     LogPrint("zmq", "zmq: Publish rawblock %s\n", pindex->GetBlockHash().GetHex());
@@ -279,3 +332,18 @@ bool CZMQPublishRawInstantSendDoubleSpendNotifier::NotifyInstantSendDoubleSpendA
         && SendMessage(MSG_RAWISCON, &(*ssPrevious.begin()), ssPrevious.size());
 }
 
+bool CZMQPublishRawBDAPEntryNotifier::NotifyBDAPEntry(const CDomainEntry &entry, const std::string &operation)
+{
+    LogPrint("zmq", "zmq: Publish rawbdapentry %s %s\n", operation, entry.txHash.GetHex());
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << operation << entry;
+    return SendMessage(MSG_RAWBDAPENTRY, &(*ss.begin()), ss.size());
+}
+
+bool CZMQPublishRawBDAPLinkNotifier::NotifyBDAPLink(const uint256 &txid, const std::string &operation, const std::vector<std::vector<unsigned char> > &opParameters, const CScript &scriptData)
+{
+    LogPrint("zmq", "zmq: Publish rawbdaplink %s %s\n", operation, txid.GetHex());
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << operation << txid << opParameters << *(const CScriptBase*)(&scriptData);
+    return SendMessage(MSG_RAWBDAPLINK, &(*ss.begin()), ss.size());
+}
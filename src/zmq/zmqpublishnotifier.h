@@ -66,6 +66,36 @@ public:
     bool NotifyInstantSendDoubleSpendAttempt(const CTransaction &currentTx, const CTransaction &previousTx) override;
 };
 
+class CZMQPublishMinerStatsNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyMinerStats(const std::string &stats) override;
+};
+
+class CZMQPublishHashBDAPEntryNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyBDAPEntry(const CDomainEntry &entry, const std::string &operation) override;
+};
+
+class CZMQPublishHashBDAPLinkNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyBDAPLink(const uint256 &txid, const std::string &operation, const std::vector<std::vector<unsigned char> > &opParameters, const CScript &scriptData) override;
+};
+
+class CZMQPublishBDAPHistoryNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyBDAPUpdate(const std::string &value, const std::string &action) override;
+};
+
+class CZMQPublishBDAPRecordNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyBDAPUpdate(const std::string &value, const std::string &action) override;
+};
+
 class CZMQPublishRawBlockNotifier : public CZMQAbstractPublishNotifier
 {
 public:
@@ -101,4 +131,16 @@ class CZMQPublishRawInstantSendDoubleSpendNotifier : public CZMQAbstractPublishN
 public:
     bool NotifyInstantSendDoubleSpendAttempt(const CTransaction &currentTx, const CTransaction &previousTx) override;
 };
+
+class CZMQPublishRawBDAPEntryNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyBDAPEntry(const CDomainEntry &entry, const std::string &operation) override;
+};
+
+class CZMQPublishRawBDAPLinkNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyBDAPLink(const uint256 &txid, const std::string &operation, const std::vector<std::vector<unsigned char> > &opParameters, const CScript &scriptData) override;
+};
 #endif // DYNAMIC_ZMQ_ZMQPUBLISHNOTIFIER_H